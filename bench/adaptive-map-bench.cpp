@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../include/adaptive-map.hpp"
+#include "../include/flat-map.hpp"
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Нагрузка со сменой фаз: загрузка (только вставки), долгое чтение, смешанная фаза
+ * (50% записей), снова чтение. Для каждой фазы и для всего прогона выводится
+ * время на операцию; адаптивная карта должна подстраиваться под каждую фазу,
+ * а фиксированные представления проигрывают в «чужих» фазах.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {1000, 100000};
+        std::vector<std::string> containers = {"mystl::adaptive_map", "mystl::map", "mystl::flat_map", "std::map"};
+        double phaseScale = 10.0;   // длина фаз чтения и смешанной в единицах n
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    struct Phase
+    {
+        const char* name;
+        double writeRatio;
+        std::uint64_t ops;
+    };
+
+    template <typename Map>
+    struct is_adaptive : std::false_type {};
+
+    template <typename K, typename T, std::size_t N, typename C, typename A>
+    struct is_adaptive<mystl::adaptive_map<K, T, N, C, A>> : std::true_type {};
+
+    // Возвращает время каждой фазы в нс
+    template <typename Map>
+    std::vector<double> runPhases(const std::vector<Phase>& phases, std::uint64_t& conversions)
+    {
+        Map m;
+        bench::Random rng(23);
+        std::uint64_t nextKey = 0;
+        std::uint64_t sum = 0;
+        std::vector<double> times;
+        for (const auto& phase : phases)
+        {
+            // Ключи готовятся заранее, чтобы генерация не попадала в замер
+            std::vector<std::pair<bool, Key>> steps(phase.ops);
+            for (auto& s : steps)
+            {
+                s.first = rng.unit() < phase.writeRatio;
+                s.second = bench::KeyGen<Key>::make(s.first ? nextKey++ : rng.below(std::max<std::uint64_t>(nextKey, 1)));
+            }
+
+            bench::Timer t;
+            for (const auto& s : steps)
+            {
+                if (s.first)
+                    m.insert({s.second, sum});
+                else
+                {
+                    auto it = m.find(s.second);
+                    if (it != m.end())
+                        sum += (*it).second;
+                }
+            }
+            times.push_back(t.elapsedNs());
+        }
+        bench::doNotOptimize(sum);
+        if constexpr (is_adaptive<Map>::value)
+            conversions = m.conversions();
+        return times;
+    }
+
+    template <typename Map>
+    void measure(const char* name, std::uint64_t n, const std::vector<Phase>& phases,
+                 const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::cerr << "  " << name << " n=" << n << '\n';
+
+        std::vector<std::vector<double>> samples(phases.size() + 1);
+        std::uint64_t conversions = 0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto times = runPhases<Map>(phases, conversions);
+            double total = 0.0;
+            for (std::size_t i = 0; i < phases.size(); ++i)
+            {
+                samples[i].push_back(times[i]);
+                total += times[i];
+            }
+            samples[phases.size()].push_back(total);
+        }
+
+        std::uint64_t totalOps = 0;
+        for (std::size_t i = 0; i <= phases.size(); ++i)
+        {
+            std::sort(samples[i].begin(), samples[i].end());
+            std::uint64_t ops = i < phases.size() ? phases[i].ops : totalOps;
+            totalOps += i < phases.size() ? phases[i].ops : 0;
+            std::string op = i < phases.size() ? std::to_string(i + 1) + "_" + phases[i].name : "total";
+            bench::Result r{name, "u64", "uniform", n, op, ops,
+                            samples[i][samples[i].size() / 2] / static_cast<double>(ops), 0.0, {}};
+            if (is_adaptive<Map>::value && i == phases.size())
+                r.extra.emplace_back("conversions", static_cast<double>(conversions));
+            results.push_back(std::move(r));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--phase-scale")   opt.phaseScale = std::stod(value);
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e3,1e5] [--phase-scale=10]"
+                  << " [--containers=mystl::adaptive_map,mystl::map,mystl::flat_map,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        auto scaled = static_cast<std::uint64_t>(static_cast<double>(n) * opt.phaseScale);
+        std::vector<Phase> phases = {
+            {"load", 1.0, n},
+            {"read", 0.0, scaled},
+            {"mixed", 0.5, std::max<std::uint64_t>(scaled / 10, 1)},
+            {"read", 0.001, scaled},
+        };
+        measure<mystl::adaptive_map<Key, Value>>("mystl::adaptive_map", n, phases, opt, results);
+        measure<mystl::map<Key, Value>>("mystl::map", n, phases, opt, results);
+        measure<mystl::flat_map<Key, Value>>("mystl::flat_map", n, phases, opt, results);
+        measure<std::map<Key, Value>>("std::map", n, phases, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,205 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/arena.hpp"
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Циклы «построить – опросить – выбросить» для карт на время одного запроса:
+ * mystl::map и std::map с std::allocator против тех же карт с mystl::arena_allocator
+ * и std::pmr-ресурсами.
+ *   +arena     – mystl::arena живёт между циклами и сбрасывается reset() после каждого, так что
+ *                после первого цикла узлы выделяются без malloc. У mystl::map с ареной и тривиальными
+ *                uint64_t ключами и значениями деструктор не обходит узлы; std::map обходит всегда;
+ *   +monotonic – std::pmr::monotonic_buffer_resource поверх заранее выделенного буфера, новый на цикл;
+ *   +pool      – один std::pmr::unsynchronized_pool_resource на все циклы: узлы возвращаются в пул.
+ *   build   – вставка size ключей в случайном порядке;
+ *   query   – size поисков (половина промахов);
+ *   discard – деструктор карты плюс reset арены или ресурса;
+ * всё в нс на элемент, cycle – сумма трёх фаз.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+    using ArenaAlloc = mystl::arena_allocator<std::pair<const Key, Value>>;
+
+    enum class Backing { Heap, Arena, Monotonic, Pool };
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {16, 256, 4096, 65536};
+        std::vector<std::string> containers = {"mystl::map+arena", "mystl::pmr::map+monotonic", "mystl::pmr::map+pool",
+                                               "mystl::map", "std::map+arena", "std::pmr::map+monotonic",
+                                               "std::pmr::map+pool", "std::map"};
+        std::uint64_t elements = 2000000;   // элементов на замер, cycles = elements / size
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    struct Workload
+    {
+        std::vector<Key> keys;
+        std::vector<Key> probes;
+    };
+
+    // Время build, query, discard в нс суммарно по всем циклам
+    template <typename Map, Backing B>
+    std::vector<double> runOnce(const Workload& w, std::uint64_t cycles)
+    {
+        std::vector<double> times(3, 0.0);
+        std::uint64_t sum = 0;
+        mystl::arena a;
+        std::pmr::unsynchronized_pool_resource pool;
+        std::vector<std::byte> buffer(B == Backing::Monotonic ? w.keys.size() * 96 + 4096 : 0);
+        bench::Timer t;
+
+        for (std::uint64_t c = 0; c < cycles; ++c)
+        {
+            std::optional<std::pmr::monotonic_buffer_resource> mono;
+            std::optional<Map> m;
+            t.reset();
+            if constexpr (B == Backing::Arena)
+                m.emplace(typename Map::key_compare(), ArenaAlloc(a));
+            else if constexpr (B == Backing::Monotonic)
+            {
+                mono.emplace(buffer.data(), buffer.size());
+                m.emplace(typename Map::key_compare(), typename Map::allocator_type(&*mono));
+            }
+            else if constexpr (B == Backing::Pool)
+                m.emplace(typename Map::key_compare(), typename Map::allocator_type(&pool));
+            else
+                m.emplace();
+            for (Key k : w.keys)
+                (*m)[k] = k;
+            times[0] += t.elapsedNs();
+
+            t.reset();
+            for (Key k : w.probes)
+                sum += m->find(k) != m->end();
+            times[1] += t.elapsedNs();
+
+            t.reset();
+            m.reset();
+            if constexpr (B == Backing::Arena)
+                a.reset();
+            mono.reset();
+            times[2] += t.elapsedNs();
+        }
+        bench::doNotOptimize(sum);
+        return times;
+    }
+
+    template <typename Map, Backing B>
+    void measure(const char* name, const Workload& w, const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = w.keys.size();
+        std::uint64_t cycles = std::max<std::uint64_t>(1, opt.elements / n);
+        std::cerr << "  " << name << " size=" << n << " cycles=" << cycles << '\n';
+
+        std::vector<std::vector<double>> samples(4);
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto times = runOnce<Map, B>(w, cycles);
+            double total = 0.0;
+            for (std::size_t i = 0; i < times.size(); ++i)
+            {
+                samples[i].push_back(times[i]);
+                total += times[i];
+            }
+            samples[3].push_back(total);
+        }
+
+        static const char* ops[] = {"build", "query", "discard", "cycle"};
+        double elements = static_cast<double>(n * cycles);
+        for (std::size_t i = 0; i < samples.size(); ++i)
+        {
+            std::sort(samples[i].begin(), samples[i].end());
+            bench::Result r{name, "u64", "uniform", n, ops[i], n * cycles,
+                            samples[i][samples[i].size() / 2] / elements, 0.0, {}};
+            r.extra.emplace_back("cycles", static_cast<double>(cycles));
+            results.push_back(std::move(r));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--elements")      opt.elements = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=16,256,4096,65536] [--elements=2e6]"
+                  << " [--containers=mystl::map+arena,mystl::pmr::map+monotonic,mystl::pmr::map+pool,mystl::map,"
+                  << "std::map+arena,std::pmr::map+monotonic,std::pmr::map+pool,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        Workload w;
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            w.keys.push_back(bench::mix64(i));
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            w.probes.push_back(i % 2 ? w.keys[i] : bench::mix64(n + i));
+
+        measure<mystl::map<Key, Value, std::less<Key>, ArenaAlloc>, Backing::Arena>("mystl::map+arena", w, opt, results);
+        measure<mystl::pmr::map<Key, Value>, Backing::Monotonic>("mystl::pmr::map+monotonic", w, opt, results);
+        measure<mystl::pmr::map<Key, Value>, Backing::Pool>("mystl::pmr::map+pool", w, opt, results);
+        measure<mystl::map<Key, Value>, Backing::Heap>("mystl::map", w, opt, results);
+        measure<std::map<Key, Value, std::less<Key>, ArenaAlloc>, Backing::Arena>("std::map+arena", w, opt, results);
+        measure<std::pmr::map<Key, Value>, Backing::Monotonic>("std::pmr::map+monotonic", w, opt, results);
+        measure<std::pmr::map<Key, Value>, Backing::Pool>("std::pmr::map+pool", w, opt, results);
+        measure<std::map<Key, Value>, Backing::Heap>("std::map", w, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
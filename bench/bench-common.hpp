@@ -0,0 +1,344 @@
+#ifndef BENCH_COMMON_HPP
+#define BENCH_COMMON_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+/**
+ * Общие утилиты для бенчмарков: таймер, генераторы ключей и распределений,
+ * вывод результатов в CSV/JSON. Никаких внешних зависимостей.
+ */
+namespace bench {
+
+    // Не даёт компилятору выбросить вычисление, результат которого не используется
+    template <typename T>
+    inline void doNotOptimize(const T& value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        static volatile const void* sink;
+        sink = &value;
+#endif
+    }
+
+    inline void clobberMemory()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#endif
+    }
+
+    class Timer
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        Timer() : start(clock::now()) {}
+
+        void reset() { start = clock::now(); }
+
+        double elapsedNs() const
+        {
+            return std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        }
+
+    private:
+        clock::time_point start;
+    };
+
+    // Биекция на 64-битных числах (финализатор SplitMix64): различные входы дают различные ключи
+    inline std::uint64_t mix64(std::uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+    class Random
+    {
+    public:
+        explicit Random(std::uint64_t seed = 42) : state(seed) {}
+
+        std::uint64_t next() { return mix64(state++); }
+
+        // Равномерно в [0, bound)
+        std::uint64_t below(std::uint64_t bound)
+        {
+            return static_cast<std::uint64_t>((static_cast<unsigned __int128>(next()) * bound) >> 64);
+        }
+
+        double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    private:
+        std::uint64_t state;
+    };
+
+    /**
+     * Генератор Зипфа в стиле YCSB (Gray et al., "Quickly generating billion-record
+     * synthetic databases"). Возвращает ранг в [0, n), ранг 0 – самый популярный.
+     */
+    class Zipfian
+    {
+    public:
+        explicit Zipfian(std::uint64_t n, double theta = 0.99)
+            : items(n), theta(theta)
+        {
+            zetan = zeta(n, theta);
+            double zeta2 = zeta(2, theta);
+            alpha = 1.0 / (1.0 - theta);
+            eta = (1.0 - std::pow(2.0 / static_cast<double>(n), 1.0 - theta)) / (1.0 - zeta2 / zetan);
+        }
+
+        std::uint64_t next(Random& rng) const
+        {
+            double u = rng.unit();
+            double uz = u * zetan;
+            if (uz < 1.0)
+                return 0;
+            if (uz < 1.0 + std::pow(0.5, theta))
+                return items > 1 ? 1 : 0;
+            auto rank = static_cast<std::uint64_t>(static_cast<double>(items) * std::pow(eta * u - eta + 1.0, alpha));
+            return rank < items ? rank : items - 1;
+        }
+
+        std::uint64_t size() const { return items; }
+
+    private:
+        static double zeta(std::uint64_t n, double theta)
+        {
+            double sum = 0.0;
+            for (std::uint64_t i = 1; i <= n; ++i)
+                sum += 1.0 / std::pow(static_cast<double>(i), theta);
+            return sum;
+        }
+
+        std::uint64_t items;
+        double theta;
+        double zetan = 0.0;
+        double alpha = 0.0;
+        double eta = 0.0;
+    };
+
+    enum class Distribution { Uniform, Sequential, Zipfian };
+
+    inline const char* toString(Distribution d)
+    {
+        switch (d)
+        {
+            case Distribution::Uniform:    return "uniform";
+            case Distribution::Sequential: return "sequential";
+            case Distribution::Zipfian:    return "zipfian";
+        }
+        return "?";
+    }
+
+    /**
+     * Генераторы ключей: index -> ключ. Биективность гарантирует, что индексы
+     * [0, n) дают n различных ключей, а индексы [n, 2n) – ключи, которых нет в наборе.
+     */
+    template <typename Key>
+    struct KeyGen;
+
+    template <>
+    struct KeyGen<int>
+    {
+        static const char* name() { return "int"; }
+        static int make(std::uint64_t i)
+        {
+            return static_cast<int>(static_cast<std::uint32_t>(i) * 0x9E3779B1u);
+        }
+    };
+
+    template <>
+    struct KeyGen<std::uint64_t>
+    {
+        static const char* name() { return "u64"; }
+        static std::uint64_t make(std::uint64_t i) { return mix64(i); }
+    };
+
+    template <>
+    struct KeyGen<std::string>
+    {
+        static const char* name() { return "string"; }
+        // 17 символов – больше SSO-буфера, так что у строки есть отдельный heap-буфер
+        static std::string make(std::uint64_t i)
+        {
+            char buf[24];
+            std::snprintf(buf, sizeof(buf), "k%016llx", static_cast<unsigned long long>(mix64(i)));
+            return std::string(buf);
+        }
+    };
+
+    /**
+     * Последовательность индексов длины count в [0, n):
+     * uniform – равномерно, sequential – по возрастанию (циклически),
+     * zipfian – по Зипфу с перемешанными рангами, чтобы горячие ключи не были соседями.
+     */
+    inline std::vector<std::uint64_t> makeIndexStream(Distribution dist, std::uint64_t n,
+                                                      std::uint64_t count, std::uint64_t seed = 7)
+    {
+        std::vector<std::uint64_t> out;
+        out.reserve(count);
+        Random rng(seed);
+        switch (dist)
+        {
+            case Distribution::Uniform:
+                for (std::uint64_t i = 0; i < count; ++i)
+                    out.push_back(rng.below(n));
+                break;
+            case Distribution::Sequential:
+                for (std::uint64_t i = 0; i < count; ++i)
+                    out.push_back(i % n);
+                break;
+            case Distribution::Zipfian:
+            {
+                Zipfian zipf(n);
+                for (std::uint64_t i = 0; i < count; ++i)
+                    out.push_back(mix64(zipf.next(rng)) % n);
+                break;
+            }
+        }
+        return out;
+    }
+
+    // Перестановка [0, n): по возрастанию для sequential, случайная для остальных распределений
+    inline std::vector<std::uint64_t> makeInsertOrder(Distribution dist, std::uint64_t n, std::uint64_t seed = 11)
+    {
+        std::vector<std::uint64_t> order(n);
+        for (std::uint64_t i = 0; i < n; ++i)
+            order[i] = i;
+        if (dist != Distribution::Sequential)
+        {
+            Random rng(seed);
+            for (std::uint64_t i = n; i > 1; --i)
+                std::swap(order[i - 1], order[rng.below(i)]);
+        }
+        return order;
+    }
+
+    struct Result
+    {
+        std::string container;
+        std::string key;
+        std::string dist;
+        std::uint64_t size = 0;
+        std::string op;
+        std::uint64_t ops = 0;
+        double nsPerOp = 0.0;
+        // Отношение к std::map для того же случая (0 – если сравнивать не с чем)
+        double vsStdMap = 0.0;
+        // Дополнительные колонки (например, аппаратные счётчики)
+        std::vector<std::pair<std::string, double>> extra;
+
+        double opsPerSec() const { return nsPerOp > 0.0 ? 1e9 / nsPerOp : 0.0; }
+    };
+
+    // Заполняет Result::vsStdMap по строкам std::map с тем же (key, dist, size, op)
+    inline void fillRelativeToStdMap(std::vector<Result>& results)
+    {
+        std::map<std::tuple<std::string, std::string, std::uint64_t, std::string>, double> baseline;
+        for (const auto& r : results)
+            if (r.container == "std::map")
+                baseline[{r.key, r.dist, r.size, r.op}] = r.nsPerOp;
+        for (auto& r : results)
+        {
+            auto it = baseline.find({r.key, r.dist, r.size, r.op});
+            if (it != baseline.end() && it->second > 0.0)
+                r.vsStdMap = r.nsPerOp / it->second;
+        }
+    }
+
+    inline std::string jsonEscape(const std::string& s)
+    {
+        std::string out;
+        for (char c : s)
+        {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out;
+    }
+
+    inline void writeCsv(std::ostream& os, const std::vector<Result>& results)
+    {
+        os << "container,key,dist,size,op,ops,ns_per_op,ops_per_sec,vs_std_map";
+        std::vector<std::string> extraNames;
+        for (const auto& r : results)
+            for (const auto& [name, value] : r.extra)
+                if (std::find(extraNames.begin(), extraNames.end(), name) == extraNames.end())
+                    extraNames.push_back(name);
+        for (const auto& name : extraNames)
+            os << ',' << name;
+        os << '\n';
+
+        for (const auto& r : results)
+        {
+            os << r.container << ',' << r.key << ',' << r.dist << ',' << r.size << ','
+               << r.op << ',' << r.ops << ',' << r.nsPerOp << ',' << r.opsPerSec() << ',' << r.vsStdMap;
+            for (const auto& name : extraNames)
+            {
+                os << ',';
+                for (const auto& [n, value] : r.extra)
+                    if (n == name)
+                        os << value;
+            }
+            os << '\n';
+        }
+    }
+
+    inline void writeJson(std::ostream& os, const std::vector<Result>& results)
+    {
+        os << "[\n";
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto& r = results[i];
+            os << "  {\"container\": \"" << jsonEscape(r.container) << "\", \"key\": \"" << r.key
+               << "\", \"dist\": \"" << r.dist << "\", \"size\": " << r.size
+               << ", \"op\": \"" << r.op << "\", \"ops\": " << r.ops
+               << ", \"ns_per_op\": " << r.nsPerOp << ", \"ops_per_sec\": " << r.opsPerSec()
+               << ", \"vs_std_map\": " << r.vsStdMap;
+            for (const auto& [name, value] : r.extra)
+                os << ", \"" << jsonEscape(name) << "\": " << value;
+            os << '}' << (i + 1 < results.size() ? "," : "") << '\n';
+        }
+        os << "]\n";
+    }
+
+    // Разбор списков вида "1000,10000,1e6"
+    inline std::vector<std::uint64_t> parseSizes(const std::string& arg)
+    {
+        std::vector<std::uint64_t> sizes;
+        std::stringstream ss(arg);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                sizes.push_back(static_cast<std::uint64_t>(std::stod(item)));
+        return sizes;
+    }
+
+    inline std::vector<std::string> parseList(const std::string& arg)
+    {
+        std::vector<std::string> items;
+        std::stringstream ss(arg);
+        std::string item;
+        while (std::getline(ss, item, ','))
+            if (!item.empty())
+                items.push_back(item);
+        return items;
+    }
+
+} // namespace bench
+
+#endif // BENCH_COMMON_HPP
@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Длительная смена содержимого: карта держит постоянно size ключей, и каждый цикл
+ * удаляет случайный живой ключ и вставляет новый. В контрольных точках измеряется
+ * задержка find по живым ключам, а для mystl::map – высота дерева и её граница
+ * 2 * log2(n + 1). Если высота вышла за границу, программа завершается с кодом 1.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::uint64_t size = 1000000;
+        std::uint64_t cycles = 10000000;
+        std::uint64_t checkpoints = 10;
+        std::uint64_t lookups = 200000;
+        bool validate = false;
+        std::vector<std::string> containers = {"mystl::map", "std::map"};
+        std::string format = "csv";
+        std::string out;
+    };
+
+    template <typename Map>
+    struct is_mystl_map : std::false_type {};
+
+    template <typename K, typename T, typename Compare, typename Allocator, typename Stats>
+    struct is_mystl_map<mystl::map<K, T, Compare, Allocator, Stats>> : std::true_type {};
+
+    template <typename Map>
+    double lookupNs(const Map& m, const std::vector<Key>& live, std::uint64_t lookups, std::uint64_t seed)
+    {
+        bench::Random rng(seed);
+        std::vector<Key> probe(lookups);
+        for (auto& k : probe)
+            k = live[rng.below(live.size())];
+
+        std::uint64_t sum = 0;
+        bench::Timer t;
+        for (const auto& k : probe)
+            sum += m.find(k)->second;
+        double ns = t.elapsedNs();
+        bench::doNotOptimize(sum);
+        return ns / static_cast<double>(lookups);
+    }
+
+    template <typename Map>
+    bool runChurn(const char* name, const Options& opt, std::vector<bench::Result>& results)
+    {
+        std::cerr << "  " << name << " n=" << opt.size << " cycles=" << opt.cycles << '\n';
+
+        Map m;
+        std::vector<Key> live(opt.size);
+        for (std::uint64_t i = 0; i < opt.size; ++i)
+        {
+            live[i] = bench::KeyGen<Key>::make(i);
+            m.insert({live[i], i});
+        }
+
+        bool ok = true;
+        bench::Random rng(7);
+        std::uint64_t nextKey = opt.size;
+        std::uint64_t done = 0;
+        for (std::uint64_t cp = 0; cp <= opt.checkpoints; ++cp)
+        {
+            std::uint64_t target = opt.checkpoints ? opt.cycles * cp / opt.checkpoints : opt.cycles;
+            std::uint64_t segment = target - done;
+
+            bench::Timer t;
+            for (; done < target; ++done)
+            {
+                Key& slot = live[rng.below(live.size())];
+                m.erase(slot);
+                slot = bench::KeyGen<Key>::make(nextKey++);
+                m.insert({slot, done});
+            }
+            double churnNs = segment ? t.elapsedNs() / static_cast<double>(segment) : 0.0;
+
+            bench::Result r{name, "uint64", "uniform", opt.size, "find_after_churn", opt.lookups,
+                            lookupNs(m, live, opt.lookups, cp + 1), 0.0, {}};
+            r.extra.emplace_back("cycles", static_cast<double>(done));
+            r.extra.emplace_back("churn_ns_per_cycle", churnNs);
+
+            if constexpr (is_mystl_map<Map>::value)
+            {
+                auto stats = m.stats();
+                double bound = 2.0 * std::log2(static_cast<double>(m.size()) + 1.0);
+                r.extra.emplace_back("height", static_cast<double>(stats.height));
+                r.extra.emplace_back("height_bound", bound);
+                r.extra.emplace_back("black_height", static_cast<double>(stats.blackHeight));
+                if (static_cast<double>(stats.height) > bound || (opt.validate && !m.validate()))
+                {
+                    std::cerr << "    invariant violated after " << done << " cycles: height "
+                              << stats.height << " > " << bound << " or validate() failed\n";
+                    ok = false;
+                }
+            }
+            results.push_back(std::move(r));
+        }
+        return ok;
+    }
+
+    void usage(const char* prog)
+    {
+        std::cerr << "Usage: " << prog << " [options]\n"
+                  << "  --size=N            live keys (default 1e6)\n"
+                  << "  --cycles=N          erase+insert cycles, e.g. 1e8 (default 1e7)\n"
+                  << "  --checkpoints=N     measurement points (default 10)\n"
+                  << "  --lookups=N         find calls per checkpoint (default 2e5)\n"
+                  << "  --validate          run map::validate() at each checkpoint\n"
+                  << "  --containers=LIST   mystl::map,std::map\n"
+                  << "  --format=csv|json   output format (default csv)\n"
+                  << "  --out=FILE          output file (default stdout)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--size")               opt.size = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--cycles")        opt.cycles = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--checkpoints")   opt.checkpoints = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--lookups")       opt.lookups = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--validate")      opt.validate = true;
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        usage(argv[0]);
+        return 1;
+    }
+
+    auto enabled = [&](const char* name)
+    {
+        return std::find(opt.containers.begin(), opt.containers.end(), name) != opt.containers.end();
+    };
+
+    bool ok = true;
+    std::vector<bench::Result> results;
+    if (enabled("mystl::map"))
+        ok &= runChurn<mystl::map<Key, Value>>("mystl::map", opt, results);
+    if (enabled("std::map"))
+        ok &= runChurn<std::map<Key, Value>>("std::map", opt, results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return ok ? 0 : 1;
+}
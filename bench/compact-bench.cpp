@@ -0,0 +1,182 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Поиск и обход долгоживущей карты после серии удалений и вставок (узлы разбросаны
+ * по куче) – без компактирования и после mystl::map::compact() в порядке ван Эмде Боаса
+ * и в прямом порядке. std::map – та же карта без компактирования, для сравнения.
+ *   find    – случайные поиски с попаданием, нс на поиск;
+ *   iterate – обход всей карты по порядку, нс на элемент;
+ *   compact – время compact(), нс на узел.
+ * node_pages – число различных страниц 4 КБ, на которых лежат узлы.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {100000, 1000000};
+        std::vector<std::string> containers = {"mystl::map", "mystl::map+compact(veb)", "mystl::map+compact(dfs)", "std::map"};
+        double churn = 4.0;     // удалений и вставок на элемент перед замером
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    template <typename Map>
+    double nodePages(const Map& m)
+    {
+        std::unordered_set<std::uintptr_t> pages;
+        for (const auto& kv : m)
+            pages.insert(reinterpret_cast<std::uintptr_t>(&kv) >> 12);
+        return static_cast<double>(pages.size());
+    }
+
+    // Карта из n ключей после churn * n пар «удалить случайный – вставить новый»;
+    // probes – ключи, живые в конце
+    template <typename Map>
+    void buildChurned(Map& m, std::uint64_t n, double churn, std::vector<Key>& probes)
+    {
+        std::vector<Key> live;
+        live.reserve(n);
+        std::uint64_t next = 0;
+        for (std::uint64_t i = 0; i < n; ++i)
+        {
+            live.push_back(bench::mix64(next++));
+            m.emplace(live.back(), i);
+        }
+        bench::Random rng(42);
+        auto steps = static_cast<std::uint64_t>(churn * static_cast<double>(n));
+        for (std::uint64_t i = 0; i < steps; ++i)
+        {
+            std::uint64_t j = rng.below(n);
+            m.erase(live[j]);
+            live[j] = bench::mix64(next++);
+            m.emplace(live[j], i);
+        }
+        probes.clear();
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            probes.push_back(live[i]);
+    }
+
+    template <typename Map>
+    void measure(const char* name, std::uint64_t n, int compactMode, const Options& opt,
+                 std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::cerr << "  " << name << " size=" << n << '\n';
+
+        std::vector<double> find, iterate, compact;
+        double pages = 0.0;
+        std::uint64_t sum = 0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            Map m;
+            std::vector<Key> probes;
+            buildChurned(m, n, opt.churn, probes);
+
+            bench::Timer t;
+            if constexpr (requires { m.compact(); })
+            {
+                if (compactMode == 1)
+                    m.compact(CompactOrder::VanEmdeBoas);
+                else if (compactMode == 2)
+                    m.compact(CompactOrder::DepthFirst);
+            }
+            compact.push_back(t.elapsedNs() / static_cast<double>(n));
+            pages = nodePages(m);
+
+            t.reset();
+            for (Key k : probes)
+                sum += m.find(k)->second;
+            find.push_back(t.elapsedNs() / static_cast<double>(probes.size()));
+
+            t.reset();
+            for (const auto& kv : m)
+                sum += kv.second;
+            iterate.push_back(t.elapsedNs() / static_cast<double>(m.size()));
+        }
+        bench::doNotOptimize(sum);
+
+        auto emit = [&](const char* op, std::vector<double>& samples)
+        {
+            std::sort(samples.begin(), samples.end());
+            bench::Result r{name, "u64", "churned", n, op, n, samples[samples.size() / 2], 0.0, {}};
+            r.extra.emplace_back("node_pages", pages);
+            results.push_back(std::move(r));
+        };
+        emit("find", find);
+        emit("iterate", iterate);
+        if (compactMode)
+            emit("compact", compact);
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--churn")         opt.churn = std::max(0.0, std::stod(value));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e5,1e6] [--churn=4]"
+                  << " [--containers=mystl::map,mystl::map+compact(veb),mystl::map+compact(dfs),std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        measure<mystl::map<Key, Value>>("mystl::map", n, 0, opt, results);
+        measure<mystl::map<Key, Value>>("mystl::map+compact(veb)", n, 1, opt, results);
+        measure<mystl::map<Key, Value>>("mystl::map+compact(dfs)", n, 2, opt, results);
+        measure<std::map<Key, Value>>("std::map", n, 0, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
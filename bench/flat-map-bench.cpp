@@ -0,0 +1,217 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/flat-map.hpp"
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * mystl::flat_map против красно-чёрного mystl::map при разной доле чтений.
+ * Карта заполняется n ключами из [0, n), затем выполняется смесь операций:
+ * чтение – find существующего ключа, запись – insert ключа из [0, 2n)
+ * (половина записей попадает в уже существующие ключи и ничего не меняет).
+ *
+ * mystl::flat_map+batch копит записи и применяет их через insert_range
+ * каждые --batch записей: так flat_map предполагается использовать.
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {1000, 10000, 100000};
+        std::vector<double> readRatios = {0.5, 0.9, 0.99, 0.999, 1.0};
+        std::vector<std::string> keys = {"u64", "string"};
+        std::vector<std::string> containers = {"mystl::map", "mystl::flat_map", "mystl::flat_map+batch", "std::map"};
+        std::uint64_t ops = 1000000;
+        std::uint64_t batch = 1024;
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    double median(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    template <typename Key>
+    struct Step
+    {
+        bool write;
+        Key key;
+    };
+
+    template <typename Key>
+    std::vector<Step<Key>> makeSteps(std::uint64_t n, double readRatio, std::uint64_t ops)
+    {
+        bench::Random rng(17);
+        std::vector<Step<Key>> steps;
+        steps.reserve(ops);
+        for (std::uint64_t i = 0; i < ops; ++i)
+        {
+            bool write = rng.unit() >= readRatio;
+            steps.push_back({write, bench::KeyGen<Key>::make(rng.below(write ? 2 * n : n))});
+        }
+        return steps;
+    }
+
+    // std::map не имеет insert_range (до C++23) – вставляем по одному
+    template <typename Map, typename Items>
+    void insertAll(Map& m, const Items& items)
+    {
+        if constexpr (requires { m.insert_range(items.begin(), items.end()); })
+            m.insert_range(items.begin(), items.end());
+        else
+            m.insert(items.begin(), items.end());
+    }
+
+    template <typename Map, typename Key>
+    double runMix(std::uint64_t n, const std::vector<Step<Key>>& steps, std::uint64_t batch)
+    {
+        Map m;
+        std::vector<std::pair<Key, Value>> initial;
+        for (std::uint64_t i = 0; i < n; ++i)
+            initial.emplace_back(bench::KeyGen<Key>::make(i), i);
+        insertAll(m, initial);
+
+        std::vector<std::pair<Key, Value>> pending;
+        std::uint64_t found = 0;
+        bench::Timer t;
+        for (const auto& s : steps)
+        {
+            if (!s.write)
+            {
+                found += m.find(s.key) != m.end();
+                continue;
+            }
+            if (batch == 0)
+            {
+                m.insert({s.key, found});
+                continue;
+            }
+            pending.emplace_back(s.key, found);
+            if (pending.size() >= batch)
+            {
+                insertAll(m, pending);
+                pending.clear();
+            }
+        }
+        if (!pending.empty())
+            insertAll(m, pending);
+        double ns = t.elapsedNs();
+        bench::doNotOptimize(found);
+        bench::doNotOptimize(m.size());
+        return ns;
+    }
+
+    template <typename Key>
+    void runKey(const char* keyName, const Options& opt, std::vector<bench::Result>& results)
+    {
+        auto enabled = [&](const char* name)
+        {
+            return std::find(opt.containers.begin(), opt.containers.end(), name) != opt.containers.end();
+        };
+
+        for (std::uint64_t n : opt.sizes)
+        {
+            for (double ratio : opt.readRatios)
+            {
+                std::cerr << "  key=" << keyName << " n=" << n << " read_ratio=" << ratio << '\n';
+                auto steps = makeSteps<Key>(n, ratio, opt.ops);
+                char op[32];
+                std::snprintf(op, sizeof(op), "read_%g", ratio);
+
+                auto measure = [&](const char* name, auto run)
+                {
+                    if (!enabled(name))
+                        return;
+                    std::vector<double> samples;
+                    for (int rep = 0; rep < opt.repeat; ++rep)
+                        samples.push_back(run());
+                    bench::Result r{name, keyName, "uniform", n, op, opt.ops,
+                                    median(samples) / static_cast<double>(opt.ops), 0.0, {}};
+                    results.push_back(std::move(r));
+                };
+
+                measure("mystl::map", [&] { return runMix<mystl::map<Key, Value>>(n, steps, 0); });
+                measure("mystl::flat_map", [&] { return runMix<mystl::flat_map<Key, Value>>(n, steps, 0); });
+                measure("mystl::flat_map+batch", [&] { return runMix<mystl::flat_map<Key, Value>>(n, steps, opt.batch); });
+                measure("std::map", [&] { return runMix<std::map<Key, Value>>(n, steps, 0); });
+            }
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--read-ratios")
+            {
+                opt.readRatios.clear();
+                for (const auto& item : bench::parseList(value))
+                    opt.readRatios.push_back(std::stod(item));
+            }
+            else if (name == "--keys")          opt.keys = bench::parseList(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--ops")           opt.ops = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--batch")         opt.batch = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e3,1e4,1e5] [--read-ratios=0.5,0.9,0.99,0.999,1]"
+                  << " [--keys=u64,string] [--containers=mystl::map,mystl::flat_map,mystl::flat_map+batch,std::map]"
+                  << " [--ops=1e6] [--batch=1024] [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (const auto& key : opt.keys)
+    {
+        if (key == "u64")
+            runKey<std::uint64_t>("u64", opt, results);
+        else if (key == "string")
+            runKey<std::string>("string", opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/huge-page-arena.hpp"
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+#include "perf-counters.hpp"
+
+/**
+ * Поиск в больших картах с узлами в mystl::huge_page_arena (блоки по 2 МБ с
+ * madvise(MADV_HUGEPAGE)) и с std::allocator.
+ *   build – вставка size ключей в случайном порядке, нс на ключ;
+ *   find  – lookups случайных поисков с попаданием, нс на поиск; если доступны
+ *           аппаратные счётчики, к строке добавляются dtlb_misses_per_op и остальные *_per_op.
+ * thp_mb – прирост AnonHugePages в /proc/self/smaps_rollup после построения карты,
+ * advised_chunks – блоки арены, для которых madvise завершился успешно.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+    using HugeAlloc = mystl::huge_page_allocator<std::pair<const Key, Value>>;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {1000000, 10000000};
+        std::vector<std::string> containers = {"mystl::map+hugepage", "mystl::map", "std::map+hugepage", "std::map"};
+        std::uint64_t lookups = 5000000;
+        int repeat = 3;
+        std::string perfMode = "auto";
+        std::string format = "csv";
+        std::string out;
+    };
+
+    // AnonHugePages процесса в МБ; 0, если /proc недоступен
+    double anonHugePagesMb()
+    {
+        std::ifstream in("/proc/self/smaps_rollup");
+        std::string line;
+        while (std::getline(in, line))
+        {
+            if (line.rfind("AnonHugePages:", 0) == 0)
+            {
+                std::istringstream fields(line.substr(14));
+                double kb = 0.0;
+                fields >> kb;
+                return kb / 1024.0;
+            }
+        }
+        return 0.0;
+    }
+
+    template <typename Map>
+    struct Instance
+    {
+        mystl::huge_page_arena arena;
+        Map map;
+
+        Instance() requires std::is_same_v<typename Map::allocator_type, HugeAlloc>
+            : map(typename Map::key_compare(), HugeAlloc(arena)) {}
+
+        Instance() = default;
+    };
+
+    template <typename Map>
+    void measure(const char* name, const std::vector<Key>& keys, const std::vector<Key>& probes,
+                 const Options& opt, bench::PerfCounters* perf, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = keys.size();
+        std::cerr << "  " << name << " size=" << n << '\n';
+
+        std::vector<double> build, find;
+        double thpMb = 0.0;
+        double advised = 0.0;
+        std::uint64_t sum = 0;
+        if (perf)
+            perf->resetTotals();
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            double thpBefore = anonHugePagesMb();
+            Instance<Map> inst;
+            bench::Timer t;
+            for (Key k : keys)
+                inst.map.emplace(k, k);
+            build.push_back(t.elapsedNs() / static_cast<double>(n));
+            thpMb = anonHugePagesMb() - thpBefore;
+            advised = static_cast<double>(inst.arena.advised_chunks());
+
+            if (perf)
+                perf->start();
+            t.reset();
+            for (Key k : probes)
+                sum += inst.map.find(k)->second;
+            find.push_back(t.elapsedNs() / static_cast<double>(probes.size()));
+            if (perf)
+                perf->stop();
+        }
+        bench::doNotOptimize(sum);
+        std::sort(build.begin(), build.end());
+        std::sort(find.begin(), find.end());
+
+        bench::Result b{name, "u64", "uniform", n, "build", n, build[build.size() / 2], 0.0, {}};
+        b.extra = {{"thp_mb", thpMb}, {"advised_chunks", advised}};
+        results.push_back(std::move(b));
+
+        bench::Result f{name, "u64", "uniform", n, "find", probes.size(), find[find.size() / 2], 0.0, {}};
+        if (perf)
+            f.extra = perf->perOp(probes.size() * static_cast<std::uint64_t>(opt.repeat));
+        results.push_back(std::move(f));
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--lookups")       opt.lookups = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--perf")          opt.perfMode = value;
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e6,1e7] [--lookups=5e6]"
+                  << " [--containers=mystl::map+hugepage,mystl::map,std::map+hugepage,std::map]"
+                  << " [--perf=auto|off] [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    bench::PerfCounters counters;
+    bench::PerfCounters* perf = nullptr;
+    if (opt.perfMode != "off")
+    {
+        if (counters.available(bench::PerfCounters::DTLBMisses))
+            perf = &counters;
+        else
+            std::cerr << "dTLB counter unavailable" << (counters.error().empty() ? "" : " (" + counters.error() + ")")
+                      << ", reporting latency only\n";
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        std::vector<Key> keys;
+        keys.reserve(n);
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            keys.push_back(bench::mix64(i));
+        std::vector<Key> probes;
+        probes.reserve(opt.lookups);
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, opt.lookups))
+            probes.push_back(keys[i]);
+
+        measure<mystl::map<Key, Value, std::less<Key>, HugeAlloc>>("mystl::map+hugepage", keys, probes, opt, perf, results);
+        measure<mystl::map<Key, Value>>("mystl::map", keys, probes, opt, perf, results);
+        measure<std::map<Key, Value, std::less<Key>, HugeAlloc>>("std::map+hugepage", keys, probes, opt, perf, results);
+        measure<std::map<Key, Value>>("std::map", keys, probes, opt, perf, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
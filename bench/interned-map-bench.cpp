@@ -0,0 +1,209 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <new>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/interned-map.hpp"
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * mystl::interned_map (байты ключей в арене карты) против mystl::map<std::string, T>
+ * и std::map на путях /tenant-NNNN/bucket-NN/object-... длиннее буфера SSO.
+ *   insert    – нс на ключ; allocs_per_key – обращений к operator new на ключ;
+ *   find_hit, find_miss – нс на поиск;
+ *   churn     – удаление половины ключей и вставка стольких же новых (здесь срабатывает
+ *               компактирование арены), нс на операцию.
+ * Выделения считает замещённый глобальный operator new.
+ */
+
+namespace {
+
+    std::uint64_t allocationCount = 0;
+
+}
+
+[[gnu::noinline]] void* operator new(std::size_t size)
+{
+    ++allocationCount;
+    if (void* p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {10000, 1000000};
+        std::vector<std::string> containers = {"mystl::interned_map", "mystl::map", "std::map"};
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    std::string pathKey(std::uint64_t i)
+    {
+        std::uint64_t h = bench::mix64(i);
+        char buf[80];
+        std::snprintf(buf, sizeof(buf), "/tenant-%04u/bucket-%02u/object-%016llx",
+                      static_cast<unsigned>(h % 64), static_cast<unsigned>((h >> 8) % 16),
+                      static_cast<unsigned long long>(i));
+        return std::string(buf);
+    }
+
+    struct Workload
+    {
+        std::vector<std::string> present;
+        std::vector<std::string> absent;
+        std::vector<std::string> probes;
+    };
+
+    template <typename Map>
+    void insertKey(Map& m, const std::string& k)
+    {
+        if constexpr (requires { m.try_emplace(std::string_view(k), Value(1)); })
+            m.try_emplace(std::string_view(k), Value(1));
+        else
+            m.insert({k, 1});
+    }
+
+    // Время insert, find_hit, find_miss, churn в нс на операцию; allocsPerKey – во время insert
+    template <typename Map>
+    std::vector<double> runOnce(const Workload& w, double& allocsPerKey)
+    {
+        std::vector<double> times;
+        std::uint64_t sum = 0;
+        double n = static_cast<double>(w.present.size());
+
+        Map m;
+        std::uint64_t allocsBefore = allocationCount;
+        bench::Timer t;
+        for (const auto& k : w.present)
+            insertKey(m, k);
+        times.push_back(t.elapsedNs() / n);
+        allocsPerKey = static_cast<double>(allocationCount - allocsBefore) / n;
+
+        t.reset();
+        for (const auto& k : w.probes)
+            sum += m.find(k)->second;
+        times.push_back(t.elapsedNs() / n);
+
+        t.reset();
+        for (const auto& k : w.absent)
+            sum += m.find(k) == m.end();
+        times.push_back(t.elapsedNs() / n);
+
+        std::size_t half = w.present.size() / 2;
+        t.reset();
+        for (std::size_t i = 0; i < half; ++i)
+        {
+            m.erase(w.present[i]);
+            insertKey(m, w.absent[i]);
+        }
+        times.push_back(t.elapsedNs() / static_cast<double>(std::max<std::size_t>(1, 2 * half)));
+
+        bench::doNotOptimize(sum);
+        return times;
+    }
+
+    template <typename Map>
+    void measure(const char* name, const Workload& w, const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = w.present.size();
+        std::cerr << "  " << name << " n=" << n << '\n';
+
+        static const char* ops[] = {"insert", "find_hit", "find_miss", "churn"};
+        std::vector<std::vector<double>> samples(4);
+        double allocsPerKey = 0.0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto times = runOnce<Map>(w, allocsPerKey);
+            for (std::size_t i = 0; i < times.size(); ++i)
+                samples[i].push_back(times[i]);
+        }
+        for (std::size_t i = 0; i < samples.size(); ++i)
+        {
+            std::sort(samples[i].begin(), samples[i].end());
+            bench::Result r{name, "string", "paths", n, ops[i], n, samples[i][samples[i].size() / 2], 0.0, {}};
+            if (i == 0)
+                r.extra.emplace_back("allocs_per_key", allocsPerKey);
+            results.push_back(std::move(r));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e4,1e6]"
+                  << " [--containers=mystl::interned_map,mystl::map,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        Workload w;
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            w.present.push_back(pathKey(i));
+        for (std::uint64_t i = 0; i < n; ++i)
+            w.absent.push_back(pathKey(n + i));
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            w.probes.push_back(w.present[i]);
+
+        measure<mystl::interned_map<Value>>("mystl::interned_map", w, opt, results);
+        measure<mystl::map<std::string, Value>>("mystl::map", w, opt, results);
+        measure<std::map<std::string, Value>>("std::map", w, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
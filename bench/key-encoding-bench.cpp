@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../include/key-encoding.hpp"
+#include "../include/map.hpp"
+#include "../include/radix-map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Поиск по составному ключу (tenant_id, timestamp, name): кортеж, сравниваемый
+ * поле за полем, против normalized_key (один memcmp) в mystl::map и mystl::radix_map.
+ * Пар (арендатор, время) немного, а имена начинаются одинаково, так что в нижней
+ * части дерева сравнение кортежей каждый раз доходит до строки.
+ *
+ * std::map хранит кортежи. find_hit и find_miss кодируют ключ поиска внутри замера (у вызывающего – кортеж),
+ * find_encoded ищет заранее закодированные ключи, decode – обход с декодированием.
+ */
+
+namespace {
+
+    using Tuple = std::tuple<std::uint32_t, std::int64_t, std::string>;
+    using Encoded = mystl::normalized_key<std::uint32_t, std::int64_t, std::string>;
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {10000, 1000000};
+        std::vector<std::string> containers = {"mystl::map<tuple>", "mystl::map<normalized_key>",
+                                               "mystl::radix_map<normalized_key>", "std::map"};
+        std::uint64_t tenants = 16;
+        std::uint64_t timestamps = 1000;
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    // Мало различных (tenant, timestamp) – много ключей с общими первыми полями, как у событий одного окна
+    Tuple makeKey(std::uint64_t i, const Options& opt)
+    {
+        std::uint64_t h = bench::mix64(i);
+        char name[48];
+        std::snprintf(name, sizeof(name), "service.requests.latency.p%02u", static_cast<unsigned>(h % 100));
+        return Tuple{static_cast<std::uint32_t>(h % opt.tenants),
+                     1700000000000LL + static_cast<std::int64_t>((h >> 16) % opt.timestamps),
+                     std::string(name)};
+    }
+
+    // Кортежи с индексом в строке, чтобы ключи были уникальны
+    std::vector<Tuple> makeKeys(std::uint64_t from, std::uint64_t n, const Options& opt)
+    {
+        std::vector<Tuple> keys;
+        keys.reserve(n);
+        for (std::uint64_t i = from; i < from + n; ++i)
+        {
+            Tuple key = makeKey(i, opt);
+            std::get<2>(key) += '.' + std::to_string(i);
+            keys.push_back(std::move(key));
+        }
+        return keys;
+    }
+
+    struct Workload
+    {
+        std::vector<Tuple> present;
+        std::vector<Tuple> absent;
+        std::vector<Tuple> probes;
+        std::vector<Encoded> encodedProbes;
+    };
+
+    template <typename Map>
+    auto toKey(const Tuple& t)
+    {
+        if constexpr (std::is_same_v<typename Map::key_type, Encoded>)
+            return Encoded(t);
+        else
+            return t;
+    }
+
+    // Время каждой операции в нс: insert, find_hit, find_miss, find_encoded, decode
+    template <typename Map>
+    std::vector<std::pair<const char*, double>> runOnce(const Workload& w)
+    {
+        constexpr bool encoded = std::is_same_v<typename Map::key_type, Encoded>;
+        std::vector<std::pair<const char*, double>> times;
+        std::uint64_t sum = 0;
+
+        Map m;
+        bench::Timer t;
+        for (const auto& k : w.present)
+            m.insert({toKey<Map>(k), 1});
+        times.emplace_back("insert", t.elapsedNs());
+
+        t.reset();
+        for (const auto& k : w.probes)
+            sum += m.find(toKey<Map>(k))->second;
+        times.emplace_back("find_hit", t.elapsedNs());
+
+        t.reset();
+        for (const auto& k : w.absent)
+            sum += m.find(toKey<Map>(k)) == m.end();
+        times.emplace_back("find_miss", t.elapsedNs());
+
+        if constexpr (encoded)
+        {
+            t.reset();
+            for (const auto& k : w.encodedProbes)
+                sum += m.find(k)->second;
+            times.emplace_back("find_encoded", t.elapsedNs());
+
+            t.reset();
+            for (const auto& kv : m)
+                sum += std::get<0>(kv.first.decode());
+            times.emplace_back("decode", t.elapsedNs());
+        }
+        bench::doNotOptimize(sum);
+        return times;
+    }
+
+    template <typename Map>
+    void measure(const char* name, std::uint64_t n, const Workload& w, const Options& opt,
+                 std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::cerr << "  " << name << " n=" << n << '\n';
+
+        std::vector<std::vector<std::pair<const char*, double>>> runs;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+            runs.push_back(runOnce<Map>(w));
+
+        for (std::size_t i = 0; i < runs[0].size(); ++i)
+        {
+            std::vector<double> samples;
+            for (const auto& run : runs)
+                samples.push_back(run[i].second);
+            std::sort(samples.begin(), samples.end());
+            bench::Result r{name, "tuple", "uniform", n, runs[0][i].first, n,
+                            samples[samples.size() / 2] / static_cast<double>(n), 0.0, {}};
+            results.push_back(std::move(r));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--tenants")       opt.tenants = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--timestamps")    opt.timestamps = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e4,1e6] [--tenants=16] [--timestamps=1000]"
+                  << " [--containers=mystl::map<tuple>,mystl::map<normalized_key>,mystl::radix_map<normalized_key>,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        Workload w;
+        w.present = makeKeys(0, n, opt);
+        w.absent = makeKeys(n, n, opt);
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            w.probes.push_back(w.present[i]);
+        for (const auto& k : w.probes)
+            w.encodedProbes.emplace_back(k);
+
+        measure<mystl::map<Tuple, Value>>("mystl::map<tuple>", n, w, opt, results);
+        measure<mystl::map<Encoded, Value>>("mystl::map<normalized_key>", n, w, opt, results);
+        measure<mystl::radix_map<Encoded, Value>>("mystl::radix_map<normalized_key>", n, w, opt, results);
+        measure<std::map<Tuple, Value>>("std::map", n, w, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,197 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * mystl::map<std::string, T> с раскладкой узла CachedKeyPrefix против обычной раскладки
+ * и std::map. Наборы ключей:
+ *   random      – короткие случайные ключи bench::KeyGen<std::string> (различаются уже в первых байтах);
+ *   long_random – 64-символьные ключи со случайным началом: хватает 8 байт из узла;
+ *   shared      – пути /tenant-NNNN/bucket-NN/object-... с общим началом длиннее 8 байт:
+ *                 префикс почти всегда совпадает, и видна цена лишней проверки.
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+    using Alloc = std::allocator<std::pair<const std::string, Value>>;
+    using PrefixMap = mystl::map<std::string, Value, std::less<std::string>, Alloc, NullTreeStats, CachedKeyPrefix>;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {10000, 1000000};
+        std::vector<std::string> keySets = {"random", "long_random", "shared"};
+        std::vector<std::string> containers = {"mystl::map+prefix", "mystl::map", "std::map"};
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    std::string longRandomKey(std::uint64_t i)
+    {
+        char buf[80];
+        std::snprintf(buf, sizeof(buf), "%016llx/%s/%016llx",
+                      static_cast<unsigned long long>(bench::mix64(i)),
+                      "service/requests/latency/histogram", static_cast<unsigned long long>(i));
+        return std::string(buf);
+    }
+
+    std::string sharedPrefixKey(std::uint64_t i)
+    {
+        std::uint64_t h = bench::mix64(i);
+        char buf[80];
+        std::snprintf(buf, sizeof(buf), "/tenant-%04u/bucket-%02u/object-%016llx",
+                      static_cast<unsigned>(h % 64), static_cast<unsigned>((h >> 8) % 16),
+                      static_cast<unsigned long long>(i));
+        return std::string(buf);
+    }
+
+    struct Workload
+    {
+        std::vector<std::string> present;
+        std::vector<std::string> absent;
+        std::vector<std::string> probes;
+    };
+
+    template <typename Make>
+    Workload makeWorkload(std::uint64_t n, Make make)
+    {
+        Workload w;
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            w.present.push_back(make(i));
+        for (std::uint64_t i = 0; i < n; ++i)
+            w.absent.push_back(make(n + i));
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            w.probes.push_back(w.present[i]);
+        return w;
+    }
+
+    // Время insert, find_hit и find_miss в нс
+    template <typename Map>
+    std::vector<double> runOnce(const Workload& w)
+    {
+        std::vector<double> times;
+        std::uint64_t sum = 0;
+        Map m;
+
+        bench::Timer t;
+        for (const auto& k : w.present)
+            m.insert({k, 1});
+        times.push_back(t.elapsedNs());
+
+        t.reset();
+        for (const auto& k : w.probes)
+            sum += m.find(k)->second;
+        times.push_back(t.elapsedNs());
+
+        t.reset();
+        for (const auto& k : w.absent)
+            sum += m.find(k) == m.end();
+        times.push_back(t.elapsedNs());
+
+        bench::doNotOptimize(sum);
+        return times;
+    }
+
+    template <typename Map>
+    void measure(const char* name, const char* keySet, const Workload& w, const Options& opt,
+                 std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = w.present.size();
+        std::cerr << "  " << name << " keys=" << keySet << " n=" << n << '\n';
+
+        static const char* ops[] = {"insert", "find_hit", "find_miss"};
+        std::vector<std::vector<double>> samples(3);
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto times = runOnce<Map>(w);
+            for (std::size_t i = 0; i < times.size(); ++i)
+                samples[i].push_back(times[i]);
+        }
+        for (std::size_t i = 0; i < samples.size(); ++i)
+        {
+            std::sort(samples[i].begin(), samples[i].end());
+            bench::Result r{name, "string", keySet, n, ops[i], n,
+                            samples[i][samples[i].size() / 2] / static_cast<double>(n), 0.0, {}};
+            results.push_back(std::move(r));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--keys")          opt.keySets = bench::parseList(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e4,1e6] [--keys=random,long_random,shared]"
+                  << " [--containers=mystl::map+prefix,mystl::map,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        for (const auto& keySet : opt.keySets)
+        {
+            Workload w;
+            if (keySet == "random")
+                w = makeWorkload(n, bench::KeyGen<std::string>::make);
+            else if (keySet == "long_random")
+                w = makeWorkload(n, longRandomKey);
+            else if (keySet == "shared")
+                w = makeWorkload(n, sharedPrefixKey);
+            else
+                continue;
+
+            measure<PrefixMap>("mystl::map+prefix", keySet.c_str(), w, opt, results);
+            measure<mystl::map<std::string, Value>>("mystl::map", keySet.c_str(), w, opt, results);
+            measure<std::map<std::string, Value>>("std::map", keySet.c_str(), w, opt, results);
+        }
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/keyed-set.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Записи, содержащие свой ключ (Order{id, price, qty, side}, 24 байта): mystl::keyed_set
+ * с ключом-проекцией против mystl::map<id, Order> и std::map<id, Order>, где id хранится
+ * дважды, и std::set<Order> с прозрачным компаратором по id.
+ *   build – вставка size записей в случайном порядке, нс на запись;
+ *   find  – случайные поиски с попаданием, нс на поиск.
+ * node_bytes – байт на элемент по memory_usage() (только для mystl, иначе 0).
+ */
+
+namespace {
+
+    struct Order
+    {
+        std::uint64_t id;
+        double price;
+        std::uint32_t qty;
+        std::uint32_t side;
+    };
+
+    struct OrderById
+    {
+        using is_transparent = void;
+        bool operator()(const Order& a, const Order& b) const { return a.id < b.id; }
+        bool operator()(const Order& a, std::uint64_t b) const { return a.id < b; }
+        bool operator()(std::uint64_t a, const Order& b) const { return a < b.id; }
+    };
+
+    using KeyedSet = mystl::keyed_set<Order, mystl::key_member<&Order::id>>;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {100000, 1000000};
+        std::vector<std::string> containers = {"mystl::keyed_set", "mystl::map", "std::map", "std::set"};
+        std::uint64_t lookups = 2000000;
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    Order makeOrder(std::uint64_t id) { return {id, static_cast<double>(id & 0xffff), static_cast<std::uint32_t>(id), 1}; }
+
+    template <typename C>
+    void add(C& c, const Order& o)
+    {
+        if constexpr (requires { typename C::mapped_type; })
+            c.emplace(o.id, o);
+        else
+            c.insert(o);
+    }
+
+    template <typename C>
+    std::uint64_t qtyOf(const C& c, std::uint64_t id)
+    {
+        auto it = c.find(id);
+        if constexpr (requires { it->second.qty; })
+            return it->second.qty;
+        else
+            return it->qty;
+    }
+
+    template <typename C>
+    void measure(const char* name, const std::vector<std::uint64_t>& ids, const std::vector<std::uint64_t>& probes,
+                 const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = ids.size();
+        std::cerr << "  " << name << " size=" << n << '\n';
+
+        std::vector<double> build, find;
+        double nodeBytes = 0.0;
+        std::uint64_t sum = 0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            C c;
+            bench::Timer t;
+            for (std::uint64_t id : ids)
+                add(c, makeOrder(id));
+            build.push_back(t.elapsedNs() / static_cast<double>(n));
+            if constexpr (requires { c.memory_usage(); })
+                nodeBytes = static_cast<double>(c.memory_usage()) / static_cast<double>(n);
+
+            t.reset();
+            for (std::uint64_t id : probes)
+                sum += qtyOf(c, id);
+            find.push_back(t.elapsedNs() / static_cast<double>(probes.size()));
+        }
+        bench::doNotOptimize(sum);
+        std::sort(build.begin(), build.end());
+        std::sort(find.begin(), find.end());
+
+        bench::Result b{name, "u64", "uniform", n, "build", n, build[build.size() / 2], 0.0, {}};
+        b.extra.emplace_back("node_bytes", nodeBytes);
+        results.push_back(std::move(b));
+        bench::Result f{name, "u64", "uniform", n, "find", probes.size(), find[find.size() / 2], 0.0, {}};
+        f.extra.emplace_back("node_bytes", nodeBytes);
+        results.push_back(std::move(f));
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--lookups")       opt.lookups = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e5,1e6] [--lookups=2e6]"
+                  << " [--containers=mystl::keyed_set,mystl::map,std::map,std::set]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        std::vector<std::uint64_t> ids;
+        ids.reserve(n);
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            ids.push_back(bench::mix64(i));
+        std::vector<std::uint64_t> probes;
+        probes.reserve(opt.lookups);
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, opt.lookups))
+            probes.push_back(ids[i]);
+
+        measure<KeyedSet>("mystl::keyed_set", ids, probes, opt, results);
+        measure<mystl::map<std::uint64_t, Order>>("mystl::map", ids, probes, opt, results);
+        measure<std::map<std::uint64_t, Order>>("std::map", ids, probes, opt, results);
+        measure<std::set<Order, OrderById>>("std::set", ids, probes, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace bench {
+
+    /**
+     * Гистограмма задержек в стиле HDR: логарифмические корзины, каждая разбита
+     * на 2^(PrecisionBits-1) линейных подкорзин. Значения меньше 2^PrecisionBits
+     * хранятся точно, относительная ошибка остальных не превышает 2^-(PrecisionBits-1).
+     * Запись – O(1) без выделений памяти, гистограммы потоков складываются через merge().
+     */
+    class LatencyHistogram
+    {
+    public:
+        static constexpr int PrecisionBits = 8;
+
+        LatencyHistogram() : counts(bucketIndex(~0ULL) + 1, 0) {}
+
+        void record(std::uint64_t value)
+        {
+            ++counts[bucketIndex(value)];
+            ++total;
+            sum += value;
+            maxValue = std::max(maxValue, value);
+            minValue = std::min(minValue, value);
+        }
+
+        void merge(const LatencyHistogram& other)
+        {
+            for (std::size_t i = 0; i < counts.size(); ++i)
+                counts[i] += other.counts[i];
+            total += other.total;
+            sum += other.sum;
+            maxValue = std::max(maxValue, other.maxValue);
+            minValue = std::min(minValue, other.minValue);
+        }
+
+        std::uint64_t count() const { return total; }
+        std::uint64_t max() const { return total ? maxValue : 0; }
+        std::uint64_t min() const { return total ? minValue : 0; }
+        double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+        // Наибольшее значение, эквивалентное корзине, в которую попадает перцентиль p ∈ [0, 1]
+        std::uint64_t percentile(double p) const
+        {
+            if (total == 0)
+                return 0;
+            auto target = static_cast<std::uint64_t>(p * static_cast<double>(total));
+            target = std::clamp<std::uint64_t>(target, 1, total);
+            std::uint64_t seen = 0;
+            for (std::size_t i = 0; i < counts.size(); ++i)
+            {
+                seen += counts[i];
+                if (seen >= target)
+                    return std::min(highestEquivalent(i), maxValue);
+            }
+            return maxValue;
+        }
+
+    private:
+        static std::size_t bucketIndex(std::uint64_t v)
+        {
+            if (v < (1ULL << PrecisionBits))
+                return static_cast<std::size_t>(v);
+            int msb = 63 - __builtin_clzll(v);
+            int shift = msb - PrecisionBits + 1;
+            return (static_cast<std::size_t>(shift) << (PrecisionBits - 1)) + static_cast<std::size_t>(v >> shift);
+        }
+
+        static std::uint64_t highestEquivalent(std::size_t index)
+        {
+            if (index < (1ULL << PrecisionBits))
+                return index;
+            std::size_t shift = (index >> (PrecisionBits - 1)) - 1;
+            std::uint64_t sub = index - (shift << (PrecisionBits - 1));
+            return ((sub + 1) << shift) - 1;
+        }
+
+        std::vector<std::uint64_t> counts;
+        std::uint64_t total = 0;
+        std::uint64_t sum = 0;
+        std::uint64_t maxValue = 0;
+        std::uint64_t minValue = ~0ULL;
+    };
+
+} // namespace bench
+
+#endif // LATENCY_HISTOGRAM_HPP
@@ -0,0 +1,455 @@
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+#include "perf-counters.hpp"
+
+/**
+ * Бенчмарк mystl::map в сравнении с std::map и std::unordered_map.
+ *
+ * Для каждой комбинации (контейнер, тип ключа, распределение, размер) измеряются:
+ *   insert, find_hit, find_miss, lower_bound, iterate, copy, move, erase, clear.
+ *
+ * Набор ключей всегда состоит из n различных значений; распределение задаёт порядок
+ * вставки/удаления (sequential – по возрастанию индекса, иначе – случайная перестановка)
+ * и поток запросов для find/lower_bound (uniform, sequential или zipfian).
+ *
+ * Результат – CSV (по умолчанию) или JSON в stdout либо в файл (--out=...).
+ * Если ядро разрешает perf_event_open, рядом с временем выводятся аппаратные
+ * счётчики на операцию (циклы, инструкции, IPC, промахи L1D/LLC/dTLB и предсказания ветвлений).
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {1000, 10000, 100000, 1000000};
+        std::vector<std::string> dists = {"uniform", "sequential", "zipfian"};
+        std::vector<std::string> keys = {"int", "u64", "string"};
+        std::vector<std::string> containers = {"mystl::map", "std::map", "std::unordered_map"};
+        std::vector<std::string> ops = {"insert", "find_hit", "find_miss", "lower_bound",
+                                        "iterate", "copy", "move", "erase", "clear"};
+        std::string format = "csv";
+        std::string out;
+        std::uint64_t minOps = 1000000;
+        std::uint64_t maxOps = 10000000;
+        int repeat = 3;
+        std::string perfMode = "auto";
+        bench::PerfCounters* perf = nullptr;
+    };
+
+    /**
+     * Замер участка: таймер и аппаратные счётчики запускаются в конструкторе
+     * и останавливаются в stop().
+     */
+    class Probe
+    {
+    public:
+        explicit Probe(bench::PerfCounters* counters) : counters(counters)
+        {
+            if (counters)
+                counters->start();
+            timer.reset();
+        }
+
+        double stop()
+        {
+            double ns = timer.elapsedNs();
+            if (counters)
+                counters->stop();
+            return ns;
+        }
+
+    private:
+        bench::PerfCounters* counters;
+        bench::Timer timer;
+    };
+
+    bool contains(const std::vector<std::string>& list, const std::string& item)
+    {
+        return std::find(list.begin(), list.end(), item) != list.end();
+    }
+
+    template <typename Map, typename = void>
+    struct has_lower_bound : std::false_type {};
+
+    template <typename Map>
+    struct has_lower_bound<Map, std::void_t<decltype(std::declval<Map&>().lower_bound(
+        std::declval<const typename Map::key_type&>()))>> : std::true_type {};
+
+    /**
+     * mystl::map с недостижимым бюджетом памяти: показывает цену проверки бюджета при вставке.
+     */
+    template <typename Key>
+    struct BudgetedMap : mystl::map<Key, Value>
+    {
+        BudgetedMap() { this->set_memory_budget(std::numeric_limits<std::size_t>::max() / 2); }
+    };
+
+    /**
+     * mystl::map с подключённым hot_key_sampler: цена сэмплирования find при доле Percent%.
+     */
+    template <typename Key, int Percent>
+    struct SampledMap : mystl::map<Key, Value>
+    {
+        using base = mystl::map<Key, Value>;
+
+        mystl::hot_key_sampler<Key> sampler{Percent / 100.0};
+
+        SampledMap() { this->attach_sampler(&sampler); }
+        SampledMap(const SampledMap& other) : base(other) { this->attach_sampler(&sampler); }
+        SampledMap(SampledMap&& other) : base(std::move(other)) { this->attach_sampler(&sampler); }
+
+        SampledMap& operator=(const SampledMap& other)
+        {
+            base::operator=(other);
+            return *this;
+        }
+
+        SampledMap& operator=(SampledMap&& other)
+        {
+            base::operator=(std::move(other));
+            this->attach_sampler(&sampler);
+            return *this;
+        }
+    };
+
+    template <typename Map, typename = void>
+    struct has_memory_usage : std::false_type {};
+
+    template <typename Map>
+    struct has_memory_usage<Map, std::void_t<decltype(std::declval<const Map&>().memory_usage())>> : std::true_type {};
+
+    double median(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    /**
+     * Данные одного случая: ключи, порядок вставки и потоки запросов.
+     * Строятся один раз и переиспользуются для всех контейнеров.
+     */
+    template <typename Key>
+    struct CaseData
+    {
+        std::vector<Key> insertKeys;
+        std::vector<Key> hitKeys;
+        std::vector<Key> missKeys;
+
+        CaseData(bench::Distribution dist, std::uint64_t n, const Options& opt)
+        {
+            std::uint64_t queries = std::clamp(n, opt.minOps, opt.maxOps);
+
+            insertKeys.reserve(n);
+            for (std::uint64_t idx : bench::makeInsertOrder(dist, n))
+                insertKeys.push_back(bench::KeyGen<Key>::make(idx));
+
+            auto stream = bench::makeIndexStream(dist, n, queries);
+            hitKeys.reserve(queries);
+            missKeys.reserve(queries);
+            for (std::uint64_t idx : stream)
+            {
+                hitKeys.push_back(bench::KeyGen<Key>::make(idx));
+                missKeys.push_back(bench::KeyGen<Key>::make(n + idx));
+            }
+        }
+    };
+
+    template <typename Map, typename Key>
+    void build(Map& m, const CaseData<Key>& data)
+    {
+        Value v = 0;
+        for (const auto& k : data.insertKeys)
+            m.insert(typename Map::value_type(k, v++));
+    }
+
+    template <typename Map, typename Key>
+    void runCase(const std::string& containerName, const char* keyName, bench::Distribution dist,
+                 std::uint64_t n, const CaseData<Key>& data, const Options& opt,
+                 std::vector<bench::Result>& results)
+    {
+        auto record = [&](const std::string& op, std::uint64_t ops, std::vector<double>& samples)
+        {
+            bench::Result r;
+            r.container = containerName;
+            r.key = keyName;
+            r.dist = bench::toString(dist);
+            r.size = n;
+            r.op = op;
+            r.ops = ops;
+            r.nsPerOp = median(samples) / static_cast<double>(ops);
+            results.push_back(r);
+        };
+
+        auto measure = [&](const std::string& op, std::uint64_t ops, auto&& body)
+        {
+            if (!contains(opt.ops, op))
+                return;
+            if (opt.perf)
+                opt.perf->resetTotals();
+            std::vector<double> samples;
+            for (int rep = 0; rep < opt.repeat; ++rep)
+                samples.push_back(body());
+            record(op, ops, samples);
+            if (opt.perf)
+            {
+                auto perOp = opt.perf->perOp(ops * static_cast<std::uint64_t>(opt.repeat));
+                results.back().extra.insert(results.back().extra.end(), perOp.begin(), perOp.end());
+            }
+        };
+
+        std::cerr << "  " << containerName << " key=" << keyName << " dist=" << bench::toString(dist)
+                  << " n=" << n << '\n';
+
+        measure("insert", n, [&]
+        {
+            Map m;
+            Probe t(opt.perf);
+            build(m, data);
+            double ns = t.stop();
+            bench::doNotOptimize(m.size());
+            return ns;
+        });
+
+        Map m;
+        build(m, data);
+
+        // Учтённая память на элемент – в строку insert
+        if constexpr (has_memory_usage<Map>::value)
+        {
+            for (auto& r : results)
+                if (r.container == containerName && r.op == "insert" && r.size == n &&
+                    r.key == keyName && r.dist == bench::toString(dist))
+                    r.extra.emplace_back("bytes_per_entry", static_cast<double>(m.memory_usage()) / static_cast<double>(n));
+        }
+
+        measure("find_hit", data.hitKeys.size(), [&]
+        {
+            std::uint64_t found = 0;
+            Probe t(opt.perf);
+            for (const auto& k : data.hitKeys)
+                found += (m.find(k) != m.end());
+            double ns = t.stop();
+            bench::doNotOptimize(found);
+            return ns;
+        });
+
+        measure("find_miss", data.missKeys.size(), [&]
+        {
+            std::uint64_t found = 0;
+            Probe t(opt.perf);
+            for (const auto& k : data.missKeys)
+                found += (m.find(k) != m.end());
+            double ns = t.stop();
+            bench::doNotOptimize(found);
+            return ns;
+        });
+
+        if constexpr (has_lower_bound<Map>::value)
+        {
+            measure("lower_bound", data.missKeys.size(), [&]
+            {
+                std::uint64_t sum = 0;
+                Probe t(opt.perf);
+                for (const auto& k : data.missKeys)
+                {
+                    auto it = m.lower_bound(k);
+                    if (it != m.end())
+                        sum += it->second;
+                }
+                double ns = t.stop();
+                bench::doNotOptimize(sum);
+                return ns;
+            });
+        }
+
+        measure("iterate", n, [&]
+        {
+            Value sum = 0;
+            Probe t(opt.perf);
+            for (const auto& kv : m)
+                sum += kv.second;
+            double ns = t.stop();
+            bench::doNotOptimize(sum);
+            return ns;
+        });
+
+        measure("copy", n, [&]
+        {
+            Probe t(opt.perf);
+            Map copy(m);
+            double ns = t.stop();
+            bench::doNotOptimize(copy.size());
+            return ns;
+        });
+
+        // Перемещение туда и обратно; для больших карт хватает одного цикла
+        std::uint64_t moveRounds = std::max<std::uint64_t>(1, opt.minOps / std::max<std::uint64_t>(n, 1) / 16);
+        measure("move", moveRounds * 2, [&]
+        {
+            Probe t(opt.perf);
+            for (std::uint64_t i = 0; i < moveRounds; ++i)
+            {
+                Map tmp(std::move(m));
+                m = std::move(tmp);
+            }
+            double ns = t.stop();
+            bench::doNotOptimize(m.size());
+            return ns;
+        });
+
+        measure("erase", n, [&]
+        {
+            Map victim(m);
+            Probe t(opt.perf);
+            for (const auto& k : data.insertKeys)
+                victim.erase(k);
+            double ns = t.stop();
+            bench::doNotOptimize(victim.size());
+            return ns;
+        });
+
+        measure("clear", n, [&]
+        {
+            Map victim(m);
+            Probe t(opt.perf);
+            victim.clear();
+            double ns = t.stop();
+            bench::doNotOptimize(victim.size());
+            return ns;
+        });
+    }
+
+    template <typename Key>
+    void runKey(const Options& opt, std::vector<bench::Result>& results)
+    {
+        const char* keyName = bench::KeyGen<Key>::name();
+        if (!contains(opt.keys, keyName))
+            return;
+
+        for (std::uint64_t n : opt.sizes)
+        {
+            for (auto dist : {bench::Distribution::Uniform, bench::Distribution::Sequential,
+                              bench::Distribution::Zipfian})
+            {
+                if (!contains(opt.dists, bench::toString(dist)))
+                    continue;
+
+                CaseData<Key> data(dist, n, opt);
+                if (contains(opt.containers, "mystl::map"))
+                    runCase<mystl::map<Key, Value>>("mystl::map", keyName, dist, n, data, opt, results);
+                // Не входит в список по умолчанию: сравнение с mystl::map показывает цену TreeCounters
+                if (contains(opt.containers, "mystl::map+stats"))
+                    runCase<mystl::map<Key, Value, std::less<Key>, std::allocator<std::pair<const Key, Value>>, TreeCounters>>(
+                        "mystl::map+stats", keyName, dist, n, data, opt, results);
+                if (contains(opt.containers, "mystl::map+budget"))
+                    runCase<BudgetedMap<Key>>("mystl::map+budget", keyName, dist, n, data, opt, results);
+                if (contains(opt.containers, "mystl::map+sample1"))
+                    runCase<SampledMap<Key, 1>>("mystl::map+sample1", keyName, dist, n, data, opt, results);
+                if (contains(opt.containers, "mystl::map+sample10"))
+                    runCase<SampledMap<Key, 10>>("mystl::map+sample10", keyName, dist, n, data, opt, results);
+                if (contains(opt.containers, "mystl::map+sample100"))
+                    runCase<SampledMap<Key, 100>>("mystl::map+sample100", keyName, dist, n, data, opt, results);
+                if (contains(opt.containers, "std::map"))
+                    runCase<std::map<Key, Value>>("std::map", keyName, dist, n, data, opt, results);
+                if (contains(opt.containers, "std::unordered_map"))
+                    runCase<std::unordered_map<Key, Value>>("std::unordered_map", keyName, dist, n, data, opt, results);
+            }
+        }
+    }
+
+    void printUsage(const char* argv0)
+    {
+        std::cerr
+            << "Usage: " << argv0 << " [options]\n"
+            << "  --sizes=1000,10000,...   map sizes (1e3..1e8, default 1e3..1e6)\n"
+            << "  --dists=uniform,sequential,zipfian\n"
+            << "  --keys=int,u64,string\n"
+            << "  --containers=mystl::map,std::map,std::unordered_map\n"
+            << "               (also: mystl::map+stats, mystl::map+budget, mystl::map+sample{1,10,100})\n"
+            << "  --ops=insert,find_hit,find_miss,lower_bound,iterate,copy,move,erase,clear\n"
+            << "  --min-ops=N --max-ops=N  bounds for lookup stream length\n"
+            << "  --repeat=N               repetitions, median is reported (default 3)\n"
+            << "  --format=csv|json        output format (default csv)\n"
+            << "  --out=FILE               write results to FILE instead of stdout\n"
+            << "  --perf=auto|off          hardware counters via perf_event_open (default auto)\n";
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")            opt.sizes = bench::parseSizes(value);
+            else if (name == "--dists")       opt.dists = bench::parseList(value);
+            else if (name == "--keys")        opt.keys = bench::parseList(value);
+            else if (name == "--containers")  opt.containers = bench::parseList(value);
+            else if (name == "--ops")         opt.ops = bench::parseList(value);
+            else if (name == "--min-ops")     opt.minOps = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--max-ops")     opt.maxOps = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--repeat")      opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")      opt.format = value;
+            else if (name == "--out")         opt.out = value;
+            else if (name == "--perf")        opt.perfMode = value;
+            else
+                return false;
+        }
+        return (opt.format == "csv" || opt.format == "json") && (opt.perfMode == "auto" || opt.perfMode == "off");
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    bench::PerfCounters counters;
+    if (opt.perfMode == "auto")
+    {
+        if (counters.available())
+            opt.perf = &counters;
+        if (counters.availableCount() < bench::PerfCounters::EventCount)
+            std::cerr << "perf counters: " << counters.availableCount() << " of " << bench::PerfCounters::EventCount
+                      << " available" << (counters.error().empty() ? "" : " (" + counters.error() + ")") << '\n';
+    }
+
+    std::vector<bench::Result> results;
+    runKey<int>(opt, results);
+    runKey<std::uint64_t>(opt, results);
+    runKey<std::string>(opt, results);
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "../include/node-cache.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Многопоточная смена узлов: каждый поток строит свою карту из size ключей, затем
+ * rounds раз удаляет половину ключей и вставляет новые, после чего уничтожает карту;
+ * цикл повторяется cycles раз. Карты у потоков свои – общим остаётся только аллокатор.
+ * Сравниваются std::allocator и mystl::thread_cached_allocator для mystl::map и std::map.
+ *   churn – стеночное время всех потоков на одну вставку или удаление (пропускная способность);
+ *   в extra – число потоков и для thread_cached_allocator обращения к общему пулу на 1000 операций.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+    using CachedAlloc = mystl::thread_cached_allocator<std::pair<const Key, Value>>;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> threads = {1, 2, 4, 8, 16, 32, 64};
+        std::vector<std::string> containers = {"mystl::map+thread_cache", "mystl::map",
+                                               "std::map+thread_cache", "std::map"};
+        std::uint64_t size = 4096;
+        std::uint64_t rounds = 8;
+        std::uint64_t cycles = 16;
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    template <typename Map>
+    std::uint64_t churn(std::uint64_t tid, const Options& opt)
+    {
+        std::uint64_t ops = 0;
+        std::uint64_t next = 0;
+        std::uint64_t base = (tid + 1) << 40;
+        for (std::uint64_t c = 0; c < opt.cycles; ++c)
+        {
+            Map m;
+            std::vector<Key> live;
+            live.reserve(opt.size);
+            for (std::uint64_t i = 0; i < opt.size; ++i)
+            {
+                live.push_back(bench::mix64(base + next++));
+                m.emplace(live.back(), i);
+            }
+            ops += opt.size;
+
+            bench::Random rng(tid * 7919 + c);
+            for (std::uint64_t r = 0; r < opt.rounds; ++r)
+            {
+                for (std::uint64_t i = 0; i < opt.size / 2; ++i)
+                {
+                    std::uint64_t j = rng.below(live.size());
+                    m.erase(live[j]);
+                    live[j] = bench::mix64(base + next++);
+                    m.emplace(live[j], i);
+                }
+                ops += opt.size;
+            }
+            ops += m.size();
+        }
+        return ops;
+    }
+
+    template <typename Map>
+    double runOnce(std::uint64_t threads, const Options& opt, std::uint64_t& totalOps)
+    {
+        std::atomic<bool> go{false};
+        std::atomic<std::uint64_t> ready{0};
+        std::vector<std::uint64_t> ops(threads, 0);
+
+        std::vector<std::thread> pool;
+        for (std::uint64_t tid = 0; tid < threads; ++tid)
+            pool.emplace_back([&, tid]
+            {
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire))
+                    std::this_thread::yield();
+                ops[tid] = churn<Map>(tid, opt);
+            });
+        while (ready.load() != threads)
+            std::this_thread::yield();
+
+        bench::Timer wall;
+        go.store(true, std::memory_order_release);
+        for (auto& th : pool)
+            th.join();
+        double wallNs = wall.elapsedNs();
+
+        totalOps = 0;
+        for (std::uint64_t n : ops)
+            totalOps += n;
+        return wallNs;
+    }
+
+    template <typename Map>
+    void measure(const char* name, std::uint64_t threads, const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::cerr << "  " << name << " threads=" << threads << '\n';
+
+        auto before = mystl::thread_cache_stats();
+        std::vector<double> samples;
+        std::uint64_t totalOps = 0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+            samples.push_back(runOnce<Map>(threads, opt, totalOps));
+        auto after = mystl::thread_cache_stats();
+        std::sort(samples.begin(), samples.end());
+
+        bench::Result r{name, "u64", "threads-" + std::to_string(threads), opt.size, "churn", totalOps,
+                        samples[samples.size() / 2] / static_cast<double>(totalOps), 0.0, {}};
+        r.extra.emplace_back("threads", static_cast<double>(threads));
+        if (std::string(name).ends_with("+thread_cache"))
+        {
+            double poolOps = static_cast<double>((after.refills - before.refills) + (after.flushes - before.flushes));
+            r.extra.emplace_back("pool_ops_per_1000", 1000.0 * poolOps / static_cast<double>(totalOps * opt.repeat));
+        }
+        results.push_back(std::move(r));
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--threads")            opt.threads = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--size")          opt.size = std::max<std::uint64_t>(2, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--rounds")        opt.rounds = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--cycles")        opt.cycles = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--threads=1,2,4,8,16,32,64] [--size=4096] [--rounds=8] [--cycles=16]"
+                  << " [--containers=mystl::map+thread_cache,mystl::map,std::map+thread_cache,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t threads : opt.threads)
+    {
+        if (threads == 0)
+            continue;
+        measure<mystl::map<Key, Value, std::less<Key>, CachedAlloc>>("mystl::map+thread_cache", threads, opt, results);
+        measure<mystl::map<Key, Value>>("mystl::map", threads, opt, results);
+        measure<std::map<Key, Value, std::less<Key>, CachedAlloc>>("std::map+thread_cache", threads, opt, results);
+        measure<std::map<Key, Value>>("std::map", threads, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
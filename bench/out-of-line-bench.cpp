@@ -0,0 +1,159 @@
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Поиск в карте с ключом u64 и значением из payload байт: mystl::map с парой в узле
+ * (PlainNodeLayout), с парами в отдельных блоках (OutOfLineValues) и std::map.
+ *   find  – случайные поиски с попаданием, нс на поиск (читается одно слово значения);
+ *   build – вставка size ключей в случайном порядке, нс на ключ.
+ * dist – «payload-N», node_bytes – байт на элемент по memory_usage() (для std::map – 0).
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+
+    template <std::size_t Bytes>
+    using Payload = std::array<std::uint64_t, Bytes / sizeof(std::uint64_t)>;
+
+    template <std::size_t Bytes, typename Layout>
+    using MystlMap = mystl::map<Key, Payload<Bytes>, std::less<Key>, std::allocator<std::pair<const Key, Payload<Bytes>>>,
+                                NullTreeStats, Layout>;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {100000, 1000000};
+        std::vector<std::uint64_t> payloads = {8, 64, 256, 512};
+        std::vector<std::string> containers = {"mystl::map+out_of_line", "mystl::map", "std::map"};
+        std::uint64_t lookups = 2000000;
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    template <typename Map>
+    void measure(const char* name, std::size_t payload, const std::vector<Key>& keys, const std::vector<Key>& probes,
+                 const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = keys.size();
+        std::cerr << "  " << name << " payload=" << payload << " size=" << n << '\n';
+
+        std::vector<double> build, find;
+        double nodeBytes = 0.0;
+        std::uint64_t sum = 0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            Map m;
+            bench::Timer t;
+            for (Key k : keys)
+                m[k][0] = k;
+            build.push_back(t.elapsedNs() / static_cast<double>(n));
+            if constexpr (requires { m.memory_usage(); })
+                nodeBytes = static_cast<double>(m.memory_usage()) / static_cast<double>(n);
+
+            t.reset();
+            for (Key k : probes)
+                sum += m.find(k)->second[0];
+            find.push_back(t.elapsedNs() / static_cast<double>(probes.size()));
+        }
+        bench::doNotOptimize(sum);
+        std::sort(build.begin(), build.end());
+        std::sort(find.begin(), find.end());
+
+        std::string dist = "payload-" + std::to_string(payload);
+        bench::Result f{name, "u64", dist, n, "find", probes.size(), find[find.size() / 2], 0.0, {}};
+        f.extra.emplace_back("node_bytes", nodeBytes);
+        results.push_back(std::move(f));
+        bench::Result b{name, "u64", dist, n, "build", n, build[build.size() / 2], 0.0, {}};
+        b.extra.emplace_back("node_bytes", nodeBytes);
+        results.push_back(std::move(b));
+    }
+
+    template <std::size_t Bytes>
+    void measureAll(const std::vector<Key>& keys, const std::vector<Key>& probes, const Options& opt,
+                    std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.payloads.begin(), opt.payloads.end(), Bytes) == opt.payloads.end())
+            return;
+        measure<MystlMap<Bytes, OutOfLineValues>>("mystl::map+out_of_line", Bytes, keys, probes, opt, results);
+        measure<MystlMap<Bytes, PlainNodeLayout>>("mystl::map", Bytes, keys, probes, opt, results);
+        measure<std::map<Key, Payload<Bytes>>>("std::map", Bytes, keys, probes, opt, results);
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--payloads")      opt.payloads = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--lookups")       opt.lookups = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e5,1e6] [--payloads=8,64,256,512] [--lookups=2e6]"
+                  << " [--containers=mystl::map+out_of_line,mystl::map,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        std::vector<Key> keys;
+        keys.reserve(n);
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            keys.push_back(bench::mix64(i));
+        std::vector<Key> probes;
+        probes.reserve(opt.lookups);
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, opt.lookups))
+            probes.push_back(keys[i]);
+
+        measureAll<8>(keys, probes, opt, results);
+        measureAll<64>(keys, probes, opt, results);
+        measureAll<256>(keys, probes, opt, results);
+        measureAll<512>(keys, probes, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
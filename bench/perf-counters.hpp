@@ -0,0 +1,170 @@
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace bench {
+
+    /**
+     * Аппаратные счётчики через perf_event_open (только Linux, только user-space).
+     * Каждый счётчик открывается отдельно: если ядро или виртуализация не дают
+     * какой-то из них, остальные продолжают работать. Если не открылся ни один,
+     * available() возвращает false, а start()/stop() ничего не делают.
+     */
+    class PerfCounters
+    {
+    public:
+        enum Event { Cycles, Instructions, L1DMisses, LLCMisses, BranchMisses, DTLBMisses, EventCount };
+
+        static const char* name(int e)
+        {
+            static const char* names[] = {"cycles", "instructions", "l1d_misses",
+                                          "llc_misses", "branch_misses", "dtlb_misses"};
+            return names[e];
+        }
+
+        PerfCounters()
+        {
+            for (int e = 0; e < EventCount; ++e)
+                fds[e] = -1;
+#ifdef __linux__
+            const std::uint64_t cacheMiss = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+            open(Cycles, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+            open(Instructions, PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+            open(L1DMisses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | cacheMiss);
+            open(LLCMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+            open(BranchMisses, PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+            open(DTLBMisses, PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_DTLB | cacheMiss);
+#endif
+        }
+
+        ~PerfCounters()
+        {
+#ifdef __linux__
+            for (int fd : fds)
+                if (fd >= 0)
+                    ::close(fd);
+#endif
+        }
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        bool available() const { return availableCount() > 0; }
+
+        bool available(int e) const { return fds[e] >= 0; }
+
+        int availableCount() const
+        {
+            int n = 0;
+            for (int fd : fds)
+                n += fd >= 0;
+            return n;
+        }
+
+        // Причина, по которой счётчики недоступны (для сообщения пользователю)
+        const std::string& error() const { return lastError; }
+
+        void start()
+        {
+#ifdef __linux__
+            for (int fd : fds)
+            {
+                if (fd < 0)
+                    continue;
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+#endif
+        }
+
+        // Останавливает счётчики и прибавляет их значения к total
+        void stop()
+        {
+#ifdef __linux__
+            for (int e = 0; e < EventCount; ++e)
+            {
+                if (fds[e] < 0)
+                    continue;
+                ioctl(fds[e], PERF_EVENT_IOC_DISABLE, 0);
+                std::uint64_t buf[3] = {0, 0, 0};   // value, time_enabled, time_running
+                if (::read(fds[e], buf, sizeof(buf)) != static_cast<ssize_t>(sizeof(buf)))
+                    continue;
+                // При мультиплексировании счётчик работал не всё время – масштабируем
+                double value = static_cast<double>(buf[0]);
+                if (buf[2] > 0 && buf[2] < buf[1])
+                    value *= static_cast<double>(buf[1]) / static_cast<double>(buf[2]);
+                totals[e] += value;
+            }
+#endif
+        }
+
+        double total(int e) const { return totals[e]; }
+
+        void resetTotals()
+        {
+            for (double& t : totals)
+                t = 0.0;
+        }
+
+        /**
+         * Счётчики на одну операцию (и IPC), пригодные для колонок Result::extra.
+         */
+        std::vector<std::pair<std::string, double>> perOp(std::uint64_t ops) const
+        {
+            std::vector<std::pair<std::string, double>> out;
+            if (!available() || ops == 0)
+                return out;
+            double n = static_cast<double>(ops);
+            for (int e = 0; e < EventCount; ++e)
+                if (available(e))
+                    out.emplace_back(std::string(name(e)) + "_per_op", totals[e] / n);
+            if (available(Cycles) && available(Instructions) && totals[Cycles] > 0.0)
+                out.emplace_back("ipc", totals[Instructions] / totals[Cycles]);
+            return out;
+        }
+
+    private:
+#ifdef __linux__
+        void open(int e, std::uint32_t type, std::uint64_t config)
+        {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = type;
+            attr.config = config;
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            long fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+            if (fd < 0)
+            {
+                lastError = std::string(name(e)) + ": " + std::strerror(errno);
+                return;
+            }
+            fds[e] = static_cast<int>(fd);
+        }
+#endif
+
+        int fds[EventCount];
+        double totals[EventCount] = {};
+        std::string lastError;
+    };
+
+} // namespace bench
+
+#endif // PERF_COUNTERS_HPP
@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "../include/radix-map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * mystl::radix_map (ART) против красно-чёрного mystl::map и std::map на трёх наборах ключей:
+ *   dense  – uint64_t подряд из [0, n): верхние байты общие, дерево неглубокое и плотное;
+ *   sparse – uint64_t, перемешанные mix64: первые байты уже различаются;
+ *   url    – строки вида https://host/tenant/bucket/object с длинными общими префиксами.
+ * Для mystl-контейнеров дополнительно выводится bytes_per_key (memory_usage() / n после insert).
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {10000, 1000000};
+        std::vector<std::string> keySets = {"dense", "sparse", "url"};
+        std::vector<std::string> containers = {"mystl::radix_map", "mystl::map", "std::map"};
+        std::vector<std::string> ops = {"insert", "find_hit", "find_miss", "lower_bound", "iterate", "erase"};
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    std::uint64_t denseKey(std::uint64_t i) { return i; }
+    std::uint64_t sparseKey(std::uint64_t i) { return bench::mix64(i); }
+
+    // Около сотни хостов и тысяч «бакетов»: длинные общие префиксы, как у путей в объектном хранилище
+    std::string urlKey(std::uint64_t i)
+    {
+        std::uint64_t h = bench::mix64(i);
+        char buf[96];
+        std::snprintf(buf, sizeof(buf), "https://host-%02u.example.com/tenant-%03u/bucket-%u/object-%012llx",
+                      static_cast<unsigned>(h % 97), static_cast<unsigned>((h >> 8) % 211),
+                      static_cast<unsigned>((h >> 16) % 17), static_cast<unsigned long long>(i));
+        return std::string(buf);
+    }
+
+    template <typename Key>
+    struct KeySet
+    {
+        const char* keyName;
+        const char* name;
+        std::vector<Key> present;   // вставляемые ключи в случайном порядке
+        std::vector<Key> absent;    // ключи, которых нет в карте
+        std::vector<Key> probes;    // порядок поиска: случайная выборка из present
+    };
+
+    template <typename Key, typename Make>
+    KeySet<Key> makeKeySet(const char* keyName, const char* name, std::uint64_t n, Make make)
+    {
+        KeySet<Key> set{keyName, name, {}, {}, {}};
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            set.present.push_back(make(i));
+        for (std::uint64_t i = 0; i < n; ++i)
+            set.absent.push_back(make(n + i));
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            set.probes.push_back(set.present[i]);
+        return set;
+    }
+
+    template <typename Map>
+    std::size_t memoryOf(const Map& m)
+    {
+        if constexpr (requires { m.memory_usage(); })
+            return m.memory_usage();
+        else
+            return 0;
+    }
+
+    // Время каждой операции в нс (по одному числу на op в порядке opt.ops) и байты на ключ
+    template <typename Map, typename Key>
+    std::vector<double> runOnce(const KeySet<Key>& set, const Options& opt, double& bytesPerKey)
+    {
+        std::vector<double> times;
+        std::uint64_t sum = 0;
+        auto want = [&](const char* op) { return std::find(opt.ops.begin(), opt.ops.end(), op) != opt.ops.end(); };
+
+        Map m;
+        bench::Timer t;
+        for (const auto& k : set.present)
+            m.insert({k, 1});
+        if (want("insert"))
+            times.push_back(t.elapsedNs());
+        bytesPerKey = static_cast<double>(memoryOf(m)) / static_cast<double>(set.present.size());
+
+        if (want("find_hit"))
+        {
+            t.reset();
+            for (const auto& k : set.probes)
+                sum += m.find(k)->second;
+            times.push_back(t.elapsedNs());
+        }
+        if (want("find_miss"))
+        {
+            t.reset();
+            for (const auto& k : set.absent)
+                sum += m.find(k) == m.end();
+            times.push_back(t.elapsedNs());
+        }
+        if (want("lower_bound"))
+        {
+            t.reset();
+            for (const auto& k : set.absent)
+            {
+                auto it = m.lower_bound(k);
+                if (it != m.end())
+                    sum += it->second;
+            }
+            times.push_back(t.elapsedNs());
+        }
+        if (want("iterate"))
+        {
+            t.reset();
+            for (const auto& kv : m)
+                sum += kv.second;
+            times.push_back(t.elapsedNs());
+        }
+        if (want("erase"))
+        {
+            t.reset();
+            for (const auto& k : set.present)
+                m.erase(k);
+            times.push_back(t.elapsedNs());
+        }
+        bench::doNotOptimize(sum);
+        return times;
+    }
+
+    template <typename Map, typename Key>
+    void measure(const char* name, const KeySet<Key>& set, const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = set.present.size();
+        std::cerr << "  " << name << " keys=" << set.name << " n=" << n << '\n';
+
+        std::vector<std::vector<double>> samples;
+        double bytesPerKey = 0.0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto times = runOnce<Map>(set, opt, bytesPerKey);
+            samples.resize(times.size());
+            for (std::size_t i = 0; i < times.size(); ++i)
+                samples[i].push_back(times[i]);
+        }
+
+        std::size_t i = 0;
+        for (const auto& op : opt.ops)
+        {
+            if (i >= samples.size())
+                break;
+            std::sort(samples[i].begin(), samples[i].end());
+            bench::Result r{name, set.keyName, set.name, n, op, n,
+                            samples[i][samples[i].size() / 2] / static_cast<double>(n), 0.0, {}};
+            if (bytesPerKey > 0.0)
+                r.extra.emplace_back("bytes_per_key", bytesPerKey);
+            results.push_back(std::move(r));
+            ++i;
+        }
+    }
+
+    template <typename Key>
+    void runKeySet(const KeySet<Key>& set, const Options& opt, std::vector<bench::Result>& results)
+    {
+        measure<mystl::radix_map<Key, Value>>("mystl::radix_map", set, opt, results);
+        measure<mystl::map<Key, Value>>("mystl::map", set, opt, results);
+        measure<std::map<Key, Value>>("std::map", set, opt, results);
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        static const std::vector<std::string> knownOps = {"insert", "find_hit", "find_miss", "lower_bound", "iterate", "erase"};
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--keys")          opt.keySets = bench::parseList(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--ops")
+            {
+                // Порядок операций фиксирован: insert заполняет карту, erase опустошает
+                auto requested = bench::parseList(value);
+                opt.ops.clear();
+                for (const auto& op : knownOps)
+                    if (std::find(requested.begin(), requested.end(), op) != requested.end())
+                        opt.ops.push_back(op);
+            }
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e4,1e6] [--keys=dense,sparse,url]"
+                  << " [--containers=mystl::radix_map,mystl::map,std::map]"
+                  << " [--ops=insert,find_hit,find_miss,lower_bound,iterate,erase]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        for (const auto& keys : opt.keySets)
+        {
+            if (keys == "dense")
+                runKeySet(makeKeySet<std::uint64_t>("u64", "dense", n, denseKey), opt, results);
+            else if (keys == "sparse")
+                runKeySet(makeKeySet<std::uint64_t>("u64", "sparse", n, sparseKey), opt, results);
+            else if (keys == "url")
+                runKeySet(makeKeySet<std::string>("string", "url", n, urlKey), opt, results);
+        }
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
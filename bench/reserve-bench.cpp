@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Вставка size ключей в случайном порядке в mystl::map с reserve(size) и без него
+ * и в std::map. Каждый замер идёт в отдельном процессе (fork), чтобы RSS не зависел
+ * от памяти, оставшейся в malloc после предыдущих замеров.
+ *   insert – нс на ключ (для +reserve вместе с reserve); rss_bytes_per_key – прирост RSS;
+ *   shrink – mystl::map+reserve: reserve(2 * size), вставка size ключей, shrink_to_fit(),
+ *            нс на ключ для shrink_to_fit; rss_bytes_per_key – RSS после него.
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {100000, 1000000, 10000000};
+        std::vector<std::string> containers = {"mystl::map+reserve", "mystl::map", "std::map"};
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    // Resident set size процесса в байтах; 0, если /proc недоступен
+    double residentBytes()
+    {
+        std::ifstream in("/proc/self/statm");
+        std::uint64_t pages = 0;
+        std::uint64_t resident = 0;
+        if (!(in >> pages >> resident))
+            return 0.0;
+#ifdef __linux__
+        return static_cast<double>(resident) * static_cast<double>(::sysconf(_SC_PAGESIZE));
+#else
+        return 0.0;
+#endif
+    }
+
+    // Выполняет fn в дочернем процессе и возвращает два числа, которые он вернул
+    std::pair<double, double> isolated(const std::function<std::pair<double, double>()>& fn)
+    {
+#ifdef __linux__
+        int fds[2];
+        if (::pipe(fds) == 0)
+        {
+            pid_t pid = ::fork();
+            if (pid == 0)
+            {
+                ::close(fds[0]);
+                auto result = fn();
+                double buf[2] = {result.first, result.second};
+                ssize_t written = ::write(fds[1], buf, sizeof(buf));
+                ::_exit(written == static_cast<ssize_t>(sizeof(buf)) ? 0 : 1);
+            }
+            ::close(fds[1]);
+            double buf[2] = {0.0, 0.0};
+            bool ok = pid > 0 && ::read(fds[0], buf, sizeof(buf)) == static_cast<ssize_t>(sizeof(buf));
+            ::close(fds[0]);
+            if (pid > 0)
+                ::waitpid(pid, nullptr, 0);
+            if (ok)
+                return {buf[0], buf[1]};
+        }
+#endif
+        return fn();
+    }
+
+    template <typename Map>
+    std::pair<double, double> insertOnce(const std::vector<Key>& keys, bool reserve)
+    {
+        double before = residentBytes();
+        Map m;
+        bench::Timer t;
+        if constexpr (requires { m.reserve(keys.size()); })
+            if (reserve)
+                m.reserve(keys.size());
+        for (Key k : keys)
+            m.emplace(k, k);
+        double ns = t.elapsedNs() / static_cast<double>(keys.size());
+        double rss = (residentBytes() - before) / static_cast<double>(keys.size());
+        bench::doNotOptimize(m.size());
+        return {ns, rss};
+    }
+
+    std::pair<double, double> shrinkOnce(const std::vector<Key>& keys)
+    {
+        double before = residentBytes();
+        mystl::map<Key, Value> m;
+        m.reserve(2 * keys.size());
+        for (Key k : keys)
+            m.emplace(k, k);
+        bench::Timer t;
+        m.shrink_to_fit();
+        double ns = t.elapsedNs() / static_cast<double>(keys.size());
+        double rss = (residentBytes() - before) / static_cast<double>(keys.size());
+        bench::doNotOptimize(m.size());
+        return {ns, rss};
+    }
+
+    void record(const char* name, const char* op, std::uint64_t n, std::vector<std::pair<double, double>>& samples,
+                std::vector<bench::Result>& results)
+    {
+        std::sort(samples.begin(), samples.end());
+        auto median = samples[samples.size() / 2];
+        bench::Result r{name, "u64", "uniform", n, op, n, median.first, 0.0, {}};
+        r.extra.emplace_back("rss_bytes_per_key", median.second);
+        results.push_back(std::move(r));
+    }
+
+    template <typename Map>
+    void measure(const char* name, const std::vector<Key>& keys, bool reserve, const Options& opt,
+                 std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = keys.size();
+        std::cerr << "  " << name << " size=" << n << '\n';
+
+        std::vector<std::pair<double, double>> insert, shrink;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            insert.push_back(isolated([&] { return insertOnce<Map>(keys, reserve); }));
+            if (reserve)
+                shrink.push_back(isolated([&] { return shrinkOnce(keys); }));
+        }
+        record(name, "insert", n, insert, results);
+        if (reserve)
+            record(name, "shrink", n, shrink, results);
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e5,1e6,1e7]"
+                  << " [--containers=mystl::map+reserve,mystl::map,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        std::vector<Key> keys;
+        keys.reserve(n);
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            keys.push_back(bench::mix64(i));
+
+        measure<mystl::map<Key, Value>>("mystl::map+reserve", keys, true, opt, results);
+        measure<mystl::map<Key, Value>>("mystl::map", keys, false, opt, results);
+        measure<std::map<Key, Value>>("std::map", keys, false, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
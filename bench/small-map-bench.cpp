@@ -0,0 +1,156 @@
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "../include/small-map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Маленькие карты: полный жизненный цикл «создать, вставить size ключей,
+ * найти каждый ключ lookups раз, уничтожить». Результат – наносекунды на одну карту.
+ * Так выглядят карты, создаваемые на каждый запрос, и здесь основную цену
+ * составляют выделения памяти под узлы, а не поиск.
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {1, 2, 4, 8, 16, 32};
+        std::vector<std::string> keys = {"int", "string"};
+        std::vector<std::string> containers = {"mystl::small_map", "mystl::map", "std::map", "std::unordered_map"};
+        std::uint64_t lookups = 4;
+        std::uint64_t minOps = 2000000;
+        int repeat = 5;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    double median(std::vector<double> samples)
+    {
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    template <typename Map, typename Key>
+    bench::Result runCase(const char* name, const char* keyName, std::uint64_t n, const Options& opt)
+    {
+        // Разные наборы ключей для соседних карт, чтобы предсказатель ветвлений не запомнил один набор
+        const std::uint64_t sets = 256;
+        std::vector<Key> keys;
+        keys.reserve(sets * n);
+        for (std::uint64_t i = 0; i < sets * n; ++i)
+            keys.push_back(bench::KeyGen<Key>::make(i));
+
+        std::uint64_t maps = std::max<std::uint64_t>(sets, opt.minOps / (n * (1 + opt.lookups)));
+        std::vector<double> samples;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            std::uint64_t found = 0;
+            bench::Timer t;
+            for (std::uint64_t j = 0; j < maps; ++j)
+            {
+                const Key* set = keys.data() + (j % sets) * n;
+                Map m;
+                for (std::uint64_t i = 0; i < n; ++i)
+                    m.insert({set[i], i});
+                for (std::uint64_t l = 0; l < opt.lookups; ++l)
+                    for (std::uint64_t i = 0; i < n; ++i)
+                        found += m.find(set[i]) != m.end();
+            }
+            samples.push_back(t.elapsedNs() / static_cast<double>(maps));
+            bench::doNotOptimize(found);
+        }
+
+        bench::Result r{name, keyName, "uniform", n, "build_lookup_destroy", maps, median(samples), 0.0, {}};
+        r.extra.emplace_back("ns_per_element", r.nsPerOp / static_cast<double>(n));
+        return r;
+    }
+
+    template <typename Key>
+    void runKey(const char* keyName, const Options& opt, std::vector<bench::Result>& results)
+    {
+        auto enabled = [&](const char* name)
+        {
+            return std::find(opt.containers.begin(), opt.containers.end(), name) != opt.containers.end();
+        };
+
+        for (std::uint64_t n : opt.sizes)
+        {
+            std::cerr << "  key=" << keyName << " n=" << n << '\n';
+            if (enabled("mystl::small_map"))
+                results.push_back(runCase<mystl::small_map<Key, Value, 16>, Key>("mystl::small_map", keyName, n, opt));
+            if (enabled("mystl::map"))
+                results.push_back(runCase<mystl::map<Key, Value>, Key>("mystl::map", keyName, n, opt));
+            if (enabled("std::map"))
+                results.push_back(runCase<std::map<Key, Value>, Key>("std::map", keyName, n, opt));
+            if (enabled("std::unordered_map"))
+                results.push_back(runCase<std::unordered_map<Key, Value>, Key>("std::unordered_map", keyName, n, opt));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--keys")          opt.keys = bench::parseList(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--lookups")       opt.lookups = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--min-ops")       opt.minOps = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1,2,4,8,16,32] [--keys=int,string]"
+                  << " [--containers=mystl::small_map,mystl::map,std::map,std::unordered_map]"
+                  << " [--lookups=4] [--min-ops=2e6] [--repeat=5] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (const auto& key : opt.keys)
+    {
+        if (key == "int")
+            runKey<int>("int", opt, results);
+        else if (key == "string")
+            runKey<std::string>("string", opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "../include/string-btree-map.hpp"
+#include "bench-common.hpp"
+
+/**
+ * mystl::string_btree_map (B+-дерево с фронтальным кодированием ключей в листах)
+ * против mystl::map<std::string, T> и std::map на путях /tenant-NNNN/bucket-NN/object-...
+ *   insert, find_hit      – нс на ключ;
+ *   prefix_scan           – обход всех ключей каждого бакета "/tenant-NNNN/bucket-NN/", нс на найденный ключ;
+ *   erase_prefix          – удаление арендаторов по одному до пустой карты, нс на удалённый ключ.
+ * Для mystl-контейнеров выводится bytes_per_key (memory_usage() / n после insert).
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    struct Options
+    {
+        std::vector<std::uint64_t> sizes = {10000, 1000000};
+        std::vector<std::string> containers = {"mystl::string_btree_map", "mystl::map", "std::map"};
+        std::uint64_t tenants = 64;
+        std::uint64_t buckets = 16;
+        int repeat = 3;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    std::string tenantPrefix(std::uint64_t t)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "/tenant-%04u/", static_cast<unsigned>(t));
+        return std::string(buf);
+    }
+
+    std::string bucketPrefix(std::uint64_t t, std::uint64_t b)
+    {
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "bucket-%02u/", static_cast<unsigned>(b));
+        return tenantPrefix(t) + buf;
+    }
+
+    std::string pathKey(std::uint64_t i, const Options& opt)
+    {
+        std::uint64_t h = bench::mix64(i);
+        char buf[32];
+        std::snprintf(buf, sizeof(buf), "object-%016llx", static_cast<unsigned long long>(i));
+        return bucketPrefix(h % opt.tenants, (h >> 16) % opt.buckets) + buf;
+    }
+
+    struct Workload
+    {
+        std::vector<std::string> present;
+        std::vector<std::string> probes;
+        std::vector<std::string> bucketPrefixes;
+        std::vector<std::string> tenantPrefixes;
+    };
+
+    template <typename Map>
+    std::size_t memoryOf(const Map& m)
+    {
+        if constexpr (requires { m.memory_usage(); })
+            return m.memory_usage();
+        else
+            return 0;
+    }
+
+    template <typename Map>
+    std::uint64_t scanPrefix(Map& m, const std::string& prefix, std::uint64_t& sum)
+    {
+        std::uint64_t visited = 0;
+        if constexpr (requires { m.prefix_range(prefix); })
+        {
+            auto [first, last] = m.prefix_range(prefix);
+            for (; first != last; ++first, ++visited)
+                sum += first->second;
+        }
+        else
+        {
+            for (auto it = m.lower_bound(prefix);
+                 it != m.end() && std::string_view(it->first).starts_with(prefix); ++it, ++visited)
+                sum += it->second;
+        }
+        return visited;
+    }
+
+    template <typename Map>
+    std::uint64_t erasePrefix(Map& m, const std::string& prefix)
+    {
+        if constexpr (requires { m.erase_prefix(prefix); })
+            return m.erase_prefix(prefix);
+        else
+        {
+            std::uint64_t erased = 0;
+            for (auto it = m.lower_bound(prefix); it != m.end() && std::string_view(it->first).starts_with(prefix); ++erased)
+                it = m.erase(it);
+            return erased;
+        }
+    }
+
+    // Время в нс на элемент для insert, find_hit, prefix_scan и erase_prefix; bytesPerKey – после insert
+    template <typename Map>
+    std::vector<double> runOnce(const Workload& w, double& bytesPerKey)
+    {
+        std::vector<double> times;
+        std::uint64_t sum = 0;
+        double n = static_cast<double>(w.present.size());
+
+        Map m;
+        bench::Timer t;
+        for (const auto& k : w.present)
+            m.insert({k, 1});
+        times.push_back(t.elapsedNs() / n);
+        bytesPerKey = static_cast<double>(memoryOf(m)) / n;
+
+        t.reset();
+        for (const auto& k : w.probes)
+            sum += m.find(k)->second;
+        times.push_back(t.elapsedNs() / static_cast<double>(w.probes.size()));
+
+        std::uint64_t visited = 0;
+        t.reset();
+        for (const auto& p : w.bucketPrefixes)
+            visited += scanPrefix(m, p, sum);
+        times.push_back(t.elapsedNs() / static_cast<double>(std::max<std::uint64_t>(1, visited)));
+
+        std::uint64_t erased = 0;
+        t.reset();
+        for (const auto& p : w.tenantPrefixes)
+            erased += erasePrefix(m, p);
+        times.push_back(t.elapsedNs() / static_cast<double>(std::max<std::uint64_t>(1, erased)));
+
+        bench::doNotOptimize(sum);
+        return times;
+    }
+
+    template <typename Map>
+    void measure(const char* name, const Workload& w, const Options& opt, std::vector<bench::Result>& results)
+    {
+        if (std::find(opt.containers.begin(), opt.containers.end(), name) == opt.containers.end())
+            return;
+        std::uint64_t n = w.present.size();
+        std::cerr << "  " << name << " n=" << n << '\n';
+
+        static const char* ops[] = {"insert", "find_hit", "prefix_scan", "erase_prefix"};
+        std::vector<std::vector<double>> samples(4);
+        double bytesPerKey = 0.0;
+        for (int rep = 0; rep < opt.repeat; ++rep)
+        {
+            auto times = runOnce<Map>(w, bytesPerKey);
+            for (std::size_t i = 0; i < times.size(); ++i)
+                samples[i].push_back(times[i]);
+        }
+        for (std::size_t i = 0; i < samples.size(); ++i)
+        {
+            std::sort(samples[i].begin(), samples[i].end());
+            bench::Result r{name, "string", "paths", n, ops[i], n, samples[i][samples[i].size() / 2], 0.0, {}};
+            if (bytesPerKey > 0.0)
+                r.extra.emplace_back("bytes_per_key", bytesPerKey);
+            results.push_back(std::move(r));
+        }
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--sizes")              opt.sizes = bench::parseSizes(value);
+            else if (name == "--containers")    opt.containers = bench::parseList(value);
+            else if (name == "--tenants")       opt.tenants = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--buckets")       opt.buckets = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::stod(value)));
+            else if (name == "--repeat")        opt.repeat = std::max(1, std::stoi(value));
+            else if (name == "--format")        opt.format = value;
+            else if (name == "--out")           opt.out = value;
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--sizes=1e4,1e6] [--tenants=64] [--buckets=16]"
+                  << " [--containers=mystl::string_btree_map,mystl::map,std::map]"
+                  << " [--repeat=3] [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (std::uint64_t n : opt.sizes)
+    {
+        Workload w;
+        for (std::uint64_t i : bench::makeInsertOrder(bench::Distribution::Uniform, n))
+            w.present.push_back(pathKey(i, opt));
+        for (std::uint64_t i : bench::makeIndexStream(bench::Distribution::Uniform, n, n))
+            w.probes.push_back(w.present[i]);
+        for (std::uint64_t t = 0; t < opt.tenants; ++t)
+        {
+            w.tenantPrefixes.push_back(tenantPrefix(t));
+            for (std::uint64_t b = 0; b < opt.buckets; ++b)
+                w.bucketPrefixes.push_back(bucketPrefix(t, b));
+        }
+
+        measure<mystl::string_btree_map<Value>>("mystl::string_btree_map", w, opt, results);
+        measure<mystl::map<std::string, Value>>("mystl::map", w, opt, results);
+        measure<std::map<std::string, Value>>("std::map", w, opt, results);
+    }
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
@@ -0,0 +1,268 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "../include/map-trace.hpp"
+#include "bench-common.hpp"
+
+/**
+ * Воспроизведение трассы, записанной mystl::map с -DMYSTL_MAP_TRACE,
+ * на нескольких контейнерах. Для каждого контейнера выполняется два прохода:
+ * без замеров отдельных операций (пропускная способность) и с замером каждой
+ * операции (перцентили задержки).
+ *
+ * Новый контейнер добавляется одной строкой в main(): достаточно шаблона
+ * MapOf<Key> с интерфейсом, похожим на std::map.
+ */
+
+namespace {
+
+    using Value = std::uint64_t;
+
+    template <typename K> using MystlMapOf = mystl::map<K, Value>;
+    template <typename K> using StdMapOf = std::map<K, Value>;
+    template <typename K> using StdUnorderedMapOf = std::unordered_map<K, Value>;
+
+    // Операция трассы с ключом, уже разложенным по пулам
+    struct ReplayOp
+    {
+        mystl::trace::op_type op;
+        bool stringKey;
+        std::uint32_t mapIndex;
+        std::uint32_t keyIndex;
+    };
+
+    struct Trace
+    {
+        std::vector<ReplayOp> ops;
+        std::vector<std::int64_t> intKeys;
+        std::vector<std::string> stringKeys;
+        std::uint32_t maps = 0;
+    };
+
+    bool loadTrace(const char* path, Trace& trace)
+    {
+        mystl::trace::reader reader(path);
+        if (!reader.valid())
+            return false;
+
+        std::unordered_map<std::uint32_t, std::uint32_t> mapIndex;
+        // Тип ключа каждой карты: 0 – неизвестен, 1 – целый/хэш, 2 – строковый
+        std::vector<int> mapKind;
+        mystl::trace::event ev;
+        while (reader.next(ev))
+        {
+            auto [it, inserted] = mapIndex.emplace(ev.map_id, trace.maps);
+            if (inserted)
+            {
+                ++trace.maps;
+                mapKind.push_back(0);
+            }
+
+            ReplayOp op{ev.op, false, it->second, 0};
+            int& kind = mapKind[it->second];
+            switch (ev.kind)
+            {
+                case mystl::trace::key_kind::none:
+                    if (kind == 0)
+                        continue;
+                    op.stringKey = kind == 2;
+                    break;
+                case mystl::trace::key_kind::integer:
+                case mystl::trace::key_kind::hash:
+                    kind = 1;
+                    op.keyIndex = static_cast<std::uint32_t>(trace.intKeys.size());
+                    trace.intKeys.push_back(ev.kind == mystl::trace::key_kind::integer
+                                                ? ev.int_key : static_cast<std::int64_t>(ev.hash_key));
+                    break;
+                case mystl::trace::key_kind::bytes:
+                    kind = 2;
+                    op.stringKey = true;
+                    op.keyIndex = static_cast<std::uint32_t>(trace.stringKeys.size());
+                    trace.stringKeys.push_back(ev.bytes_key);
+                    break;
+            }
+            trace.ops.push_back(op);
+        }
+        return true;
+    }
+
+    template <typename Map, typename = void>
+    struct has_lower_bound : std::false_type {};
+
+    template <typename Map>
+    struct has_lower_bound<Map, std::void_t<decltype(std::declval<Map&>().lower_bound(
+        std::declval<const typename Map::key_type&>()))>> : std::true_type {};
+
+    // mystl::map::erase пишет в stderr при отсутствии ключа – проверяем заранее
+    template <typename Map>
+    void eraseKey(Map& m, const typename Map::key_type& key)
+    {
+        if constexpr (std::is_same<Map, mystl::map<typename Map::key_type, Value>>::value)
+        {
+            if (m.find(key) != m.end())
+                m.erase(key);
+        }
+        else
+        {
+            m.erase(key);
+        }
+    }
+
+    template <typename Map>
+    Value apply(Map& m, mystl::trace::op_type op, const typename Map::key_type& key)
+    {
+        using mystl::trace::op_type;
+        switch (op)
+        {
+            case op_type::insert:
+                m.insert(typename Map::value_type(key, 1));
+                return 0;
+            case op_type::assign:
+                m.insert_or_assign(key, 1);
+                return 0;
+            case op_type::find:
+                return m.find(key) != m.end();
+            case op_type::access:
+                return ++m[key];
+            case op_type::erase:
+                eraseKey(m, key);
+                return 0;
+            case op_type::lower_bound:
+            case op_type::upper_bound:
+                if constexpr (has_lower_bound<Map>::value)
+                {
+                    auto it = op == op_type::lower_bound ? m.lower_bound(key) : m.upper_bound(key);
+                    return it != m.end() ? it->second : 0;
+                }
+                else
+                {
+                    return m.find(key) != m.end();
+                }
+            case op_type::clear:
+                m.clear();
+                return 0;
+        }
+        return 0;
+    }
+
+    template <template <typename> class MapOf>
+    bench::Result replay(const std::string& name, const Trace& trace)
+    {
+        auto run = [&](std::vector<std::uint32_t>* latencies)
+        {
+            std::vector<MapOf<std::int64_t>> intMaps(trace.maps);
+            std::vector<MapOf<std::string>> stringMaps(trace.maps);
+            Value sink = 0;
+
+            bench::Timer total;
+            for (const auto& op : trace.ops)
+            {
+                bench::Timer t;
+                if (op.stringKey)
+                    sink += apply(stringMaps[op.mapIndex], op.op, trace.stringKeys[op.keyIndex]);
+                else
+                    sink += apply(intMaps[op.mapIndex], op.op, trace.intKeys[op.keyIndex]);
+                if (latencies)
+                    latencies->push_back(static_cast<std::uint32_t>(t.elapsedNs()));
+            }
+            double ns = total.elapsedNs();
+            bench::doNotOptimize(sink);
+            return ns;
+        };
+
+        std::cerr << "  replaying on " << name << '\n';
+        double ns = run(nullptr);
+
+        std::vector<std::uint32_t> latencies;
+        latencies.reserve(trace.ops.size());
+        run(&latencies);
+        std::sort(latencies.begin(), latencies.end());
+        auto percentile = [&](double p) -> double
+        {
+            if (latencies.empty())
+                return 0.0;
+            auto idx = static_cast<std::size_t>(p * static_cast<double>(latencies.size() - 1));
+            return latencies[idx];
+        };
+
+        bench::Result r;
+        r.container = name;
+        r.key = "trace";
+        r.dist = "replay";
+        r.size = trace.maps;
+        r.op = "replay";
+        r.ops = trace.ops.size();
+        r.nsPerOp = trace.ops.empty() ? 0.0 : ns / static_cast<double>(trace.ops.size());
+        r.extra = {{"p50_ns", percentile(0.50)}, {"p90_ns", percentile(0.90)},
+                   {"p99_ns", percentile(0.99)}, {"p999_ns", percentile(0.999)},
+                   {"max_ns", percentile(1.0)}};
+        return r;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " TRACE [--backends=mystl::map,std::map,std::unordered_map]"
+                  << " [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<std::string> backends = {"mystl::map", "std::map", "std::unordered_map"};
+    std::string format = "csv";
+    std::string out;
+    for (int i = 2; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg.rfind("--backends=", 0) == 0)
+            backends = bench::parseList(arg.substr(11));
+        else if (arg.rfind("--format=", 0) == 0)
+            format = arg.substr(9);
+        else if (arg.rfind("--out=", 0) == 0)
+            out = arg.substr(6);
+    }
+
+    Trace trace;
+    if (!loadTrace(argv[1], trace))
+    {
+        std::cerr << "Cannot read trace " << argv[1] << '\n';
+        return 1;
+    }
+    std::cerr << "Loaded " << trace.ops.size() << " operations on " << trace.maps << " maps\n";
+
+    auto enabled = [&](const char* name)
+    {
+        return std::find(backends.begin(), backends.end(), name) != backends.end();
+    };
+
+    std::vector<bench::Result> results;
+    if (enabled("mystl::map"))
+        results.push_back(replay<MystlMapOf>("mystl::map", trace));
+    if (enabled("std::map"))
+        results.push_back(replay<StdMapOf>("std::map", trace));
+    if (enabled("std::unordered_map"))
+        results.push_back(replay<StdUnorderedMapOf>("std::unordered_map", trace));
+    bench::fillRelativeToStdMap(results);
+
+    std::ofstream file;
+    if (!out.empty())
+        file.open(out);
+    std::ostream& os = out.empty() ? std::cout : file;
+    if (format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
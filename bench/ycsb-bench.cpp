@@ -0,0 +1,412 @@
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../include/map.hpp"
+#include "bench-common.hpp"
+#include "latency-histogram.hpp"
+
+/**
+ * Нагрузки в стиле YCSB (A–F) для mystl::map и std::map под блокировками
+ * из нескольких потоков. Для каждой операции строится HDR-гистограмма задержек,
+ * в отчёт попадают p50/p99/p99.9/max, а не только средние значения.
+ *
+ *   A: 50% read, 50% update               (zipfian)
+ *   B: 95% read,  5% update               (zipfian)
+ *   C: 100% read                          (zipfian)
+ *   D: 95% read,  5% insert               (latest)
+ *   E: 95% scan,  5% insert               (zipfian, длина scan 1..100)
+ *   F: 50% read, 50% read-modify-write    (zipfian)
+ */
+
+namespace {
+
+    using Key = std::uint64_t;
+    using Value = std::uint64_t;
+
+    enum OpKind { Read, Update, Insert, Scan, ReadModifyWrite, OpKindCount };
+
+    const char* opName(int op)
+    {
+        static const char* names[] = {"read", "update", "insert", "scan", "rmw"};
+        return names[op];
+    }
+
+    enum class KeyChooser { Zipfian, Latest, Uniform };
+
+    struct Workload
+    {
+        char name;
+        double mix[OpKindCount];
+        KeyChooser chooser;
+    };
+
+    const Workload workloads[] = {
+        {'A', {0.50, 0.50, 0.00, 0.00, 0.00}, KeyChooser::Zipfian},
+        {'B', {0.95, 0.05, 0.00, 0.00, 0.00}, KeyChooser::Zipfian},
+        {'C', {1.00, 0.00, 0.00, 0.00, 0.00}, KeyChooser::Zipfian},
+        {'D', {0.95, 0.00, 0.05, 0.00, 0.00}, KeyChooser::Latest},
+        {'E', {0.00, 0.00, 0.05, 0.95, 0.00}, KeyChooser::Zipfian},
+        {'F', {0.50, 0.00, 0.00, 0.00, 0.50}, KeyChooser::Zipfian},
+    };
+
+    // Ключ записи с номером id: номера плотные, ключи разбросаны по всему диапазону
+    Key keyOf(std::uint64_t id) { return bench::mix64(id); }
+
+    /**
+     * Карта под одним std::mutex: все операции эксклюзивны.
+     */
+    template <typename Map>
+    class MutexMap
+    {
+    public:
+        void insert(Key k, Value v)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            map.insert({k, v});
+        }
+
+        bool read(Key k, Value& out)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = map.find(k);
+            if (it == map.end())
+                return false;
+            out = it->second;
+            return true;
+        }
+
+        void update(Key k, Value v)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            map.insert_or_assign(k, v);
+        }
+
+        Value scan(Key from, std::size_t len)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            Value sum = 0;
+            auto it = map.lower_bound(from);
+            for (std::size_t i = 0; i < len && it != map.end(); ++i, ++it)
+                sum += it->second;
+            return sum;
+        }
+
+        void readModifyWrite(Key k)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            auto it = map.find(k);
+            if (it != map.end())
+                it->second += 1;
+        }
+
+    private:
+        std::mutex mutex;
+        Map map;
+    };
+
+    /**
+     * Карта под std::shared_mutex: read и scan выполняются параллельно.
+     */
+    template <typename Map>
+    class SharedMutexMap
+    {
+    public:
+        void insert(Key k, Value v)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            map.insert({k, v});
+        }
+
+        bool read(Key k, Value& out)
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            auto it = map.find(k);
+            if (it == map.end())
+                return false;
+            out = it->second;
+            return true;
+        }
+
+        void update(Key k, Value v)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            map.insert_or_assign(k, v);
+        }
+
+        Value scan(Key from, std::size_t len)
+        {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            Value sum = 0;
+            auto it = map.lower_bound(from);
+            for (std::size_t i = 0; i < len && it != map.end(); ++i, ++it)
+                sum += it->second;
+            return sum;
+        }
+
+        void readModifyWrite(Key k)
+        {
+            std::unique_lock<std::shared_mutex> lock(mutex);
+            auto it = map.find(k);
+            if (it != map.end())
+                it->second += 1;
+        }
+
+    private:
+        std::shared_mutex mutex;
+        Map map;
+    };
+
+    struct Options
+    {
+        std::vector<std::string> workloads = {"A", "B", "C", "D", "E", "F"};
+        std::vector<std::string> containers = {"mystl::map+mutex", "mystl::map+shared_mutex",
+                                               "std::map+mutex", "std::map+shared_mutex"};
+        std::vector<std::uint64_t> threads = {1, 2, 4};
+        std::uint64_t records = 100000;
+        std::uint64_t operations = 1000000;
+        // Пусто – распределение ключей из описания нагрузки, иначе zipfian/latest/uniform
+        std::string requestDist;
+        std::string format = "csv";
+        std::string out;
+    };
+
+    struct ThreadStats
+    {
+        bench::LatencyHistogram hist[OpKindCount];
+    };
+
+    template <typename Container>
+    void runWorkload(const std::string& containerName, const Workload& w, std::uint64_t threads,
+                     const Options& opt, std::vector<bench::Result>& results)
+    {
+        Container container;
+        for (std::uint64_t id = 0; id < opt.records; ++id)
+            container.insert(keyOf(id), id);
+
+        // nextId – следующий id для вставки; published – все id ниже него уже вставлены,
+        // и только их выбирают чтения (иначе «latest» попадал бы в ещё не вставленные ключи)
+        std::atomic<std::uint64_t> nextId{opt.records};
+        std::atomic<std::uint64_t> published{opt.records};
+        std::atomic<bool> go{false};
+        std::atomic<std::uint64_t> ready{0};
+        std::vector<ThreadStats> stats(threads);
+        bench::Zipfian zipf(opt.records);
+        KeyChooser chooser = w.chooser;
+        if (opt.requestDist == "zipfian")
+            chooser = KeyChooser::Zipfian;
+        else if (opt.requestDist == "latest")
+            chooser = KeyChooser::Latest;
+        else if (opt.requestDist == "uniform")
+            chooser = KeyChooser::Uniform;
+
+        auto worker = [&](std::uint64_t tid)
+        {
+            bench::Random rng(1000 + tid);
+            ThreadStats& local = stats[tid];
+            std::uint64_t ops = opt.operations / threads;
+            Value sink = 0;
+
+            auto chooseId = [&]() -> std::uint64_t
+            {
+                std::uint64_t count = published.load(std::memory_order_acquire);
+                switch (chooser)
+                {
+                    case KeyChooser::Uniform:
+                        return rng.below(count);
+                    case KeyChooser::Latest:
+                    {
+                        std::uint64_t back = zipf.next(rng);
+                        return back < count ? count - 1 - back : 0;
+                    }
+                    case KeyChooser::Zipfian:
+                        break;
+                }
+                return bench::mix64(zipf.next(rng)) % count;
+            };
+
+            ready.fetch_add(1);
+            while (!go.load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            for (std::uint64_t i = 0; i < ops; ++i)
+            {
+                double u = rng.unit();
+                int op = 0;
+                for (double acc = w.mix[0]; op + 1 < OpKindCount && u >= acc; acc += w.mix[++op])
+                    ;
+
+                // Выбор ключа не входит в замер
+                std::uint64_t id = op == Insert ? nextId.fetch_add(1) : chooseId();
+                Key key = keyOf(id);
+                std::size_t scanLength = op == Scan ? 1 + rng.below(100) : 0;
+
+                bench::Timer t;
+                switch (op)
+                {
+                    case Read:
+                    {
+                        Value v = 0;
+                        container.read(key, v);
+                        sink += v;
+                        break;
+                    }
+                    case Update:
+                        container.update(key, i);
+                        break;
+                    case Insert:
+                        container.insert(key, i);
+                        break;
+                    case Scan:
+                        sink += container.scan(key, scanLength);
+                        break;
+                    case ReadModifyWrite:
+                        container.readModifyWrite(key);
+                        break;
+                }
+                local.hist[op].record(static_cast<std::uint64_t>(t.elapsedNs()));
+
+                // id публикуется по порядку, когда вставлены все предыдущие
+                if (op == Insert)
+                {
+                    while (published.load(std::memory_order_acquire) != id)
+                        std::this_thread::yield();
+                    published.store(id + 1, std::memory_order_release);
+                }
+            }
+            bench::doNotOptimize(sink);
+        };
+
+        std::vector<std::thread> pool;
+        for (std::uint64_t tid = 0; tid < threads; ++tid)
+            pool.emplace_back(worker, tid);
+        while (ready.load() != threads)
+            std::this_thread::yield();
+
+        bench::Timer wall;
+        go.store(true, std::memory_order_release);
+        for (auto& th : pool)
+            th.join();
+        double wallNs = wall.elapsedNs();
+
+        bench::LatencyHistogram all;
+        bench::LatencyHistogram perOp[OpKindCount];
+        for (const auto& s : stats)
+        {
+            for (int op = 0; op < OpKindCount; ++op)
+            {
+                perOp[op].merge(s.hist[op]);
+                all.merge(s.hist[op]);
+            }
+        }
+
+        auto emit = [&](const char* op, const bench::LatencyHistogram& h)
+        {
+            bench::Result r;
+            r.container = containerName;
+            r.key = "u64";
+            r.dist = std::string("ycsb-") + w.name;
+            r.size = opt.records;
+            r.op = op;
+            r.ops = h.count();
+            // Пропускная способность по стеночному времени всех потоков
+            r.nsPerOp = wallNs / static_cast<double>(h.count());
+            r.extra = {{"threads", static_cast<double>(threads)},
+                       {"mean_ns", h.mean()},
+                       {"p50_ns", static_cast<double>(h.percentile(0.50))},
+                       {"p99_ns", static_cast<double>(h.percentile(0.99))},
+                       {"p999_ns", static_cast<double>(h.percentile(0.999))},
+                       {"max_ns", static_cast<double>(h.max())}};
+            results.push_back(r);
+        };
+
+        emit("all", all);
+        for (int op = 0; op < OpKindCount; ++op)
+            if (perOp[op].count())
+                emit(opName(op), perOp[op]);
+
+        std::cerr << "  " << containerName << " workload " << w.name << " threads=" << threads
+                  << ": " << static_cast<double>(all.count()) * 1e9 / wallNs << " ops/s, p99 "
+                  << all.percentile(0.99) << " ns\n";
+    }
+
+    bool contains(const std::vector<std::string>& list, const std::string& item)
+    {
+        return std::find(list.begin(), list.end(), item) != list.end();
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--workloads")        opt.workloads = bench::parseList(value);
+            else if (name == "--containers")  opt.containers = bench::parseList(value);
+            else if (name == "--threads")     opt.threads = bench::parseSizes(value);
+            else if (name == "--records")     opt.records = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--operations")  opt.operations = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--request-dist") opt.requestDist = value;
+            else if (name == "--format")      opt.format = value;
+            else if (name == "--out")         opt.out = value;
+            else
+                return false;
+        }
+        return opt.records > 0 && (opt.format == "csv" || opt.format == "json");
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--workloads=A,B,C,D,E,F] [--threads=1,2,4]\n"
+                  << "  [--containers=mystl::map+mutex,mystl::map+shared_mutex,std::map+mutex,std::map+shared_mutex]\n"
+                  << "  [--records=N] [--operations=N] [--request-dist=zipfian|latest|uniform]\n"
+                  << "  [--format=csv|json] [--out=FILE]\n";
+        return 1;
+    }
+
+    std::vector<bench::Result> results;
+    for (const auto& w : workloads)
+    {
+        if (!contains(opt.workloads, std::string(1, w.name)))
+            continue;
+        for (std::uint64_t threads : opt.threads)
+        {
+            if (threads == 0)
+                continue;
+            if (contains(opt.containers, "mystl::map+mutex"))
+                runWorkload<MutexMap<mystl::map<Key, Value>>>("mystl::map+mutex", w, threads, opt, results);
+            if (contains(opt.containers, "mystl::map+shared_mutex"))
+                runWorkload<SharedMutexMap<mystl::map<Key, Value>>>("mystl::map+shared_mutex", w, threads, opt, results);
+            if (contains(opt.containers, "std::map+mutex"))
+                runWorkload<MutexMap<std::map<Key, Value>>>("std::map+mutex", w, threads, opt, results);
+            if (contains(opt.containers, "std::map+shared_mutex"))
+                runWorkload<SharedMutexMap<std::map<Key, Value>>>("std::map+shared_mutex", w, threads, opt, results);
+        }
+    }
+
+    std::ofstream file;
+    if (!opt.out.empty())
+        file.open(opt.out);
+    std::ostream& os = opt.out.empty() ? std::cout : file;
+    if (opt.format == "json")
+        bench::writeJson(os, results);
+    else
+        bench::writeCsv(os, results);
+
+    return 0;
+}
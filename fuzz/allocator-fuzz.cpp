@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../include/arena.hpp"
+#include "../include/map.hpp"
+#include "../include/node-cache.hpp"
+#include "../bench/bench-common.hpp"
+
+/**
+ * Стресс-тест аллокаторов. Ошибки внутри блока арены AddressSanitizer не видит,
+ * поэтому каждое выделение заполняется своим байтом и в конце проверяется, что
+ * ни одно не затёрто соседним.
+ *
+ *   arena – случайные размеры и выравнивания (1..64) на маленьких блоках, где выравнивание
+ *           часто упирается в конец блока; затем mystl::map на arena_allocator вперемешку
+ *           с rebind-копиями для char и для выровненного по 32 типа;
+ *   node_cache – thread_cached_allocator в нескольких потоках: блоки освобождаются
+ *           в чужих потоках, потоки завершаются с неполными кэшами, а следующие потоки
+ *           забирают эти блоки из общего пула.
+ *
+ *   g++ -std=c++20 -O1 -g -fsanitize=address,undefined fuzz/allocator-fuzz.cpp -o allocator-fuzz
+ *   ./allocator-fuzz --iterations=200
+ */
+
+namespace {
+
+    struct Options
+    {
+        std::uint64_t seed = 1;
+        std::uint64_t iterations = 200;
+        std::vector<std::string> tests = {"arena", "node_cache"};
+    };
+
+    struct Block
+    {
+        unsigned char* p;
+        std::size_t bytes;
+        unsigned char fill;
+    };
+
+    bool checkBlocks(const std::vector<Block>& blocks, const char* what)
+    {
+        for (const auto& b : blocks)
+            for (std::size_t i = 0; i < b.bytes; ++i)
+                if (b.p[i] != b.fill)
+                {
+                    std::cerr << "FAIL " << what << ": block of " << b.bytes << " bytes overwritten at " << i << '\n';
+                    return false;
+                }
+        return true;
+    }
+
+    struct alignas(32) Wide
+    {
+        unsigned char bytes[32];
+    };
+
+    bool arenaRun(std::uint64_t seed)
+    {
+        bench::Random rng(seed);
+
+        // Сырые выделения: начальный блок 64 байта, чтобы конец блока встречался часто
+        mystl::arena raw(64, 4096);
+        std::vector<Block> blocks;
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::size_t align = std::size_t(1) << rng.next() % 7;
+            std::size_t bytes = 1 + rng.next() % 200;
+            auto* p = static_cast<unsigned char*>(raw.allocate(bytes, align));
+            if (reinterpret_cast<std::uintptr_t>(p) % align != 0)
+            {
+                std::cerr << "FAIL arena: misaligned block (align " << align << ")\n";
+                return false;
+            }
+            unsigned char fill = static_cast<unsigned char>(i);
+            std::memset(p, fill, bytes);
+            blocks.push_back({p, bytes, fill});
+        }
+        if (!checkBlocks(blocks, "arena"))
+            return false;
+
+        // Узлы карты вперемешку с rebind-копиями аллокатора для char и Wide
+        mystl::arena a(64, 4096);
+        using Alloc = mystl::arena_allocator<std::pair<const std::uint64_t, std::uint64_t>>;
+        mystl::map<std::uint64_t, std::uint64_t, std::less<std::uint64_t>, Alloc> m{Alloc(a)};
+        std::map<std::uint64_t, std::uint64_t> reference;
+        mystl::arena_allocator<char> chars(m.get_allocator());
+        mystl::arena_allocator<Wide> wides(m.get_allocator());
+        blocks.clear();
+        for (int i = 0; i < 2000; ++i)
+        {
+            std::uint64_t r = rng.next();
+            std::uint64_t key = r % 512;
+            m[key] = r;
+            reference[key] = r;
+
+            unsigned char fill = static_cast<unsigned char>(r >> 8);
+            if (r & 1)
+            {
+                std::size_t n = 1 + (r >> 16) % 61;
+                unsigned char* p = reinterpret_cast<unsigned char*>(chars.allocate(n));
+                std::memset(p, fill, n);
+                blocks.push_back({p, n, fill});
+            }
+            else
+            {
+                Wide* w = wides.allocate(1);
+                if (reinterpret_cast<std::uintptr_t>(w) % alignof(Wide) != 0)
+                {
+                    std::cerr << "FAIL arena_allocator: misaligned rebind allocation\n";
+                    return false;
+                }
+                std::memset(w->bytes, fill, sizeof(w->bytes));
+                blocks.push_back({w->bytes, sizeof(w->bytes), fill});
+            }
+        }
+        if (!checkBlocks(blocks, "arena_allocator"))
+            return false;
+        if (!m.validate() || !std::equal(m.begin(), m.end(), reference.begin(), reference.end(),
+                                         [](const auto& x, const auto& y) { return x.first == y.first && x.second == y.second; }))
+        {
+            std::cerr << "FAIL arena_allocator: map differs from std::map\n";
+            return false;
+        }
+        return true;
+    }
+
+    struct Payload
+    {
+        std::uint64_t words[3];
+    };
+
+    constexpr std::size_t cacheBatch = 64;
+    using CachedAlloc = mystl::thread_cached_allocator<Payload, cacheBatch>;
+
+    Payload* makePayload(CachedAlloc& alloc, std::uint64_t tag)
+    {
+        Payload* p = alloc.allocate(1);
+        for (auto& w : p->words)
+            w = tag;
+        return p;
+    }
+
+    bool intact(const Payload* p, std::uint64_t tag)
+    {
+        return p->words[0] == tag && p->words[1] == tag && p->words[2] == tag;
+    }
+
+    bool nodeCacheRun(std::uint64_t seed)
+    {
+        std::mutex mutex;
+        bool ok = true;
+        auto report = [&](const char* what)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (ok)
+                std::cerr << "FAIL node_cache: " << what << '\n';
+            ok = false;
+        };
+
+        // Поток завершается с кэшем не кратным пакету: 200 выделений, 100 освобождений.
+        // Следующий поток получает этот остаток из пула и освобождает блок.
+        std::vector<Payload*> survivors;
+        std::thread([&]
+        {
+            CachedAlloc alloc;
+            std::vector<Payload*> blocks;
+            for (std::uint64_t i = 0; i < 200; ++i)
+                blocks.push_back(makePayload(alloc, i));
+            for (std::size_t i = 0; i < 100; ++i)
+                alloc.deallocate(blocks[i], 1);
+            survivors.assign(blocks.begin() + 100, blocks.end());
+        }).join();
+        std::thread([&]
+        {
+            CachedAlloc alloc;
+            std::vector<Payload*> blocks;
+            for (std::uint64_t i = 0; i < 70; ++i)
+                blocks.push_back(makePayload(alloc, 1000 + i));
+            alloc.deallocate(blocks.back(), 1);
+            blocks.pop_back();
+            for (std::size_t i = 0; i < blocks.size(); ++i)
+                if (!intact(blocks[i], 1000 + i))
+                    report("block handed out twice");
+            for (Payload* p : blocks)
+                alloc.deallocate(p, 1);
+        }).join();
+        for (std::size_t i = 0; i < survivors.size(); ++i)
+            if (!intact(survivors[i], 100 + i))
+                report("live block overwritten");
+        CachedAlloc mainAlloc;
+        for (Payload* p : survivors)
+            mainAlloc.deallocate(p, 1);
+
+        // Потоки со случайным числом выделений; часть блоков освобождает соседний поток
+        constexpr int threadCount = 4;
+        std::vector<std::vector<std::pair<Payload*, std::uint64_t>>> handoff(threadCount);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t)
+            threads.emplace_back([&, t]
+            {
+                CachedAlloc alloc;
+                bench::Random rng(seed * threadCount + t);
+                std::vector<std::pair<Payload*, std::uint64_t>> live;
+                std::uint64_t ops = 500 + rng.next() % 3000;
+                for (std::uint64_t i = 0; i < ops; ++i)
+                {
+                    if (live.empty() || rng.next() % 3 != 0)
+                    {
+                        std::uint64_t tag = (static_cast<std::uint64_t>(t) << 32) | i;
+                        live.emplace_back(makePayload(alloc, tag), tag);
+                        continue;
+                    }
+                    std::size_t at = rng.next() % live.size();
+                    if (!intact(live[at].first, live[at].second))
+                        report("live block overwritten");
+                    alloc.deallocate(live[at].first, 1);
+                    live[at] = live.back();
+                    live.pop_back();
+                }
+                std::size_t keep = live.size() / 2;
+                for (std::size_t i = keep; i < live.size(); ++i)
+                    alloc.deallocate(live[i].first, 1);
+                live.resize(keep);
+                std::lock_guard<std::mutex> lock(mutex);
+                handoff[(t + 1) % threadCount] = std::move(live);
+            });
+        for (auto& th : threads)
+            th.join();
+
+        threads.clear();
+        for (int t = 0; t < threadCount; ++t)
+            threads.emplace_back([&, t]
+            {
+                CachedAlloc alloc;
+                for (auto [p, tag] : handoff[t])
+                {
+                    if (!intact(p, tag))
+                        report("handed-off block overwritten");
+                    alloc.deallocate(p, 1);
+                }
+            });
+        for (auto& th : threads)
+            th.join();
+        return ok;
+    }
+
+    bool enabled(const Options& opt, const char* test)
+    {
+        return std::find(opt.tests.begin(), opt.tests.end(), test) != opt.tests.end();
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--seed")               opt.seed = std::stoull(value);
+            else if (name == "--iterations")    opt.iterations = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--tests")         opt.tests = bench::parseList(value);
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--seed=N] [--iterations=N] [--tests=arena,node_cache]\n";
+        return 1;
+    }
+
+    for (std::uint64_t iter = 0; iter < opt.iterations; ++iter)
+    {
+        std::uint64_t seed = opt.seed + iter;
+        if ((enabled(opt, "arena") && !arenaRun(seed)) || (enabled(opt, "node_cache") && !nodeCacheRun(seed)))
+        {
+            std::cerr << "seed=" << seed << '\n';
+            return 1;
+        }
+    }
+    std::cerr << "OK: " << opt.iterations << " iterations\n";
+    return 0;
+}
@@ -0,0 +1,742 @@
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "../include/adaptive-map.hpp"
+#include "../include/flat-map.hpp"
+#include "../include/interned-map.hpp"
+#include "../include/keyed-set.hpp"
+#include "../include/map.hpp"
+#include "../include/radix-map.hpp"
+#include "../include/small-map.hpp"
+#include "../include/string-btree-map.hpp"
+#include "../bench/bench-common.hpp"
+
+/**
+ * Дифференциальное fuzz-тестирование контейнеров mystl против std::map<int, int>.
+ *
+ * Одна и та же последовательность операций применяется к проверяемому контейнеру
+ * (--backend) и к std::map; после каждого шага сравниваются результат операции,
+ * размер, содержимое и validate(), если он есть. При расхождении печатается номер
+ * шага и операция. Операции, которых у контейнера нет (extract, erase_if и т.д.),
+ * выражаются через остальные, так что результат сравним с std::map.
+ *
+ * Режимы:
+ *   - libFuzzer: -DMYSTL_LIBFUZZER -fsanitize=fuzzer (входные байты – операции);
+ *   - автономный: случайные последовательности по seed (по умолчанию), --backend=all
+ *     прогоняет все контейнеры;
+ *   - --perf: скорость операций mystl::map относительно std::map на фиксированной
+ *     последовательности; --save-baseline=FILE сохраняет её, --baseline=FILE
+ *     сравнивает с сохранённой и завершается с кодом 2 при регрессии больше --threshold.
+ */
+
+namespace {
+
+    enum OpCode : std::uint8_t
+    {
+        Insert, Subscript, InsertOrAssign, TryEmplace, EraseKey, EraseIterator, Find, Count,
+        LowerBound, UpperBound, At, Extract, EqualRange, EraseIf, ReverseScan, PrefixCount, Clear, CopyRoundTrip,
+        PrefixErase, Compact, Reserve, ShrinkToFit, OpCount
+    };
+
+    const char* opName(int op)
+    {
+        static const char* names[] = {"insert", "subscript", "insert_or_assign", "try_emplace", "erase_key",
+                                      "erase_iterator", "find", "count", "lower_bound", "upper_bound", "at",
+                                      "extract", "equal_range", "erase_if", "reverse_scan", "prefix_count", "clear",
+                                      "copy_round_trip", "erase_prefix", "compact", "reserve",
+                                      "shrink_to_fit"};
+        return names[op];
+    }
+
+    struct Step
+    {
+        OpCode op;
+        int key;
+        int value;
+    };
+
+    // Три байта на шаг; clear, копирование, удаление по префиксу и операции с памятью узлов
+    // редкие, чтобы карты успевали вырасти
+    Step decode(std::uint8_t opByte, std::uint8_t keyByte, std::uint8_t valueByte, int keyRange)
+    {
+        OpCode op;
+        if (opByte == 255)
+            op = Clear;
+        else if (opByte == 254)
+            op = CopyRoundTrip;
+        else if (opByte == 253)
+            op = PrefixErase;
+        else if (opByte == 252)
+            op = Compact;
+        else if (opByte == 251)
+            op = Reserve;
+        else if (opByte == 250)
+            op = ShrinkToFit;
+        else
+            op = static_cast<OpCode>(opByte % Clear);
+        int key = static_cast<int>((static_cast<unsigned>(keyByte) * 2654435761u + valueByte) % static_cast<unsigned>(keyRange));
+        return {op, key, valueByte};
+    }
+
+    /**
+     * Ключ шага (int) в ключ контейнера и обратно. Порядок ключей контейнера совпадает
+     * с порядком чисел, поэтому lower_bound и обход сравнимы с std::map<int, int>.
+     */
+    template <typename Key>
+    struct KeyCodec;
+
+    // Ключи группы g – [g * keyGroup, (g + 1) * keyGroup); у строковых ключей группа – общий префикс
+    constexpr int keyGroup = 64;
+
+    template <>
+    struct KeyCodec<int>
+    {
+        static int encode(int key) { return key; }
+        static int decode(int key) { return key; }
+    };
+
+    /**
+     * Строковые ключи вида /tNNN/bucket-with-a-long-shared-prefix/object-NNNNNN:
+     * номер арендатора – key / keyGroup, номер объекта – сам key (ширина фиксирована, так что
+     * порядок строк совпадает с порядком чисел). Ключи одного арендатора делят начало
+     * длиннее 40 байт – больше max_prefix узла radix_map (10 байт); первые 8 байт
+     * различаются между арендаторами, так что CachedKeyPrefix проходит обе ветви сравнения.
+     */
+    template <>
+    struct KeyCodec<std::string>
+    {
+        static std::string encode(int key)
+        {
+            char buf[80];
+            std::snprintf(buf, sizeof(buf), "/t%03d/bucket-with-a-long-shared-prefix/object-%06d", key / keyGroup, key);
+            return buf;
+        }
+
+        // Общий префикс ключей группы
+        static std::string prefix(int group)
+        {
+            char buf[16];
+            std::snprintf(buf, sizeof(buf), "/t%03d/", group);
+            return buf;
+        }
+
+        static int decode(std::string_view key) { return std::stoi(std::string(key.substr(key.size() - 6))); }
+    };
+
+    // Ключи interned_map – те же строки, decode получает их как string_view
+    template <>
+    struct KeyCodec<mystl::interned_key> : KeyCodec<std::string> {};
+
+    template <typename Map>
+    using codec_of = KeyCodec<typename Map::key_type>;
+
+    // Ключ и значение элемента: пара у карт, проекция и поле value у keyed_set
+    template <typename Map>
+    int keyOf(const Map& m, const auto& kv)
+    {
+        if constexpr (requires { kv.first; })
+            return codec_of<Map>::decode(kv.first);
+        else
+            return codec_of<Map>::decode(m.key_extract()(kv));
+    }
+
+    template <typename Map>
+    int valueOf(const Map&, const auto& kv)
+    {
+        if constexpr (requires { kv.second; })
+            return kv.second;
+        else
+            return kv.value;
+    }
+
+    /**
+     * Операции, которые есть не у всех контейнеров: если метода нет, он выражается
+     * через find, insert и erase. Элементы keyed_set неизменяемы, поэтому запись
+     * значения в нём – удаление и повторная вставка.
+     */
+    template <typename Map, typename K>
+    void assign(Map& m, const K& key, int value)
+    {
+        auto it = m.find(key);
+        if (it != m.end())
+            m.erase(it);
+        m.insert({key, value});
+    }
+
+    template <typename Map, typename K>
+    std::int64_t subscriptAdd(Map& m, const K& key, int delta)
+    {
+        if constexpr (requires { m[key]; })
+            return m[key] += delta;
+        else
+        {
+            auto it = m.find(key);
+            int value = (it == m.end() ? 0 : valueOf(m, *it)) + delta;
+            assign(m, key, value);
+            return value;
+        }
+    }
+
+    template <typename Map, typename K>
+    void insertOrAssign(Map& m, const K& key, int value)
+    {
+        if constexpr (requires { m.insert_or_assign(key, value); })
+            m.insert_or_assign(key, value);
+        else
+            assign(m, key, value);
+    }
+
+    template <typename Map, typename K>
+    bool tryEmplace(Map& m, const K& key, int value)
+    {
+        if constexpr (requires { m.try_emplace(key, value); })
+            return m.try_emplace(key, value).second;
+        else
+            return m.insert({key, value}).second;
+    }
+
+    template <typename Map, typename K>
+    std::int64_t at(Map& m, const K& key)
+    {
+        if constexpr (requires { m.at(key); })
+        {
+            try {
+                return m.at(key);
+            } catch (const std::out_of_range&) {
+                return -1;
+            }
+        }
+        else
+        {
+            auto it = m.find(key);
+            return it == m.end() ? -1 : valueOf(m, *it);
+        }
+    }
+
+    template <typename Map, typename K>
+    std::int64_t extract(Map& m, const K& key)
+    {
+        auto it = m.find(key);
+        if (it == m.end())
+            return -1;
+        if constexpr (requires { m.extract(key).mapped(); })
+            return m.extract(key).mapped();
+        else if constexpr (requires { m.extract(key); })
+            return valueOf(m, m.extract(key));
+        else
+        {
+            std::int64_t value = valueOf(m, *it);
+            m.erase(it);
+            return value;
+        }
+    }
+
+    template <typename Map, typename K>
+    std::int64_t equalRange(Map& m, const K& key)
+    {
+        std::int64_t n = 0;
+        if constexpr (requires { m.equal_range(key); })
+        {
+            auto [first, last] = m.equal_range(key);
+            for (; first != last; ++first)
+                ++n;
+        }
+        else
+        {
+            for (auto first = m.lower_bound(key), last = m.upper_bound(key); first != last; ++first)
+                ++n;
+        }
+        return n;
+    }
+
+    template <typename Map, typename Pred>
+    std::int64_t eraseIf(Map& m, Pred pred)
+    {
+        if constexpr (requires { std::erase_if(m, pred); })
+            return static_cast<std::int64_t>(std::erase_if(m, pred));
+        else if constexpr (requires { m.erase_if(pred); })
+            return static_cast<std::int64_t>(m.erase_if(pred));
+        else
+        {
+            std::int64_t removed = 0;
+            for (auto it = m.begin(); it != m.end(); )
+            {
+                if (pred(*it))
+                {
+                    it = m.erase(it);
+                    ++removed;
+                }
+                else
+                    ++it;
+            }
+            return removed;
+        }
+    }
+
+    // Число ключей группы: prefix_range, если он есть, иначе обход от lower_bound
+    template <typename Map>
+    std::int64_t prefixCount(Map& m, int group)
+    {
+        std::int64_t n = 0;
+        if constexpr (requires { m.prefix_range(std::string_view()); })
+        {
+            auto [first, last] = m.prefix_range(codec_of<Map>::prefix(group));
+            for (; first != last; ++first)
+                ++n;
+        }
+        else
+        {
+            auto it = m.lower_bound(codec_of<Map>::encode(group * keyGroup));
+            for (; it != m.end() && keyOf(m, *it) < (group + 1) * keyGroup; ++it)
+                ++n;
+        }
+        return n;
+    }
+
+    template <typename Map>
+    std::int64_t erasePrefix(Map& m, int group)
+    {
+        if constexpr (requires { m.erase_prefix(std::string_view()); })
+            return static_cast<std::int64_t>(m.erase_prefix(codec_of<Map>::prefix(group)));
+        else
+        {
+            std::int64_t removed = 0;
+            auto it = m.lower_bound(codec_of<Map>::encode(group * keyGroup));
+            while (it != m.end() && keyOf(m, *it) < (group + 1) * keyGroup)
+            {
+                it = m.erase(it);
+                ++removed;
+            }
+            return removed;
+        }
+    }
+
+    // Переупаковка узлов или ключей, если контейнер её умеет; порядок узлов – по чётности value
+    template <typename Map>
+    void compact(Map& m, int value)
+    {
+        if constexpr (requires { m.compact(CompactOrder::DepthFirst); })
+            m.compact(value % 2 ? CompactOrder::DepthFirst : CompactOrder::VanEmdeBoas);
+        else if constexpr (requires { m.compact(); })
+            m.compact();
+    }
+
+    /**
+     * Выполняет шаг и возвращает наблюдаемый результат, одинаковый для корректных реализаций.
+     */
+    template <typename Map>
+    std::int64_t apply(Map& m, const Step& s)
+    {
+        const auto key = codec_of<Map>::encode(s.key);
+        auto keyAt = [&](auto it) -> std::int64_t { return it == m.end() ? -1 : keyOf(m, *it); };
+        switch (s.op)
+        {
+            case Insert:
+                m.insert({key, s.value});
+                return 0;
+            case Subscript:
+                return subscriptAdd(m, key, s.value);
+            case InsertOrAssign:
+                insertOrAssign(m, key, s.value);
+                return 0;
+            case TryEmplace:
+                return tryEmplace(m, key, s.value);
+            case EraseKey:
+            {
+                // mystl::map::erase печатает в stderr при отсутствии ключа – не зовём его зря.
+                // end() берётся после find: find у adaptive_map может сменить представление.
+                auto it = m.find(key);
+                bool present = it != m.end();
+                if (present)
+                    m.erase(key);
+                return present;
+            }
+            case EraseIterator:
+            {
+                auto it = m.lower_bound(key);
+                if (it == m.end())
+                    return -1;
+                return keyAt(m.erase(it));
+            }
+            case Find:
+            {
+                auto it = m.find(key);
+                return it == m.end() ? -1 : valueOf(m, *it);
+            }
+            case Count:
+                return static_cast<std::int64_t>(m.count(key));
+            case LowerBound:
+                return keyAt(m.lower_bound(key));
+            case UpperBound:
+                return keyAt(m.upper_bound(key));
+            case At:
+                return at(m, key);
+            case Extract:
+                return extract(m, key);
+            case EqualRange:
+                return equalRange(m, key);
+            case EraseIf:
+                return eraseIf(m, [&](const auto& kv) { return (keyOf(m, kv) + valueOf(m, kv)) % 7 == s.value % 7; });
+            case ReverseScan:
+            {
+                // Первые value % 32 + 1 элементов с конца, свёрнутые в одно число
+                std::uint64_t hash = 0;
+                int left = s.value % 32 + 1;
+                for (auto it = m.rbegin(); it != m.rend() && left > 0; ++it, --left)
+                    hash = hash * 1000003 + static_cast<std::uint64_t>(keyOf(m, *it) * 31 + valueOf(m, *it));
+                return static_cast<std::int64_t>(hash);
+            }
+            case PrefixCount:
+                return prefixCount(m, s.key / keyGroup);
+            case Clear:
+                m.clear();
+                return 0;
+            case CopyRoundTrip:
+            {
+                Map copy(m);
+                Map moved(std::move(copy));
+                m = moved;
+                return static_cast<std::int64_t>(m.size());
+            }
+            case PrefixErase:
+                return erasePrefix(m, s.key / keyGroup);
+            case Compact:
+                compact(m, s.value);
+                return static_cast<std::int64_t>(m.size());
+            case Reserve:
+                // Запас на value вставок: часть следующих узлов придёт из зарезервированного блока
+                if constexpr (requires { m.reserve(m.size()); })
+                    m.reserve(m.size() + static_cast<std::size_t>(s.value));
+                return static_cast<std::int64_t>(m.size());
+            case ShrinkToFit:
+                if constexpr (requires { m.shrink_to_fit(); })
+                    m.shrink_to_fit();
+                return static_cast<std::int64_t>(m.size());
+            case OpCount:
+                break;
+        }
+        return 0;
+    }
+
+    template <typename Subject>
+    struct Differential
+    {
+        Subject subject;
+        std::map<int, int> reference;
+        std::string error;
+
+        bool step(const Step& s)
+        {
+            std::int64_t got = apply(subject, s);
+            std::int64_t expected = apply(reference, s);
+            if (got != expected)
+                return fail(s, "result " + std::to_string(got) + " != " + std::to_string(expected));
+            if (subject.size() != reference.size())
+                return fail(s, "size " + std::to_string(subject.size()) + " != " + std::to_string(reference.size()));
+            if (!std::equal(subject.begin(), subject.end(), reference.begin(), reference.end(),
+                            [&](const auto& a, const auto& b) { return keyOf(subject, a) == b.first && valueOf(subject, a) == b.second; }))
+                return fail(s, "contents differ");
+            if constexpr (requires { subject.validate(); })
+                if (!subject.validate())
+                    return fail(s, "invariants violated");
+            return true;
+        }
+
+        bool fail(const Step& s, const std::string& what)
+        {
+            error = std::string(opName(s.op)) + "(" + std::to_string(s.key) + ", " + std::to_string(s.value) + "): " + what;
+            return false;
+        }
+    };
+
+    /**
+     * Проверяемые контейнеры: имя для --backend и тип. Все хранят int-значения;
+     * ключи – int или строки из KeyCodec. keyRange, если не 0, ограничивает --key-range,
+     * чтобы контейнер чаще переходил между режимами.
+     */
+    template <typename Map>
+    struct Backend
+    {
+        const char* name;
+        int keyRange = 0;
+    };
+
+    // adaptive_map, которая замораживается в окне с любой долей записей и размораживается,
+    // когда записей больше половины: на смеси операций fuzz-теста представление меняется часто
+    struct restless_adaptive_map : mystl::adaptive_map<int, int, 8>
+    {
+        restless_adaptive_map() { set_thresholds(1, 2); }
+    };
+
+    // interned_map, которая перестраивает арену ключей, как только удалённые ключи займут
+    // четверть живых (и не меньше min_compaction_bytes): compact() случается в каждой последовательности
+    struct compacting_interned_map : mystl::interned_map<int>
+    {
+        compacting_interned_map() { set_compaction_ratio(0.25); }
+    };
+
+    // Запись keyed_set: ключ – поле самой записи
+    struct Entry
+    {
+        int key;
+        int value;
+    };
+
+    template <typename Visit>
+    bool forEachBackend(Visit&& visit)
+    {
+        return visit(Backend<mystl::map<int, int>>{"map"})
+            // 16 ключей на встроенную ёмкость 8: карта то переходит в дерево, то возвращается после clear
+            && visit(Backend<mystl::small_map<int, int, 8>>{"small_map", 16})
+            && visit(Backend<mystl::flat_map<int, int>>{"flat_map"})
+            && visit(Backend<restless_adaptive_map>{"adaptive_map"})
+            && visit(Backend<mystl::radix_map<int, int>>{"radix_map_int"})
+            && visit(Backend<mystl::radix_map<std::string, int>>{"radix_map"})
+            && visit(Backend<mystl::map<std::string, int, std::less<std::string>,
+                                        std::allocator<std::pair<const std::string, int>>,
+                                        NullTreeStats, CachedKeyPrefix>>{"map_key_prefix"})
+            // Листы по 4 записи: разбиения, слияния и граничные листы erase_prefix на каждом шаге
+            && visit(Backend<mystl::string_btree_map<int, 4>>{"string_btree_map"})
+            && visit(Backend<compacting_interned_map>{"interned_map"})
+            // Строковый ключ: копия ключа в узле и пара вне узла владеют своей памятью
+            && visit(Backend<mystl::map<std::string, int, std::less<std::string>,
+                                        std::allocator<std::pair<const std::string, int>>,
+                                        NullTreeStats, OutOfLineValues>>{"map_out_of_line"})
+            && visit(Backend<mystl::keyed_set<Entry, mystl::key_member<&Entry::key>>>{"keyed_set"});
+    }
+
+    struct Options
+    {
+        std::uint64_t seed = 1;
+        std::uint64_t iterations = 1000;
+        std::uint64_t steps = 2000;
+        int keyRange = 256;
+        std::vector<std::string> backends = {"all"};
+        std::vector<std::string> ops;   // пусто – все операции
+        bool perf = false;
+        std::uint64_t perfOps = 2000000;
+        std::string saveBaseline;
+        std::string baseline;
+        double threshold = 0.10;
+    };
+
+    bool enabled(const Options& opt, OpCode op)
+    {
+        return opt.ops.empty() || std::find(opt.ops.begin(), opt.ops.end(), opName(op)) != opt.ops.end();
+    }
+
+    std::vector<Step> makeSteps(const Options& opt, std::uint64_t seed, std::uint64_t count, int keyRange)
+    {
+        bench::Random rng(seed);
+        std::vector<Step> steps;
+        steps.reserve(count);
+        while (steps.size() < count)
+        {
+            std::uint64_t r = rng.next();
+            Step s = decode(static_cast<std::uint8_t>(r), static_cast<std::uint8_t>(r >> 8),
+                            static_cast<std::uint8_t>(r >> 16), keyRange);
+            s.key = static_cast<int>((r >> 24) % static_cast<std::uint64_t>(keyRange));
+            if (enabled(opt, s.op))
+                steps.push_back(s);
+        }
+        return steps;
+    }
+
+    bool selected(const Options& opt, const char* backend)
+    {
+        return std::find(opt.backends.begin(), opt.backends.end(), "all") != opt.backends.end()
+               || std::find(opt.backends.begin(), opt.backends.end(), backend) != opt.backends.end();
+    }
+
+    template <typename Map>
+    bool runBackend(const Options& opt, Backend<Map> backend)
+    {
+        const char* name = backend.name;
+        int keyRange = backend.keyRange ? std::min(backend.keyRange, opt.keyRange) : opt.keyRange;
+        for (std::uint64_t iter = 0; iter < opt.iterations; ++iter)
+        {
+            std::uint64_t seed = opt.seed + iter;
+            Differential<Map> d;
+            auto steps = makeSteps(opt, seed, opt.steps, keyRange);
+            for (std::size_t i = 0; i < steps.size(); ++i)
+            {
+                if (!d.step(steps[i]))
+                {
+                    std::cerr << "FAIL backend=" << name << " seed=" << seed << " step=" << i << ": " << d.error << '\n';
+                    return false;
+                }
+            }
+        }
+        std::cerr << "OK " << name << ": " << opt.iterations << " sequences x " << opt.steps << " steps\n";
+        return true;
+    }
+
+    int runDifferential(const Options& opt)
+    {
+        int ran = 0;
+        bool ok = forEachBackend([&]<typename Map>(Backend<Map> backend)
+        {
+            if (!selected(opt, backend.name))
+                return true;
+            ++ran;
+            return runBackend(opt, backend);
+        });
+        if (ran == 0)
+        {
+            std::cerr << "No backend matches --backend\n";
+            return 1;
+        }
+        return ok ? 0 : 1;
+    }
+
+    template <typename Map>
+    double opsPerSecond(const std::vector<Step>& steps)
+    {
+        std::vector<double> samples;
+        for (int rep = 0; rep < 5; ++rep)
+        {
+            Map m;
+            std::int64_t sink = 0;
+            bench::Timer t;
+            for (const auto& s : steps)
+                sink += apply(m, s);
+            samples.push_back(static_cast<double>(steps.size()) * 1e9 / t.elapsedNs());
+            bench::doNotOptimize(sink);
+        }
+        std::sort(samples.begin(), samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    // Файл базовой линии: строки "имя значение"
+    bool readBaseline(const std::string& path, double& ratio)
+    {
+        std::ifstream in(path);
+        std::string name;
+        double value = 0.0;
+        while (in >> name >> value)
+            if (name == "ratio_vs_std_map")
+            {
+                ratio = value;
+                return true;
+            }
+        return false;
+    }
+
+    int runPerf(const Options& opt)
+    {
+        // Без clear и копирования: последовательность должна поддерживать крупную карту
+        Options perfOpt = opt;
+        if (perfOpt.ops.empty())
+            for (int op = 0; op < Clear; ++op)
+                perfOpt.ops.push_back(opName(op));
+        auto steps = makeSteps(perfOpt, opt.seed, opt.perfOps, 1 << 16);
+
+        double subject = opsPerSecond<mystl::map<int, int>>(steps);
+        double reference = opsPerSecond<std::map<int, int>>(steps);
+        double ratio = subject / reference;
+        std::printf("mystl_ops_per_sec %.0f\nstd_ops_per_sec %.0f\nratio_vs_std_map %.4f\n", subject, reference, ratio);
+
+        if (!opt.saveBaseline.empty())
+        {
+            std::ofstream out(opt.saveBaseline);
+            out << "mystl_ops_per_sec " << subject << "\nstd_ops_per_sec " << reference
+                << "\nratio_vs_std_map " << ratio << '\n';
+        }
+
+        if (!opt.baseline.empty())
+        {
+            double base = 0.0;
+            if (!readBaseline(opt.baseline, base))
+            {
+                std::cerr << "Cannot read baseline " << opt.baseline << '\n';
+                return 1;
+            }
+            // Сравниваем отношение к std::map из того же запуска: оно устойчивее к смене машины
+            double change = ratio / base - 1.0;
+            std::printf("baseline_ratio %.4f\nchange %+.2f%%\n", base, change * 100.0);
+            if (change < -opt.threshold)
+            {
+                std::cerr << "REGRESSION: throughput ratio dropped by " << -change * 100.0
+                          << "% (threshold " << opt.threshold * 100.0 << "%)\n";
+                return 2;
+            }
+        }
+        return 0;
+    }
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string arg = argv[i];
+            auto eq = arg.find('=');
+            std::string name = arg.substr(0, eq);
+            std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+            if (name == "--seed")                 opt.seed = std::stoull(value);
+            else if (name == "--iterations")      opt.iterations = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--steps")           opt.steps = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--key-range")       opt.keyRange = std::max(1, std::stoi(value));
+            else if (name == "--backend")         opt.backends = bench::parseList(value);
+            else if (name == "--ops")             opt.ops = bench::parseList(value);
+            else if (name == "--perf")            opt.perf = true;
+            else if (name == "--perf-ops")        opt.perfOps = static_cast<std::uint64_t>(std::stod(value));
+            else if (name == "--save-baseline")   opt.saveBaseline = value;
+            else if (name == "--baseline")        opt.baseline = value;
+            else if (name == "--threshold")       opt.threshold = std::stod(value);
+            else
+                return false;
+        }
+        return true;
+    }
+
+} // namespace
+
+#ifdef MYSTL_LIBFUZZER
+
+// Каждый вход прогоняется на всех контейнерах
+extern "C" int LLVMFuzzerTestOneInput(const std::uint8_t* data, std::size_t size)
+{
+    forEachBackend([&]<typename Map>(Backend<Map> backend)
+    {
+        Differential<Map> d;
+        for (std::size_t i = 0; i + 3 <= size; i += 3)
+        {
+            if (!d.step(decode(data[i], data[i + 1], data[i + 2], 256)))
+            {
+                std::fprintf(stderr, "FAIL backend=%s at byte %zu: %s\n", backend.name, i, d.error.c_str());
+                std::abort();
+            }
+        }
+        return true;
+    });
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt))
+    {
+        std::cerr << "Usage: " << argv[0] << " [--seed=N] [--iterations=N] [--steps=N] [--key-range=N] [--ops=a,b,...]"
+                  << " [--backend=all|map|...]\n"
+                  << "       " << argv[0] << " --perf [--perf-ops=N] [--save-baseline=FILE]"
+                  << " [--baseline=FILE] [--threshold=0.10]\n";
+        return 1;
+    }
+    return opt.perf ? runPerf(opt) : runDifferential(opt);
+}
+
+#endif
@@ -0,0 +1,488 @@
+#ifndef ADAPTIVE_MAP_HPP
+#define ADAPTIVE_MAP_HPP
+
+#include "flat-map.hpp"
+#include "small-map.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace mystl {
+
+    /**
+     * Представление adaptive_map в данный момент.
+     */
+    enum class map_representation
+    {
+        inline_array,   // до N элементов внутри объекта (small_map без дерева)
+        tree,           // красно-чёрное дерево (small_map, перенесённый в mystl::map)
+        frozen          // отсортированные массивы (flat_map) для фазы «только чтение»
+    };
+
+    /**
+     * Карта, которая сама выбирает представление по размеру и доле записей:
+     *
+     *   - не больше N элементов – встроенный массив;
+     *   - окно операций почти без записей (доля < 1/freeze_ratio) – «заморозка»
+     *     в flat_map: поиск по плотному массиву ключей;
+     *   - в замороженной карте доля записей выросла (> 1/thaw_ratio) – обратно в дерево,
+     *     пока одиночные вставки в массив не стали дорогими.
+     *
+     * Окно не короче половины размера карты, поэтому O(n) на перестройку
+     * распределяется по O(n) операциям – амортизированно O(1) на операцию.
+     *
+     * Операции считаются и представление меняется только в неконстантных методах
+     * (find, at, operator[], bounds, вставки, удаления): константные методы ничего
+     * не меняют, и одновременное чтение из нескольких потоков безопасно. Смена
+     * представления делает итераторы недействительными, поэтому итераторы,
+     * полученные от карты, действительны только до следующего неконстантного вызова.
+     * Исключение – erase(pos) и emplace_hint: они считаются, но представление не меняют.
+     */
+    template <typename Key, typename T, std::size_t N = 16,
+              typename Compare = std::less<Key>,
+              typename Allocator = std::allocator<std::pair<const Key, T>>>
+    class adaptive_map
+    {
+    private:
+        using small_type = small_map<Key, T, N, Compare, Allocator>;
+        using flat_type = flat_map<Key, T, Compare, Allocator>;
+
+    public:
+        using key_type        = Key;
+        using mapped_type     = T;
+        using value_type      = std::pair<const Key, T>;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using key_compare     = Compare;
+        using allocator_type  = Allocator;
+        using reference       = std::pair<const Key&, T&>;
+        using const_reference = std::pair<const Key&, const T&>;
+
+        /**
+         * Итератор – вариант из итератора small_map и итератора flat_map.
+         * *it возвращает прокси-пару ссылок, как у flat_map.
+         */
+        template <bool Const>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = std::pair<const Key, T>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::conditional_t<Const, std::pair<const Key&, const T&>, std::pair<const Key&, T&>>;
+            using small_iterator    = std::conditional_t<Const, typename small_type::const_iterator, typename small_type::iterator>;
+            using flat_iterator     = std::conditional_t<Const, typename flat_type::const_iterator, typename flat_type::iterator>;
+
+            struct pointer
+            {
+                reference ref;
+                const reference* operator->() const { return &ref; }
+            };
+
+            std::variant<small_iterator, flat_iterator> pos;
+
+            basic_iterator() = default;
+            basic_iterator(small_iterator it) : pos(it) {}
+            basic_iterator(flat_iterator it) : pos(it) {}
+
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other)
+            {
+                if (auto small = std::get_if<0>(&other.pos))
+                    pos = small_iterator(*small);
+                else
+                    pos = flat_iterator(std::get<1>(other.pos));
+            }
+
+            reference operator*() const
+            {
+                return std::visit([](const auto& it) { auto&& kv = *it; return reference(kv.first, kv.second); }, pos);
+            }
+
+            pointer operator->() const { return pointer{**this}; }
+
+            basic_iterator& operator++()
+            {
+                std::visit([](auto& it) { ++it; }, pos);
+                return *this;
+            }
+
+            basic_iterator& operator--()
+            {
+                std::visit([](auto& it) { --it; }, pos);
+                return *this;
+            }
+
+            basic_iterator operator++(int) { basic_iterator tmp(*this); ++(*this); return tmp; }
+            basic_iterator operator--(int) { basic_iterator tmp(*this); --(*this); return tmp; }
+
+            bool operator==(const basic_iterator& other) const { return pos == other.pos; }
+            bool operator!=(const basic_iterator& other) const { return !(*this == other); }
+        };
+
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        adaptive_map() = default;
+
+        explicit adaptive_map(const Compare& comp, const Allocator& alloc = Allocator())
+            : rep(std::in_place_index<0>, comp, alloc), comp(comp), alloc(alloc) {}
+
+        adaptive_map(std::initializer_list<value_type> init,
+                     const Compare& comp = Compare(),
+                     const Allocator& alloc = Allocator())
+            : adaptive_map(comp, alloc)
+        {
+            insert_range(init.begin(), init.end());
+        }
+
+        // -- ИТЕРАТОРЫ --
+
+        iterator begin() { return visit([](auto& m) { return iterator(m.begin()); }); }
+        iterator end()   { return visit([](auto& m) { return iterator(m.end()); }); }
+
+        const_iterator begin() const { return visit([](const auto& m) { return const_iterator(m.begin()); }); }
+        const_iterator end() const   { return visit([](const auto& m) { return const_iterator(m.end()); }); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const   { return end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const   { return rend(); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return size() == 0; }
+
+        size_type size() const { return visit([](const auto& m) { return m.size(); }); }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max(); }
+
+        // -- ПРЕДСТАВЛЕНИЕ --
+
+        map_representation representation() const
+        {
+            if (rep.index() == 1)
+                return map_representation::frozen;
+            return std::get<0>(rep).is_inline() ? map_representation::inline_array : map_representation::tree;
+        }
+
+        // Автоматическая смена представления (по умолчанию включена)
+        void set_adaptive(bool enabled) { adaptive = enabled; }
+        bool is_adaptive() const { return adaptive; }
+
+        // Ручная смена представления; работает и при выключенной адаптации
+        void freeze()
+        {
+            if (rep.index() == 1)
+                return;
+            flat_type frozen(comp, alloc);
+            frozen.reserve(size());
+            auto& small = std::get<0>(rep);
+            frozen.insert_range(small.begin(), small.end());
+            rep.template emplace<1>(std::move(frozen));
+            ++conversion_count;
+        }
+
+        void thaw()
+        {
+            if (rep.index() == 0)
+                return;
+            small_type thawed(comp, alloc);
+            auto& frozen = std::get<1>(rep);
+            for (auto it = frozen.begin(); it != frozen.end(); ++it)
+                thawed.emplace_hint(thawed.end(), value_type(it->first, std::move(it->second)));
+            rep.template emplace<0>(std::move(thawed));
+            ++conversion_count;
+        }
+
+        // Сколько раз менялось представление
+        std::uint64_t conversions() const { return conversion_count; }
+
+        // Доли записей, при которых карта замораживается (< 1/freeze_ratio) и размораживается (> 1/thaw_ratio)
+        void set_thresholds(std::uint32_t freeze_ratio, std::uint32_t thaw_ratio)
+        {
+            freeze_den = std::max<std::uint32_t>(freeze_ratio, 1);
+            thaw_den = std::max<std::uint32_t>(thaw_ratio, 1);
+        }
+
+        // -- ОПЕРАЦИИ ДОСТУПА --
+
+        mapped_type& operator[](const key_type& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& at(const key_type& key)
+        {
+            before(read_op);
+            return visit([&](auto& m) -> mapped_type& { return m.at(key); });
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            return visit([&](const auto& m) -> const mapped_type& { return m.at(key); });
+        }
+
+        // -- МОДИФИКАЦИЯ --
+
+        void insert(const value_type& value) { try_emplace(value.first, value.second); }
+
+        void emplace(const key_type& key, const mapped_type& value) { try_emplace(key, value); }
+
+        template <typename InputIt>
+        void insert_range(InputIt first, InputIt last)
+        {
+            before(write_op);
+            visit([&](auto& m) { m.insert_range(first, last); });
+        }
+
+        void insert_or_assign(const key_type& key, const mapped_type& value)
+        {
+            before(write_op);
+            visit([&](auto& m) { m.insert_or_assign(key, value); });
+        }
+
+        iterator emplace_hint(const_iterator /*hint*/, const value_type& value)
+        {
+            ++writes;
+            return visit([&](auto& m) { return iterator(m.try_emplace(value.first, value.second).first); });
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            before(write_op);
+            return visit([&](auto& m)
+            {
+                auto result = m.try_emplace(key, std::forward<Args>(args)...);
+                return std::pair<iterator, bool>(iterator(result.first), result.second);
+            });
+        }
+
+        void erase(const key_type& key)
+        {
+            before(write_op);
+            visit([&](auto& m) { m.erase(key); });
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            ++writes;
+            if (rep.index() == 0)
+                return iterator(std::get<0>(rep).erase(std::get<0>(pos.pos)));
+            return iterator(std::get<1>(rep).erase(std::get<1>(pos.pos)));
+        }
+
+        iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+        template <typename Predicate>
+        size_type erase_if(Predicate pred)
+        {
+            before(write_op);
+            return visit([&](auto& m)
+            {
+                return m.erase_if([&](const auto& kv) { return pred(const_reference(kv.first, kv.second)); });
+            });
+        }
+
+        void clear()
+        {
+            rep.template emplace<0>(comp, alloc);
+            reads = writes = 0;
+        }
+
+        value_type extract(const key_type& key)
+        {
+            before(write_op);
+            return visit([&](auto& m)
+            {
+                auto kv = m.extract(key);
+                return value_type(std::move(kv.first), std::move(kv.second));
+            });
+        }
+
+        void merge(adaptive_map& source)
+        {
+            if (&source == this)
+                return;
+            before(write_op);
+            for (auto it = source.begin(); it != source.end(); )
+            {
+                if (visit([&](auto& m) { return m.try_emplace(it->first, it->second).second; }))
+                    it = source.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        void swap(adaptive_map& other)
+        {
+            std::swap(*this, other);
+        }
+
+        // -- ПОИСК --
+
+        iterator find(const key_type& key)
+        {
+            before(read_op);
+            return visit([&](auto& m) { return iterator(m.find(key)); });
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            return visit([&](const auto& m) { return const_iterator(m.find(key)); });
+        }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const
+        {
+            return visit([&](const auto& m) { return m.contains(key); });
+        }
+
+        iterator lower_bound(const key_type& key)
+        {
+            before(read_op);
+            return visit([&](auto& m) { return iterator(m.lower_bound(key)); });
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            return visit([&](const auto& m) { return const_iterator(m.lower_bound(key)); });
+        }
+
+        iterator upper_bound(const key_type& key)
+        {
+            before(read_op);
+            return visit([&](auto& m) { return iterator(m.upper_bound(key)); });
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            return visit([&](const auto& m) { return const_iterator(m.upper_bound(key)); });
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key)
+        {
+            before(read_op);
+            return visit([&](auto& m) { return std::pair<iterator, iterator>(m.lower_bound(key), m.upper_bound(key)); });
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        key_compare key_comp() const { return comp; }
+
+        friend bool operator==(const adaptive_map& lhs, const adaptive_map& rhs)
+        {
+            if (lhs.size() != rhs.size())
+                return false;
+            auto it2 = rhs.begin();
+            for (auto it1 = lhs.begin(); it1 != lhs.end(); ++it1, ++it2)
+                if ((*it1).first != (*it2).first || (*it1).second != (*it2).second)
+                    return false;
+            return true;
+        }
+
+        friend bool operator!=(const adaptive_map& lhs, const adaptive_map& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const adaptive_map& lhs, const adaptive_map& rhs)
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end(),
+                                                [](const auto& a, const auto& b)
+                                                {
+                                                    return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+                                                });
+        }
+        friend bool operator<=(const adaptive_map& lhs, const adaptive_map& rhs) { return !(rhs < lhs); }
+        friend bool operator>(const adaptive_map& lhs, const adaptive_map& rhs) { return rhs < lhs; }
+        friend bool operator>=(const adaptive_map& lhs, const adaptive_map& rhs) { return !(lhs < rhs); }
+
+    private:
+        enum op_kind { read_op, write_op };
+
+        template <typename F>
+        decltype(auto) visit(F&& f) { return std::visit(std::forward<F>(f), rep); }
+
+        template <typename F>
+        decltype(auto) visit(F&& f) const { return std::visit(std::forward<F>(f), rep); }
+
+        /**
+         * Учитывает операцию и, если пора, меняет представление – до того, как операция
+         * получит итераторы. Замороженная карта оттаивает сразу, как только записей
+         * в окне становится заметно много: каждая вставка в массив стоит O(n).
+         */
+        void before(op_kind kind)
+        {
+            if (kind == read_op)
+                ++reads;
+            else
+                ++writes;
+            if (!adaptive)
+                return;
+
+            std::uint64_t ops = reads + writes;
+            if (rep.index() == 1 && writes >= 4 && writes * thaw_den > ops)
+            {
+                thaw();
+                reads = writes = 0;
+                return;
+            }
+            if (ops < std::max<std::uint64_t>(min_window, size() / 2))
+                return;
+
+            size_type n = size();
+            if (rep.index() == 1)
+            {
+                if (n <= N)
+                    thaw();
+            }
+            else
+            {
+                auto& small = std::get<0>(rep);
+                if (!small.is_inline() && n <= N / 2)
+                {
+                    small.shrink_to_fit();
+                    ++conversion_count;
+                }
+                else if (!small.is_inline() && writes * freeze_den < ops)
+                    freeze();
+            }
+            reads = writes = 0;
+        }
+
+        static constexpr std::uint64_t min_window = 1024;
+
+        std::variant<small_type, flat_type> rep;
+        Compare comp;
+        Allocator alloc;
+        bool adaptive = true;
+        std::uint32_t freeze_den = 256;
+        std::uint32_t thaw_den = 32;
+        std::uint64_t reads = 0;
+        std::uint64_t writes = 0;
+        std::uint64_t conversion_count = 0;
+    };
+
+} // namespace mystl
+
+#endif // ADAPTIVE_MAP_HPP
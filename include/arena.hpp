@@ -0,0 +1,213 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace mystl {
+
+    /**
+     * Монотонная арена: память выдаётся сдвигом указателя внутри блоков, которые
+     * удваиваются от initial_chunk до max_chunk. Отдельные выделения не освобождаются –
+     * память возвращается только целиком (release) или сбросом (reset).
+     * Последнее выделение можно откатить (rollback), если сразу выяснилось, что оно не нужно.
+     */
+    class arena
+    {
+    public:
+        explicit arena(std::size_t initial_chunk = 4096, std::size_t max_chunk = std::size_t(1) << 20)
+            : next_chunk(std::max<std::size_t>(initial_chunk, 64)),
+              max_chunk(std::max(max_chunk, next_chunk)) {}
+
+        arena(const arena&) = delete;
+        arena& operator=(const arena&) = delete;
+
+        arena(arena&& other) noexcept { steal(other); }
+
+        arena& operator=(arena&& other) noexcept
+        {
+            if (this != &other)
+            {
+                release();
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~arena() { release(); }
+
+        void* allocate(std::size_t bytes, std::size_t align = alignof(std::max_align_t))
+        {
+            char* p = align_up(cur, align);
+            // Выравнивание может увести p за конец блока: сравниваем указатели до вычитания
+            if (!cur || p > end || static_cast<std::size_t>(end - p) < bytes)
+            {
+                add_chunk(bytes + align);
+                p = align_up(cur, align);
+            }
+            cur = p + bytes;
+            allocated += bytes;
+            return p;
+        }
+
+        // Возвращает bytes байт по адресу p, если это было последнее выделение
+        bool rollback(const void* p, std::size_t bytes) noexcept
+        {
+            if (!cur || static_cast<const char*>(p) + bytes != cur)
+                return false;
+            cur -= bytes;
+            allocated -= bytes;
+            return true;
+        }
+
+        // Освобождает все блоки, кроме последнего (самого большого), и начинает его заново
+        void reset() noexcept
+        {
+            if (!head)
+                return;
+            chunk_header* keep = head;
+            head = head->prev;
+            release();
+            keep->prev = nullptr;
+            head = keep;
+            chunks = 1;
+            reserved = keep->size;
+            cur = reinterpret_cast<char*>(keep + 1);
+            end = reinterpret_cast<char*>(keep) + keep->size;
+        }
+
+        void release() noexcept
+        {
+            while (head)
+            {
+                chunk_header* prev = head->prev;
+                ::operator delete(head);
+                head = prev;
+            }
+            cur = end = nullptr;
+            chunks = 0;
+            reserved = 0;
+            allocated = 0;
+        }
+
+        // Байты, взятые у системы (сумма размеров блоков)
+        std::size_t bytes_reserved() const noexcept { return reserved; }
+
+        // Байты, выданные через allocate (без выравнивания и хвостов блоков)
+        std::size_t bytes_allocated() const noexcept { return allocated; }
+
+        // Число блоков – столько раз арена обращалась к operator new
+        std::size_t chunk_count() const noexcept { return chunks; }
+
+    private:
+        struct alignas(std::max_align_t) chunk_header
+        {
+            chunk_header* prev;
+            std::size_t size;
+        };
+
+        chunk_header* head = nullptr;
+        char* cur = nullptr;
+        char* end = nullptr;
+        std::size_t next_chunk = 4096;
+        std::size_t max_chunk = std::size_t(1) << 20;
+        std::size_t chunks = 0;
+        std::size_t reserved = 0;
+        std::size_t allocated = 0;
+
+        static char* align_up(char* p, std::size_t align) noexcept
+        {
+            auto v = reinterpret_cast<std::uintptr_t>(p);
+            return reinterpret_cast<char*>((v + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+        }
+
+        // Новый блок не меньше need байт полезной памяти; хвост текущего блока пропадает.
+        // Размер кратен alignof(max_align_t), так что конец блока выровнен так же, как начало.
+        void add_chunk(std::size_t need)
+        {
+            constexpr std::size_t granule = alignof(std::max_align_t);
+            std::size_t size = (std::max(next_chunk, need + sizeof(chunk_header)) + granule - 1) & ~(granule - 1);
+            auto* chunk = static_cast<chunk_header*>(::operator new(size));
+            chunk->prev = head;
+            chunk->size = size;
+            head = chunk;
+            cur = reinterpret_cast<char*>(chunk + 1);
+            end = reinterpret_cast<char*>(chunk) + size;
+            ++chunks;
+            reserved += size;
+            next_chunk = std::min(next_chunk * 2, max_chunk);
+        }
+
+        void steal(arena& other) noexcept
+        {
+            head = std::exchange(other.head, nullptr);
+            cur = std::exchange(other.cur, nullptr);
+            end = std::exchange(other.end, nullptr);
+            next_chunk = other.next_chunk;
+            max_chunk = other.max_chunk;
+            chunks = std::exchange(other.chunks, 0);
+            reserved = std::exchange(other.reserved, 0);
+            allocated = std::exchange(other.allocated, 0);
+        }
+    };
+
+    /**
+     * Аллокатор поверх mystl::arena: allocate берёт память у арены, deallocate ничего
+     * не делает. Годится как Allocator для mystl::map и std::map; копии и rebind-копии
+     * ссылаются на ту же арену, которая должна пережить контейнер.
+     *
+     *   using Alloc = mystl::arena_allocator<std::pair<const std::uint64_t, std::uint64_t>>;
+     *   mystl::arena a;
+     *   for (const auto& request : requests)
+     *   {
+     *       {
+     *           mystl::map<std::uint64_t, std::uint64_t, std::less<std::uint64_t>, Alloc> m{Alloc(a)};
+     *           ...                // построение и запросы
+     *       }                      // деструктор без обхода узлов (is_monotonic)
+     *       a.reset();             // последний блок остаётся для следующего запроса
+     *   }
+     */
+    template <typename T>
+    class arena_allocator
+    {
+    public:
+        using value_type = T;
+        using is_monotonic = std::true_type;
+
+        explicit arena_allocator(arena& a) noexcept : source(&a) {}
+
+        template <typename U>
+        arena_allocator(const arena_allocator<U>& other) noexcept : source(other.source) {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+            return static_cast<T*>(source->allocate(n * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, std::size_t) noexcept {}
+
+        arena* resource() const noexcept { return source; }
+
+        template <typename U>
+        friend bool operator==(const arena_allocator& a, const arena_allocator<U>& b) noexcept { return a.source == b.source; }
+
+        template <typename U>
+        friend bool operator!=(const arena_allocator& a, const arena_allocator<U>& b) noexcept { return a.source != b.source; }
+
+    private:
+        template <typename>
+        friend class arena_allocator;
+
+        arena* source;
+    };
+
+} // namespace mystl
+
+#endif // ARENA_HPP
@@ -0,0 +1,544 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include "map.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mystl {
+
+    /**
+     * Значение bool в массиве flat_map: std::vector<bool> хранит биты и не отдаёт bool&,
+     * поэтому каждое значение лежит в отдельном байте.
+     */
+    struct flat_bool
+    {
+        bool value = false;
+
+        flat_bool() = default;
+        flat_bool(bool v) noexcept : value(v) {}
+
+        operator bool() const noexcept { return value; }
+
+        friend bool operator==(flat_bool a, flat_bool b) noexcept { return a.value == b.value; }
+        friend bool operator!=(flat_bool a, flat_bool b) noexcept { return a.value != b.value; }
+    };
+
+    /**
+     * Отсортированная карта на двух непрерывных массивах: ключи отдельно, значения отдельно.
+     * Поиск идёт только по плотному массиву ключей, без переходов по указателям,
+     * поэтому для карт «в основном на чтение» это быстрее любого дерева из узлов.
+     * Одиночная вставка и удаление – O(n) сдвигов; изменения пачками лучше делать
+     * через insert_range (сортировка пачки и слияние за O(n + m log m)).
+     *
+     * Интерфейс повторяет mystl::map. Итераторы – с произвольным доступом, *it возвращает
+     * прокси-пару ссылок std::pair<const Key&, T&>; любая вставка или удаление делает
+     * итераторы недействительными, как у vector.
+     */
+    template <typename Key, typename T,
+              typename Compare = std::less<Key>,
+              typename Allocator = std::allocator<std::pair<const Key, T>>>
+    class flat_map : private EBO<Compare>
+    {
+    private:
+        const Compare& get_compare() const { return static_cast<const EBO<Compare>&>(*this).get(); }
+
+        // Элемент массива значений: сам T, для bool – flat_bool
+        using stored_type = std::conditional_t<std::is_same_v<T, bool>, flat_bool, T>;
+
+        using key_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Key>;
+        using mapped_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<stored_type>;
+
+        static T& unwrap(stored_type& v) noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return v.value;
+            else
+                return v;
+        }
+
+        static const T& unwrap(const stored_type& v) noexcept
+        {
+            if constexpr (std::is_same_v<T, bool>)
+                return v.value;
+            else
+                return v;
+        }
+
+    public:
+        using key_type          = Key;
+        using mapped_type       = T;
+        using value_type        = std::pair<Key, T>;
+        using size_type         = std::size_t;
+        using difference_type   = std::ptrdiff_t;
+        using key_compare       = Compare;
+        using allocator_type    = Allocator;
+        using key_container     = std::vector<Key, key_allocator>;
+        using mapped_container  = std::vector<stored_type, mapped_allocator>;   // для bool – flat_bool
+        using reference         = std::pair<const Key&, T&>;
+        using const_reference   = std::pair<const Key&, const T&>;
+
+        /**
+         * Итератор – пара указателей в массивы ключей и значений, которые двигаются вместе.
+         */
+        template <bool Const>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type        = std::pair<Key, T>;
+            using difference_type   = std::ptrdiff_t;
+            using mapped_pointer    = std::conditional_t<Const, const stored_type*, stored_type*>;
+            using reference         = std::conditional_t<Const, std::pair<const Key&, const T&>, std::pair<const Key&, T&>>;
+
+            // operator-> должен вернуть указатель, а пара ссылок – временный объект
+            struct pointer
+            {
+                reference ref;
+                const reference* operator->() const { return &ref; }
+            };
+
+            const Key* key = nullptr;
+            mapped_pointer value = nullptr;
+
+            basic_iterator() = default;
+            basic_iterator(const Key* k, mapped_pointer v) : key(k), value(v) {}
+
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other) : key(other.key), value(other.value) {}
+
+            reference operator*() const { return reference(*key, unwrap(*value)); }
+            pointer operator->() const { return pointer{**this}; }
+            reference operator[](difference_type n) const { return reference(key[n], unwrap(value[n])); }
+
+            basic_iterator& operator++() { ++key; ++value; return *this; }
+            basic_iterator& operator--() { --key; --value; return *this; }
+            basic_iterator operator++(int) { basic_iterator tmp(*this); ++(*this); return tmp; }
+            basic_iterator operator--(int) { basic_iterator tmp(*this); --(*this); return tmp; }
+
+            basic_iterator& operator+=(difference_type n) { key += n; value += n; return *this; }
+            basic_iterator& operator-=(difference_type n) { key -= n; value -= n; return *this; }
+            basic_iterator operator+(difference_type n) const { return basic_iterator(key + n, value + n); }
+            basic_iterator operator-(difference_type n) const { return basic_iterator(key - n, value - n); }
+            friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+            difference_type operator-(const basic_iterator& other) const { return key - other.key; }
+
+            bool operator==(const basic_iterator& other) const { return key == other.key; }
+            bool operator!=(const basic_iterator& other) const { return key != other.key; }
+            bool operator<(const basic_iterator& other) const { return key < other.key; }
+            bool operator>(const basic_iterator& other) const { return key > other.key; }
+            bool operator<=(const basic_iterator& other) const { return key <= other.key; }
+            bool operator>=(const basic_iterator& other) const { return key >= other.key; }
+        };
+
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        flat_map() : EBO<Compare>() {}
+
+        explicit flat_map(const Compare& comp, const Allocator& alloc = Allocator())
+            : EBO<Compare>(comp), key_array(key_allocator(alloc)), value_array(mapped_allocator(alloc)) {}
+
+        flat_map(std::initializer_list<value_type> init,
+                 const Compare& comp = Compare(),
+                 const Allocator& alloc = Allocator())
+            : flat_map(comp, alloc)
+        {
+            insert_range(init.begin(), init.end());
+        }
+
+        template <typename InputIt>
+        flat_map(InputIt first, InputIt last, const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+            : flat_map(comp, alloc)
+        {
+            insert_range(first, last);
+        }
+
+        flat_map(const flat_map&) = default;
+        flat_map(flat_map&&) noexcept = default;
+        flat_map& operator=(const flat_map&) = default;
+        flat_map& operator=(flat_map&&) noexcept = default;
+        ~flat_map() = default;
+
+        // -- ИТЕРАТОРЫ --
+
+        iterator begin() { return iterator(key_array.data(), value_array.data()); }
+        iterator end()   { return begin() + static_cast<difference_type>(size()); }
+
+        const_iterator begin() const { return const_iterator(key_array.data(), value_array.data()); }
+        const_iterator end() const   { return begin() + static_cast<difference_type>(size()); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const   { return end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const   { return rend(); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return key_array.empty(); }
+
+        size_type size() const { return key_array.size(); }
+
+        size_type max_size() const { return std::min(key_array.max_size(), value_array.max_size()); }
+
+        size_type capacity() const { return key_array.capacity(); }
+
+        void reserve(size_type n)
+        {
+            key_array.reserve(n);
+            value_array.reserve(n);
+        }
+
+        void shrink_to_fit()
+        {
+            key_array.shrink_to_fit();
+            value_array.shrink_to_fit();
+        }
+
+        // Отсортированные массивы ключей и значений (только чтение; значения bool – flat_bool)
+        const key_container& keys() const { return key_array; }
+        const mapped_container& values() const { return value_array; }
+
+        // -- ОПЕРАЦИИ ДОСТУПА --
+
+        mapped_type& operator[](const key_type& key)
+        {
+            return try_emplace(key).first->second;
+        }
+
+        mapped_type& at(const key_type& key)
+        {
+            size_type i = lower_index(key);
+            if (!matches(i, key))
+                throw std::out_of_range("Key not found");
+            return unwrap(value_array[i]);
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            size_type i = lower_index(key);
+            if (!matches(i, key))
+                throw std::out_of_range("Key not found");
+            return unwrap(value_array[i]);
+        }
+
+        // -- МОДИФИКАЦИЯ --
+
+        void insert(const value_type& value) { try_emplace(value.first, value.second); }
+
+        void emplace(const key_type& key, const mapped_type& value) { try_emplace(key, value); }
+
+        /**
+         * Вставка пачкой: новые элементы сортируются отдельно и сливаются с массивами
+         * за один проход. Как и у map::insert, существующие ключи не перезаписываются,
+         * а из повторов внутри пачки остаётся первый.
+         */
+        template <typename InputIt>
+        void insert_range(InputIt first, InputIt last)
+        {
+            std::vector<value_type> batch;
+            for (; first != last; ++first)
+                batch.emplace_back((*first).first, (*first).second);
+            if (batch.empty())
+                return;
+
+            std::stable_sort(batch.begin(), batch.end(),
+                             [&](const value_type& a, const value_type& b) { return get_compare()(a.first, b.first); });
+            batch.erase(std::unique(batch.begin(), batch.end(),
+                                    [&](const value_type& a, const value_type& b) { return !get_compare()(a.first, b.first); }),
+                        batch.end());
+
+            // Частый случай – все новые ключи больше существующих: достаточно дописать в конец.
+            // Если конструктор элемента бросит, дописанное убирается
+            if (empty() || get_compare()(key_array.back(), batch.front().first))
+            {
+                size_type old_size = size();
+                reserve(old_size + batch.size());
+                try {
+                    for (auto& item : batch)
+                    {
+                        key_array.push_back(std::move(item.first));
+                        value_array.push_back(std::move(item.second));
+                    }
+                } catch (...) {
+                    key_array.erase(key_array.begin() + static_cast<difference_type>(old_size), key_array.end());
+                    value_array.erase(value_array.begin() + static_cast<difference_type>(old_size), value_array.end());
+                    throw;
+                }
+                return;
+            }
+
+            // Слияние в новые массивы. Имеющиеся элементы переносятся, только если перенос
+            // не бросает (тогда после reserve не бросает ничего), иначе копируются: исключение
+            // оставляет карту прежней
+            constexpr bool relocate = std::is_nothrow_move_constructible_v<Key>
+                                      && std::is_nothrow_move_constructible_v<stored_type>;
+            auto take = [](auto& x) -> decltype(auto)
+            {
+                if constexpr (relocate)
+                    return std::move(x);
+                else
+                    return std::as_const(x);
+            };
+            key_container merged_keys(key_array.get_allocator());
+            mapped_container merged_values(value_array.get_allocator());
+            merged_keys.reserve(size() + batch.size());
+            merged_values.reserve(size() + batch.size());
+            size_type i = 0;
+            for (auto& item : batch)
+            {
+                while (i < size() && get_compare()(key_array[i], item.first))
+                {
+                    merged_keys.push_back(take(key_array[i]));
+                    merged_values.push_back(take(value_array[i]));
+                    ++i;
+                }
+                if (i < size() && !get_compare()(item.first, key_array[i]))
+                    continue;
+                merged_keys.push_back(std::move(item.first));
+                merged_values.push_back(std::move(item.second));
+            }
+            for (; i < size(); ++i)
+            {
+                merged_keys.push_back(take(key_array[i]));
+                merged_values.push_back(take(value_array[i]));
+            }
+            key_array.swap(merged_keys);
+            value_array.swap(merged_values);
+        }
+
+        template <typename Range>
+        void insert_range(const Range& range) { insert_range(std::begin(range), std::end(range)); }
+
+        void erase(const key_type& key)
+        {
+            size_type i = lower_index(key);
+            if (matches(i, key))
+                erase_at(i);
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            size_type i = index_of(pos);
+            if (i < size())
+                erase_at(i);
+            return begin() + static_cast<difference_type>(i);
+        }
+
+        iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+        iterator erase(const_iterator first, const_iterator last)
+        {
+            size_type from = index_of(first);
+            size_type to = index_of(last);
+            key_array.erase(key_array.begin() + from, key_array.begin() + to);
+            value_array.erase(value_array.begin() + from, value_array.begin() + to);
+            return begin() + static_cast<difference_type>(from);
+        }
+
+        // Удаляет все подходящие элементы за один проход уплотнения
+        template <typename Predicate>
+        size_type erase_if(Predicate pred)
+        {
+            size_type out = 0;
+            for (size_type i = 0; i < size(); ++i)
+            {
+                if (pred(const_reference(key_array[i], unwrap(value_array[i]))))
+                    continue;
+                if (out != i)
+                {
+                    key_array[out] = std::move(key_array[i]);
+                    value_array[out] = std::move(value_array[i]);
+                }
+                ++out;
+            }
+            size_type removed = size() - out;
+            key_array.erase(key_array.begin() + out, key_array.end());
+            value_array.erase(value_array.begin() + out, value_array.end());
+            return removed;
+        }
+
+        void clear()
+        {
+            key_array.clear();
+            value_array.clear();
+        }
+
+        void insert_or_assign(const key_type& key, const mapped_type& value)
+        {
+            auto result = try_emplace(key, value);
+            if (!result.second)
+                result.first->second = value;
+        }
+
+        iterator emplace_hint(const_iterator /*hint*/, const value_type& value)
+        {
+            return try_emplace(value.first, value.second).first;
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            size_type i = lower_index(key);
+            auto at = begin() + static_cast<difference_type>(i);
+            if (matches(i, key))
+                return {at, false};
+            value_array.emplace(value_array.begin() + i, std::forward<Args>(args)...);
+            try {
+                key_array.insert(key_array.begin() + i, key);
+            } catch (...) {
+                value_array.erase(value_array.begin() + i);
+                throw;
+            }
+            return {begin() + static_cast<difference_type>(i), true};
+        }
+
+        value_type extract(const key_type& key)
+        {
+            size_type i = lower_index(key);
+            if (!matches(i, key))
+                throw std::out_of_range("Key not found");
+            value_type val(std::move(key_array[i]), std::move(unwrap(value_array[i])));
+            erase_at(i);
+            return val;
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key) { return {lower_bound(key), upper_bound(key)}; }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        /**
+         * Переносит из source элементы с ключами, которых здесь нет; остальные остаются в source.
+         * Обе карты отсортированы, так что это одно слияние.
+         */
+        void merge(flat_map& source)
+        {
+            if (&source == this || source.empty())
+                return;
+            std::vector<value_type> moved;
+            size_type i = 0;
+            auto taken = [&](const_reference kv)
+            {
+                while (i < size() && get_compare()(key_array[i], kv.first))
+                    ++i;
+                if (i < size() && !get_compare()(kv.first, key_array[i]))
+                    return false;
+                moved.emplace_back(kv.first, kv.second);
+                return true;
+            };
+            source.erase_if(taken);
+            insert_range(std::make_move_iterator(moved.begin()), std::make_move_iterator(moved.end()));
+        }
+
+        void swap(flat_map& other)
+        {
+            std::swap(static_cast<EBO<Compare>&>(*this), static_cast<EBO<Compare>&>(other));
+            key_array.swap(other.key_array);
+            value_array.swap(other.value_array);
+        }
+
+        // -- ПОИСК --
+
+        iterator find(const key_type& key)
+        {
+            size_type i = lower_index(key);
+            return matches(i, key) ? begin() + static_cast<difference_type>(i) : end();
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            size_type i = lower_index(key);
+            return matches(i, key) ? begin() + static_cast<difference_type>(i) : end();
+        }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const { return matches(lower_index(key), key); }
+
+        iterator lower_bound(const key_type& key) { return begin() + static_cast<difference_type>(lower_index(key)); }
+        const_iterator lower_bound(const key_type& key) const { return begin() + static_cast<difference_type>(lower_index(key)); }
+
+        iterator upper_bound(const key_type& key) { return begin() + static_cast<difference_type>(upper_index(key)); }
+        const_iterator upper_bound(const key_type& key) const { return begin() + static_cast<difference_type>(upper_index(key)); }
+
+        key_compare key_comp() const { return get_compare(); }
+
+        struct value_compare
+        {
+            value_compare(Compare c) : comp(c) {}
+            bool operator()(const value_type& lhs, const value_type& rhs) const
+            {
+                return comp(lhs.first, rhs.first);
+            }
+        private:
+            Compare comp;
+        };
+
+        value_compare value_comp() const { return value_compare(get_compare()); }
+
+        friend bool operator==(const flat_map& lhs, const flat_map& rhs)
+        {
+            return lhs.key_array == rhs.key_array && lhs.value_array == rhs.value_array;
+        }
+
+        friend bool operator!=(const flat_map& lhs, const flat_map& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const flat_map& lhs, const flat_map& rhs)
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+        friend bool operator<=(const flat_map& lhs, const flat_map& rhs) { return !(rhs < lhs); }
+        friend bool operator>(const flat_map& lhs, const flat_map& rhs) { return rhs < lhs; }
+        friend bool operator>=(const flat_map& lhs, const flat_map& rhs) { return !(lhs < rhs); }
+
+    private:
+        size_type lower_index(const key_type& key) const
+        {
+            return static_cast<size_type>(std::lower_bound(key_array.begin(), key_array.end(), key, get_compare()) - key_array.begin());
+        }
+
+        size_type upper_index(const key_type& key) const
+        {
+            return static_cast<size_type>(std::upper_bound(key_array.begin(), key_array.end(), key, get_compare()) - key_array.begin());
+        }
+
+        bool matches(size_type i, const key_type& key) const
+        {
+            return i < size() && !get_compare()(key, key_array[i]);
+        }
+
+        size_type index_of(const_iterator it) const { return static_cast<size_type>(it.key - key_array.data()); }
+
+        void erase_at(size_type i)
+        {
+            key_array.erase(key_array.begin() + i);
+            value_array.erase(value_array.begin() + i);
+        }
+
+        key_container key_array;
+        mapped_container value_array;
+    };
+
+} // namespace mystl
+
+#endif // FLAT_MAP_HPP
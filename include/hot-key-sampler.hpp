@@ -0,0 +1,308 @@
+#ifndef HOT_KEY_SAMPLER_HPP
+#define HOT_KEY_SAMPLER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace mystl {
+
+    /**
+     * Наблюдатель за ключами поиска. mystl::map хранит указатель на базовый класс,
+     * поэтому ключи без std::hash не мешают компиляции карты, а без подключённого
+     * наблюдателя поиск платит только за проверку указателя.
+     */
+    template <typename Key>
+    class key_observer
+    {
+    public:
+        virtual ~key_observer() = default;
+        virtual void observe(const Key& key) = 0;
+    };
+
+    /**
+     * Count-min sketch: depth строк по width счётчиков. Оценка частоты не меньше
+     * истинной и превышает её не более чем на e/width * N с вероятностью 1 - e^-depth.
+     * Счётчики атомарные, так что обновлять скетч можно из нескольких потоков.
+     */
+    class count_min_sketch
+    {
+    public:
+        count_min_sketch(std::size_t width = 2048, std::size_t depth = 4)
+            : width(std::max<std::size_t>(width, 1)), depth(std::max<std::size_t>(depth, 1)),
+              counters(new std::atomic<std::uint32_t>[this->width * this->depth])
+        {
+            reset();
+        }
+
+        // Увеличивает счётчики хэша и возвращает новую оценку
+        std::uint64_t add(std::uint64_t hash)
+        {
+            std::uint64_t estimate = ~0ULL;
+            for (std::size_t row = 0; row < depth; ++row)
+            {
+                std::uint32_t value = counters[slot(hash, row)].fetch_add(1, std::memory_order_relaxed) + 1;
+                estimate = std::min<std::uint64_t>(estimate, value);
+            }
+            return estimate;
+        }
+
+        std::uint64_t estimate(std::uint64_t hash) const
+        {
+            std::uint64_t estimate = ~0ULL;
+            for (std::size_t row = 0; row < depth; ++row)
+                estimate = std::min<std::uint64_t>(estimate, counters[slot(hash, row)].load(std::memory_order_relaxed));
+            return estimate;
+        }
+
+        void reset()
+        {
+            for (std::size_t i = 0; i < width * depth; ++i)
+                counters[i].store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        std::size_t slot(std::uint64_t hash, std::size_t row) const
+        {
+            std::uint64_t h = hash + 0x9E3779B97F4A7C15ULL * (row + 1);
+            h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 29;
+            return row * width + static_cast<std::size_t>(h % width);
+        }
+
+        std::size_t width;
+        std::size_t depth;
+        std::unique_ptr<std::atomic<std::uint32_t>[]> counters;
+    };
+
+    /**
+     * Сэмплер горячих ключей: с вероятностью sample_rate ключ поиска попадает
+     * в count-min sketch, а top_k ключей с наибольшей оценкой хранятся отдельно.
+     * Оценки масштабируются на 1 / sample_rate, то есть приближают полное число обращений.
+     *
+     * observe() можно вызывать из нескольких потоков. Несэмплированный вызов пишет только
+     * в счётчик своего потока; общие атомики трогает лишь сэмплированный. Мьютекс берётся
+     * только когда ключ вне top_k и его оценка превысила наименьшую в top_k: ключи из top_k
+     * узнаются по хэшу в таблице без блокировок, а их оценки top() читает из скетча.
+     *
+     *   mystl::hot_key_sampler<std::string> sampler(0.01);
+     *   m.attach_sampler(&sampler);
+     *   ...
+     *   for (auto& [key, hits] : sampler.top()) ...
+     */
+    template <typename Key, typename Hash = std::hash<Key>>
+    class hot_key_sampler : public key_observer<Key>
+    {
+    public:
+        explicit hot_key_sampler(double sample_rate = 0.01, std::size_t top_k = 16,
+                                 std::size_t width = 2048, std::size_t depth = 4)
+            : sketch(width, depth), k(top_k), id(next_id.fetch_add(1, std::memory_order_relaxed) + 1),
+              slots(slot_count(top_k)), hot(new std::atomic<std::uint64_t>[slots])
+        {
+            for (std::size_t i = 0; i < slots; ++i)
+                hot[i].store(0, std::memory_order_relaxed);
+            set_sample_rate(sample_rate);
+        }
+
+        void observe(const Key& key) override
+        {
+            // Счётчик пишет только этот поток, поэтому хватает load и store без блокировки шины
+            std::atomic<std::uint64_t>& calls = local_counter().calls;
+            calls.store(calls.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            std::uint64_t limit = threshold.load(std::memory_order_relaxed);
+            if (limit != ~0ULL && next_random() >= limit)
+                return;
+            sampled.fetch_add(1, std::memory_order_relaxed);
+
+            std::uint64_t hash = Hash{}(key);
+            std::uint64_t estimate = sketch.add(hash);
+            if (k == 0 || is_hot(hash) || estimate <= admit_min.load(std::memory_order_relaxed))
+                return;
+
+            std::lock_guard<std::mutex> lock(mutex);
+            if (std::any_of(heavy.begin(), heavy.end(), [&](const auto& e) { return e.first == key; }))
+                return;
+            if (heavy.size() < k)
+                heavy.emplace_back(key, hash);
+            else
+            {
+                auto weakest = std::min_element(heavy.begin(), heavy.end(), [&](const auto& a, const auto& b)
+                {
+                    return sketch.estimate(a.second) < sketch.estimate(b.second);
+                });
+                if (estimate <= sketch.estimate(weakest->second))
+                    return;
+                *weakest = {key, hash};
+            }
+            publish_locked();
+        }
+
+        // Доля обращений, попадающих в скетч, в (0, 1]; можно менять во время работы
+        void set_sample_rate(double rate)
+        {
+            rate = std::clamp(rate, 1e-9, 1.0);
+            rate_value.store(rate, std::memory_order_relaxed);
+            threshold.store(rate >= 1.0 ? ~0ULL : static_cast<std::uint64_t>(rate * 18446744073709551616.0),
+                            std::memory_order_relaxed);
+        }
+
+        double sample_rate() const { return rate_value.load(std::memory_order_relaxed); }
+
+        // Оценка числа обращений к ключу
+        std::uint64_t estimate(const Key& key) const { return scale(sketch.estimate(Hash{}(key))); }
+
+        // Горячие ключи по убыванию оценки числа обращений
+        std::vector<std::pair<Key, std::uint64_t>> top() const
+        {
+            std::vector<std::pair<Key, std::uint64_t>> result;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                result = heavy;
+            }
+            for (auto& entry : result)
+                entry.second = scale(sketch.estimate(entry.second));
+            std::sort(result.begin(), result.end(), [](const auto& a, const auto& b) { return a.second > b.second; });
+            return result;
+        }
+
+        // Сумма счётчиков потоков; вызовы, идущие одновременно с чтением, могут не попасть
+        std::uint64_t observed() const
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            std::uint64_t total = 0;
+            for (const auto& c : counters)
+                total += c->calls.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        std::uint64_t sampled_count() const { return sampled.load(std::memory_order_relaxed); }
+
+        void reset()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sketch.reset();
+            heavy.clear();
+            publish_locked();
+            for (auto& c : counters)
+                c->calls.store(0, std::memory_order_relaxed);
+            sampled.store(0, std::memory_order_relaxed);
+        }
+
+    private:
+        // Счётчик вызовов observe() одного потока в своей кэш-линии
+        struct alignas(64) call_counter
+        {
+            std::atomic<std::uint64_t> calls{0};
+        };
+
+        /**
+         * Счётчик текущего потока. Поток помнит счётчики последних четырёх сэмплеров по их id
+         * (id не переиспользуются, так что запись уничтоженного сэмплера ни с чем не совпадёт);
+         * новый счётчик регистрируется под мьютексом и живёт, пока жив сэмплер.
+         */
+        call_counter& local_counter()
+        {
+            struct entry
+            {
+                std::uint64_t owner = 0;
+                call_counter* counter = nullptr;
+            };
+            thread_local entry cache[4];
+            thread_local std::size_t victim = 0;
+            for (const auto& e : cache)
+                if (e.owner == id)
+                    return *e.counter;
+
+            call_counter* c;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                counters.push_back(std::make_unique<call_counter>());
+                c = counters.back().get();
+            }
+            cache[victim++ % 4] = {id, c};
+            return *c;
+        }
+
+        std::uint64_t scale(std::uint64_t count) const
+        {
+            return static_cast<std::uint64_t>(static_cast<double>(count) / rate_value.load(std::memory_order_relaxed));
+        }
+
+        // Таблица хэшей top_k с открытой адресацией, заполнена не больше чем на четверть
+        static std::size_t slot_count(std::size_t top_k)
+        {
+            std::size_t n = 8;
+            while (n < 4 * top_k)
+                n *= 2;
+            return n;
+        }
+
+        // 0 означает пустой слот, поэтому нулевой хэш хранится как 1
+        static std::uint64_t tag(std::uint64_t hash) { return hash ? hash : 1; }
+
+        bool is_hot(std::uint64_t hash) const
+        {
+            std::uint64_t t = tag(hash);
+            for (std::size_t i = t & (slots - 1);; i = (i + 1) & (slots - 1))
+            {
+                std::uint64_t v = hot[i].load(std::memory_order_relaxed);
+                if (v == t)
+                    return true;
+                if (v == 0)
+                    return false;
+            }
+        }
+
+        // Перестраивает таблицу хэшей и порог входа в top_k после изменения heavy
+        void publish_locked()
+        {
+            for (std::size_t i = 0; i < slots; ++i)
+                hot[i].store(0, std::memory_order_relaxed);
+            std::uint64_t lowest = ~0ULL;
+            for (const auto& entry : heavy)
+            {
+                std::uint64_t t = tag(entry.second);
+                std::size_t i = t & (slots - 1);
+                while (hot[i].load(std::memory_order_relaxed) != 0)
+                    i = (i + 1) & (slots - 1);
+                hot[i].store(t, std::memory_order_relaxed);
+                lowest = std::min(lowest, sketch.estimate(entry.second));
+            }
+            // Пока top_k не заполнен, войти может любой ключ
+            admit_min.store(heavy.size() < k ? 0 : lowest, std::memory_order_relaxed);
+        }
+
+        // xorshift64* в thread_local состоянии: решение о сэмпле не требует синхронизации
+        static std::uint64_t next_random()
+        {
+            thread_local std::uint64_t state =
+                0x2545F4914F6CDD1DULL ^ reinterpret_cast<std::uintptr_t>(&state);
+            state ^= state >> 12;
+            state ^= state << 25;
+            state ^= state >> 27;
+            return state * 0x2545F4914F6CDD1DULL;
+        }
+
+        count_min_sketch sketch;
+        std::size_t k;
+        std::uint64_t id;
+        inline static std::atomic<std::uint64_t> next_id{0};
+        std::atomic<double> rate_value{1.0};
+        std::atomic<std::uint64_t> threshold{~0ULL};
+        std::atomic<std::uint64_t> sampled{0};
+        std::atomic<std::uint64_t> admit_min{0};
+        std::size_t slots;
+        std::unique_ptr<std::atomic<std::uint64_t>[]> hot;
+        mutable std::mutex mutex;
+        std::vector<std::pair<Key, std::uint64_t>> heavy;   // ключ и его хэш
+        std::vector<std::unique_ptr<call_counter>> counters;
+    };
+
+} // namespace mystl
+
+#endif // HOT_KEY_SAMPLER_HPP
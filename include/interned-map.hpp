@@ -0,0 +1,322 @@
+#ifndef INTERNED_MAP_HPP
+#define INTERNED_MAP_HPP
+
+#include "arena.hpp"
+#include "map.hpp"
+#include "memory-usage.hpp"
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace mystl {
+
+    /**
+     * Ключ interned_map: string_view на байты в арене карты. view объявлен mutable,
+     * чтобы компактирование арены могло перенаправить ключ узла на новую копию тех же
+     * байтов – порядок при этом не меняется.
+     */
+    struct interned_key
+    {
+        mutable std::string_view view;
+
+        interned_key() = default;
+
+        explicit interned_key(std::string_view s) : view(s) {}
+
+        operator std::string_view() const { return view; }
+
+        std::string str() const { return std::string(view); }
+
+        std::size_t size() const { return view.size(); }
+
+        const char* data() const { return view.data(); }
+
+        friend bool operator==(const interned_key& a, const interned_key& b) { return a.view == b.view; }
+        friend bool operator!=(const interned_key& a, const interned_key& b) { return a.view != b.view; }
+        friend bool operator<(const interned_key& a, const interned_key& b) { return a.view < b.view; }
+        friend bool operator>(const interned_key& a, const interned_key& b) { return b.view < a.view; }
+        friend bool operator<=(const interned_key& a, const interned_key& b) { return !(b.view < a.view); }
+        friend bool operator>=(const interned_key& a, const interned_key& b) { return !(a.view < b.view); }
+
+        friend std::ostream& operator<<(std::ostream& os, const interned_key& key) { return os << key.view; }
+    };
+
+    // Байты ключа принадлежат арене карты и учитываются в interned_map::memory_usage()
+    template <>
+    struct heap_usage<interned_key>
+    {
+        std::size_t operator()(const interned_key&) const noexcept { return 0; }
+    };
+
+    /**
+     * Карта со строковыми ключами, байты которых копируются в арену карты (mystl::arena),
+     * а узлы mystl::map хранят только interned_key. Вместо выделения под каждую строку
+     * длиннее SSO – одно выделение на блок арены, и ключи соседних вставок лежат рядом.
+     *
+     * Удалённые ключи остаются в арене. Когда их байты превышают compaction_ratio
+     * от живых (и хотя бы min_compaction_bytes), арена перестраивается: живые ключи
+     * копируются по порядку обхода в новый блок точного размера. Компактирование
+     * меняет только адреса байтов ключей – итераторы остаются действительными,
+     * а string_view, полученные из ключей раньше, – нет.
+     */
+    template <typename T,
+              typename Allocator = std::allocator<std::pair<const interned_key, T>>>
+    class interned_map
+    {
+        using map_type = map<interned_key, T, std::less<interned_key>, Allocator>;
+
+    public:
+        using key_type               = interned_key;
+        using mapped_type            = T;
+        using value_type             = typename map_type::value_type;
+        using size_type              = std::size_t;
+        using allocator_type         = Allocator;
+        using iterator               = typename map_type::iterator;
+        using const_iterator         = typename map_type::const_iterator;
+        using reverse_iterator       = typename map_type::reverse_iterator;
+        using const_reverse_iterator = typename map_type::const_reverse_iterator;
+
+        static constexpr size_type min_compaction_bytes = 4096;
+
+        interned_map() = default;
+
+        explicit interned_map(const Allocator& alloc) : entries(alloc) {}
+
+        interned_map(std::initializer_list<std::pair<std::string_view, T>> init)
+        {
+            for (const auto& kv : init)
+                try_emplace(kv.first, kv.second);
+        }
+
+        interned_map(const interned_map& other) : compaction_ratio(other.compaction_ratio)
+        {
+            // Ключи копируются в свою арену: узлы копии не должны ссылаться на чужую
+            for (const auto& kv : other.entries)
+                try_emplace(kv.first.view, kv.second);
+        }
+
+        interned_map(interned_map&& other) noexcept
+            : entries(std::move(other.entries)),
+              keys(std::move(other.keys)),
+              live_bytes(std::exchange(other.live_bytes, 0)),
+              erased_bytes(std::exchange(other.erased_bytes, 0)),
+              compaction_count(other.compaction_count),
+              compaction_ratio(other.compaction_ratio)
+        {
+            // Блоки арены перешли к нам вместе с байтами ключей
+            other.entries.clear();
+        }
+
+        interned_map& operator=(const interned_map& other)
+        {
+            if (this != &other)
+            {
+                interned_map copy(other);
+                *this = std::move(copy);
+            }
+            return *this;
+        }
+
+        interned_map& operator=(interned_map&& other) noexcept
+        {
+            if (this != &other)
+            {
+                entries.clear();
+                entries = std::move(other.entries);
+                keys = std::move(other.keys);
+                live_bytes = std::exchange(other.live_bytes, 0);
+                erased_bytes = std::exchange(other.erased_bytes, 0);
+                compaction_count = other.compaction_count;
+                compaction_ratio = other.compaction_ratio;
+                other.entries.clear();
+            }
+            return *this;
+        }
+
+        ~interned_map() = default;
+
+        // -- ИТЕРАТОРЫ --
+
+        iterator begin() { return entries.begin(); }
+        iterator end()   { return entries.end(); }
+
+        const_iterator begin() const { return entries.begin(); }
+        const_iterator end() const   { return entries.end(); }
+
+        const_iterator cbegin() const { return entries.cbegin(); }
+        const_iterator cend() const   { return entries.cend(); }
+
+        reverse_iterator rbegin() { return entries.rbegin(); }
+        reverse_iterator rend()   { return entries.rend(); }
+
+        const_reverse_iterator rbegin() const { return entries.rbegin(); }
+        const_reverse_iterator rend() const   { return entries.rend(); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return entries.empty(); }
+
+        size_type size() const { return entries.size(); }
+
+        // Узлы дерева плюс блоки арены
+        size_type memory_usage() const { return entries.memory_usage() + keys.bytes_reserved(); }
+
+        // -- АРЕНА КЛЮЧЕЙ --
+
+        // Байты живых ключей
+        size_type key_bytes() const { return live_bytes; }
+
+        // Байты удалённых ключей, ещё занимающие арену
+        size_type erased_key_bytes() const { return erased_bytes; }
+
+        size_type arena_bytes() const { return keys.bytes_reserved(); }
+
+        size_type arena_chunks() const { return keys.chunk_count(); }
+
+        size_type compactions() const { return compaction_count; }
+
+        // Компактировать, когда erased_key_bytes() > ratio * key_bytes(); 0 – не компактировать
+        void set_compaction_ratio(double ratio) { compaction_ratio = ratio; }
+
+        // Переносит живые ключи в новую арену одним блоком
+        void compact()
+        {
+            arena fresh(live_bytes + 1);
+            for (auto& kv : entries)
+                kv.first.view = store(fresh, kv.first.view);
+            keys = std::move(fresh);
+            erased_bytes = 0;
+            ++compaction_count;
+        }
+
+        // -- ОПЕРАЦИИ ДОСТУПА --
+
+        mapped_type& operator[](std::string_view key) { return try_emplace(key).first->second; }
+
+        mapped_type& at(std::string_view key) { return entries.at(interned_key(key)); }
+
+        const mapped_type& at(std::string_view key) const { return entries.at(interned_key(key)); }
+
+        // -- МОДИФИКАЦИЯ --
+
+        void insert(const std::pair<std::string_view, T>& value) { try_emplace(value.first, value.second); }
+
+        /**
+         * Байты ключа копируются в арену до вставки, чтобы не искать ключ отдельно;
+         * если ключ уже есть, копия откатывается (она последняя в арене).
+         */
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(std::string_view key, Args&&... args)
+        {
+            std::string_view stored = store(keys, key);
+            std::pair<iterator, bool> result;
+            try {
+                result = entries.try_emplace(interned_key(stored), std::forward<Args>(args)...);
+            } catch (...) {
+                keys.rollback(stored.data(), stored.size());
+                throw;
+            }
+            if (result.second)
+                live_bytes += key.size();
+            else
+                keys.rollback(stored.data(), stored.size());
+            return result;
+        }
+
+        void insert_or_assign(std::string_view key, const mapped_type& value)
+        {
+            auto result = try_emplace(key, value);
+            if (!result.second)
+                result.first->second = value;
+        }
+
+        void erase(std::string_view key)
+        {
+            if (!entries.contains(interned_key(key)))
+                return;
+            entries.erase(interned_key(key));
+            live_bytes -= key.size();
+            erased_bytes += key.size();
+            maybe_compact();
+        }
+
+        iterator erase(iterator pos)
+        {
+            if (pos == end())
+                return pos;
+            iterator next = pos;
+            ++next;
+            std::size_t bytes = pos->first.size();
+            entries.erase(pos->first);
+            live_bytes -= bytes;
+            erased_bytes += bytes;
+            maybe_compact();
+            return next;
+        }
+
+        void clear()
+        {
+            entries.clear();
+            keys.release();
+            live_bytes = 0;
+            erased_bytes = 0;
+        }
+
+        void swap(interned_map& other)
+        {
+            std::swap(*this, other);
+        }
+
+        // -- ПОИСК --
+
+        iterator find(std::string_view key) { return entries.find(interned_key(key)); }
+        const_iterator find(std::string_view key) const { return entries.find(interned_key(key)); }
+
+        size_type count(std::string_view key) const { return entries.count(interned_key(key)); }
+
+        bool contains(std::string_view key) const { return entries.contains(interned_key(key)); }
+
+        iterator lower_bound(std::string_view key) { return entries.lower_bound(interned_key(key)); }
+        const_iterator lower_bound(std::string_view key) const { return entries.lower_bound(interned_key(key)); }
+
+        iterator upper_bound(std::string_view key) { return entries.upper_bound(interned_key(key)); }
+        const_iterator upper_bound(std::string_view key) const { return entries.upper_bound(interned_key(key)); }
+
+        friend bool operator==(const interned_map& lhs, const interned_map& rhs) { return lhs.entries == rhs.entries; }
+        friend bool operator!=(const interned_map& lhs, const interned_map& rhs) { return !(lhs == rhs); }
+
+    private:
+        map_type entries;
+        arena keys;
+        size_type live_bytes = 0;
+        size_type erased_bytes = 0;
+        size_type compaction_count = 0;
+        double compaction_ratio = 1.0;
+
+        static std::string_view store(arena& a, std::string_view key)
+        {
+            if (key.empty())
+                return std::string_view();
+            char* p = static_cast<char*>(a.allocate(key.size(), 1));
+            std::memcpy(p, key.data(), key.size());
+            return std::string_view(p, key.size());
+        }
+
+        void maybe_compact()
+        {
+            if (compaction_ratio > 0.0 && erased_bytes >= min_compaction_bytes
+                && static_cast<double>(erased_bytes) > compaction_ratio * static_cast<double>(live_bytes))
+                compact();
+        }
+    };
+
+} // namespace mystl
+
+#endif // INTERNED_MAP_HPP
@@ -0,0 +1,323 @@
+#ifndef KEY_ENCODING_HPP
+#define KEY_ENCODING_HPP
+
+#include "memory-usage.hpp"
+#include "radix-map.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace mystl {
+
+    /**
+     * Запись байтов ключа. mask инвертирует байты для полей, упорядоченных
+     * по убыванию (см. descending).
+     */
+    struct key_writer
+    {
+        std::string& out;
+        unsigned char mask = 0;
+
+        void put(unsigned char b) { out.push_back(static_cast<char>(b ^ mask)); }
+    };
+
+    // Чтение байтов ключа; обрыв данных – std::invalid_argument
+    struct key_reader
+    {
+        const unsigned char* pos;
+        const unsigned char* end;
+        unsigned char mask = 0;
+
+        unsigned char get()
+        {
+            if (pos == end)
+                throw std::invalid_argument("truncated key encoding");
+            return static_cast<unsigned char>(*pos++ ^ mask);
+        }
+
+        bool done() const { return pos == end; }
+    };
+
+    /**
+     * Точка расширения: кодирование значения в байты, побайтовое сравнение которых
+     * (memcmp) даёт тот же порядок, что и operator< исходного типа, и decode обратно.
+     * Кодировки самоограничивающиеся, поэтому поля можно писать подряд: порядок
+     * конкатенации совпадает с лексикографическим порядком кортежа.
+     *
+     *   template <> struct mystl::key_codec<OrderId> {
+     *       static void encode(key_writer& w, const OrderId& id) { key_codec<std::uint64_t>::encode(w, id.value); }
+     *       static OrderId decode(key_reader& r) { return OrderId{key_codec<std::uint64_t>::decode(r)}; }
+     *   };
+     */
+    template <typename T, typename = void>
+    struct key_codec;
+
+    // Целые: big-endian, у знаковых инвертирован старший бит (отрицательные идут раньше)
+    template <typename T>
+    struct key_codec<T, std::enable_if_t<std::is_integral_v<T> && !std::is_same_v<T, bool>>>
+    {
+        using U = std::make_unsigned_t<T>;
+        static constexpr U sign_bit = std::is_signed_v<T> ? static_cast<U>(U(1) << (sizeof(T) * 8 - 1)) : U(0);
+
+        static void encode(key_writer& w, T value)
+        {
+            U bits = static_cast<U>(static_cast<U>(value) ^ sign_bit);
+            for (std::size_t i = sizeof(T); i-- > 0; )
+                w.put(static_cast<unsigned char>(bits >> (i * 8)));
+        }
+
+        static T decode(key_reader& r)
+        {
+            U bits = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i)
+                bits = static_cast<U>((bits << 8) | r.get());
+            return static_cast<T>(static_cast<U>(bits ^ sign_bit));
+        }
+    };
+
+    template <>
+    struct key_codec<bool>
+    {
+        static void encode(key_writer& w, bool value) { w.put(value ? 1 : 0); }
+        static bool decode(key_reader& r) { return r.get() != 0; }
+    };
+
+    /**
+     * IEEE 754: у положительных инвертируется знаковый бит, у отрицательных – все биты.
+     * -0.0 оказывается меньше +0.0, NaN с установленным знаком – меньше всех чисел,
+     * остальные NaN – больше (operator< для NaN порядка не задаёт).
+     */
+    template <typename T>
+    struct key_codec<T, std::enable_if_t<std::is_floating_point_v<T>>>
+    {
+        using U = std::conditional_t<sizeof(T) == 4, std::uint32_t, std::uint64_t>;
+        static_assert(sizeof(T) == sizeof(U), "only 32- and 64-bit floating point keys are supported");
+        static constexpr U sign_bit = U(1) << (sizeof(U) * 8 - 1);
+
+        static void encode(key_writer& w, T value)
+        {
+            U bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            bits = (bits & sign_bit) ? ~bits : (bits | sign_bit);
+            key_codec<U>::encode(w, bits);
+        }
+
+        static T decode(key_reader& r)
+        {
+            U bits = key_codec<U>::decode(r);
+            bits = (bits & sign_bit) ? (bits & ~sign_bit) : ~bits;
+            T value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+    };
+
+    /**
+     * Строки: байт 0x00 пишется как 0x00 0xFF, конец строки – 0x00 0x01.
+     * Конец строки меньше любого её продолжения, поэтому "a" < "a\0" < "ab".
+     */
+    template <>
+    struct key_codec<std::string>
+    {
+        static void encode(key_writer& w, const std::string& value)
+        {
+            for (char c : value)
+            {
+                w.put(static_cast<unsigned char>(c));
+                if (c == '\0')
+                    w.put(0xFF);
+            }
+            w.put(0x00);
+            w.put(0x01);
+        }
+
+        static std::string decode(key_reader& r)
+        {
+            std::string value;
+            while (true)
+            {
+                unsigned char b = r.get();
+                if (b != 0x00)
+                {
+                    value.push_back(static_cast<char>(b));
+                    continue;
+                }
+                unsigned char next = r.get();
+                if (next == 0x01)
+                    return value;
+                if (next != 0xFF)
+                    throw std::invalid_argument("malformed string in key encoding");
+                value.push_back('\0');
+            }
+        }
+    };
+
+    /**
+     * Поле, упорядоченное по убыванию: байты его кодировки инвертируются.
+     * Например, (tenant, descending<timestamp>) – по арендатору, внутри – от новых к старым.
+     */
+    template <typename T>
+    struct descending
+    {
+        T value;
+
+        friend bool operator==(const descending& a, const descending& b) { return a.value == b.value; }
+        friend bool operator<(const descending& a, const descending& b) { return b.value < a.value; }
+    };
+
+    template <typename T>
+    struct key_codec<descending<T>>
+    {
+        static void encode(key_writer& w, const descending<T>& field)
+        {
+            key_writer inverted{w.out, static_cast<unsigned char>(w.mask ^ 0xFF)};
+            key_codec<T>::encode(inverted, field.value);
+        }
+
+        static descending<T> decode(key_reader& r)
+        {
+            r.mask ^= 0xFF;
+            descending<T> field{key_codec<T>::decode(r)};
+            r.mask ^= 0xFF;
+            return field;
+        }
+    };
+
+    template <typename... Ts>
+    struct key_codec<std::tuple<Ts...>>
+    {
+        static void encode(key_writer& w, const std::tuple<Ts...>& value)
+        {
+            std::apply([&](const auto&... fields) { (key_codec<std::decay_t<decltype(fields)>>::encode(w, fields), ...); }, value);
+        }
+
+        static std::tuple<Ts...> decode(key_reader& r)
+        {
+            // Списочная инициализация гарантирует порядок вычисления слева направо
+            return std::tuple<Ts...>{key_codec<Ts>::decode(r)...};
+        }
+    };
+
+    template <typename A, typename B>
+    struct key_codec<std::pair<A, B>>
+    {
+        static void encode(key_writer& w, const std::pair<A, B>& value)
+        {
+            key_codec<A>::encode(w, value.first);
+            key_codec<B>::encode(w, value.second);
+        }
+
+        static std::pair<A, B> decode(key_reader& r)
+        {
+            A first = key_codec<A>::decode(r);
+            return std::pair<A, B>(std::move(first), key_codec<B>::decode(r));
+        }
+    };
+
+    /**
+     * Составной ключ, закодированный один раз при создании: сравнение – один memcmp
+     * вместо сравнения кортежа поле за полем на каждом уровне дерева. Подходит как Key
+     * для mystl::map (std::less сравнивает байты) и для mystl::radix_map (байты и есть
+     * radix-представление). decode() восстанавливает исходный кортеж.
+     *
+     *   mystl::map<mystl::normalized_key<std::uint32_t, std::int64_t, std::string>, Event> events;
+     *   events[mystl::encode_key(tenant, ts, name)] = event;
+     */
+    template <typename... Ts>
+    class normalized_key
+    {
+    public:
+        using tuple_type = std::tuple<Ts...>;
+
+        normalized_key() = default;
+
+        explicit normalized_key(const Ts&... fields) : normalized_key(tuple_type(fields...)) {}
+
+        explicit normalized_key(const tuple_type& fields)
+        {
+            key_writer w{data};
+            key_codec<tuple_type>::encode(w, fields);
+        }
+
+        // Ключ из готовых байтов (например, прочитанных с диска); проверяются при decode()
+        static normalized_key from_bytes(std::string bytes)
+        {
+            normalized_key key;
+            key.data = std::move(bytes);
+            return key;
+        }
+
+        tuple_type decode() const
+        {
+            const auto* p = reinterpret_cast<const unsigned char*>(data.data());
+            key_reader r{p, p + data.size()};
+            tuple_type fields = key_codec<tuple_type>::decode(r);
+            if (!r.done())
+                throw std::invalid_argument("trailing bytes in key encoding");
+            return fields;
+        }
+
+        template <std::size_t I>
+        std::tuple_element_t<I, tuple_type> get() const { return std::get<I>(decode()); }
+
+        const std::string& bytes() const { return data; }
+
+        std::size_t size() const { return data.size(); }
+
+        // char_traits<char>::compare сравнивает как unsigned char, то есть как memcmp
+        friend bool operator==(const normalized_key& a, const normalized_key& b) { return a.data == b.data; }
+        friend bool operator!=(const normalized_key& a, const normalized_key& b) { return a.data != b.data; }
+        friend bool operator<(const normalized_key& a, const normalized_key& b) { return a.data < b.data; }
+        friend bool operator>(const normalized_key& a, const normalized_key& b) { return b.data < a.data; }
+        friend bool operator<=(const normalized_key& a, const normalized_key& b) { return !(b.data < a.data); }
+        friend bool operator>=(const normalized_key& a, const normalized_key& b) { return !(a.data < b.data); }
+
+        // Шестнадцатеричный вид байтов (для отладочного вывода дерева)
+        friend std::ostream& operator<<(std::ostream& os, const normalized_key& key)
+        {
+            static const char digits[] = "0123456789abcdef";
+            for (char c : key.data)
+            {
+                auto b = static_cast<unsigned char>(c);
+                os << digits[b >> 4] << digits[b & 0xF];
+            }
+            return os;
+        }
+
+    private:
+        std::string data;
+    };
+
+    template <typename... Ts>
+    normalized_key<std::decay_t<Ts>...> encode_key(const Ts&... fields)
+    {
+        return normalized_key<std::decay_t<Ts>...>(fields...);
+    }
+
+    template <typename... Ts>
+    struct heap_usage<normalized_key<Ts...>>
+    {
+        std::size_t operator()(const normalized_key<Ts...>& key) const noexcept
+        {
+            return heap_usage<std::string>{}(key.bytes());
+        }
+    };
+
+    template <typename... Ts>
+    struct radix_key<normalized_key<Ts...>>
+    {
+        using encoded_type = std::string_view;
+
+        static encoded_type encode(const normalized_key<Ts...>& key) { return key.bytes(); }
+    };
+
+} // namespace mystl
+
+#endif // KEY_ENCODING_HPP
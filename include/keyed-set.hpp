@@ -0,0 +1,301 @@
+#ifndef KEYED_SET_HPP
+#define KEYED_SET_HPP
+
+#include "map.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace mystl {
+
+    // Функтор-проекция: ключ – поле Member значения, например key_member<&Order::id>
+    template <auto Member>
+    struct key_member
+    {
+        template <typename V>
+        const auto& operator()(const V& value) const noexcept { return value.*Member; }
+    };
+
+    /**
+     * Упорядоченное множество значений, которые сами содержат свой ключ: ключ не хранится
+     * отдельно, а получается проекцией KeyOf{}(value). В отличие от mystl::map<Id, Order>
+     * узел хранит Order один раз, без второй копии id. Дерево то же, что у mystl::map
+     * (RedBlackTree с раскладкой ProjectedKey), поэтому доступны статистика, учёт памяти,
+     * compact() и reserve().
+     *
+     * Элементы доступны только для чтения, как в std::set: изменение поля-ключа сломало бы
+     * порядок. Чтобы изменить элемент, его удаляют и вставляют заново.
+     *
+     *   struct Order { std::uint64_t id; double price; std::uint32_t qty; };
+     *   mystl::keyed_set<Order, mystl::key_member<&Order::id>> orders;
+     *   orders.insert({42, 9.5, 100});
+     *   orders.find(42)->price;
+     */
+    template <typename Value, typename KeyOf,
+              typename Compare = std::less<std::remove_cvref_t<std::invoke_result_t<KeyOf, const Value&>>>,
+              typename Allocator = std::allocator<Value>,
+              typename Stats = NullTreeStats>
+    class keyed_set : private EBO<Compare>
+    {
+    public:
+        using key_type        = std::remove_cvref_t<std::invoke_result_t<KeyOf, const Value&>>;
+        using value_type      = Value;
+        using key_extractor   = KeyOf;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using key_compare     = Compare;
+        using allocator_type  = Allocator;
+        using reference       = const value_type&;
+        using const_reference = const value_type&;
+        using stats_type      = TreeStats<Stats>;
+
+    private:
+        using tree_type = RedBlackTree<key_type, Value, Compare, Allocator, Stats, ProjectedKey<KeyOf>>;
+        using node_type = typename tree_type::Node;
+
+        const Compare& get_compare() const { return static_cast<const EBO<Compare>&>(*this).get(); }
+        Compare& get_compare() { return static_cast<EBO<Compare>&>(*this).get(); }
+
+        tree_type tree;
+
+        // Первый узел с ключом не меньше key (Strict = false) или больше key (Strict = true)
+        template <bool Strict>
+        node_type* bound(const key_type& key) const
+        {
+            node_type* current = tree.getRoot();
+            node_type* candidate = nullptr;
+            while (current)
+            {
+                bool goLeft = Strict ? get_compare()(key, current->key()) : !get_compare()(current->key(), key);
+                if (goLeft)
+                {
+                    candidate = current;
+                    current = current->left;
+                }
+                else
+                {
+                    current = current->right;
+                }
+            }
+            return candidate;
+        }
+
+    public:
+        /**
+         * Итератор только для чтения; iterator и const_iterator – один тип, как в std::set.
+         */
+        class const_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = Value;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const Value*;
+            using reference         = const Value&;
+
+            node_type* node;
+            const tree_type* owner;   // нужен, чтобы --end() попал на последний узел
+
+            explicit const_iterator(node_type* n = nullptr, const tree_type* t = nullptr) : node(n), owner(t) {}
+
+            reference operator*() const { return node->value(); }
+            pointer operator->() const { return &(node->value()); }
+
+            const_iterator& operator++()
+            {
+                node = tree_type::successor(node);
+                return *this;
+            }
+            const_iterator operator++(int)
+            {
+                const_iterator tmp(*this);
+                ++(*this);
+                return tmp;
+            }
+
+            const_iterator& operator--()
+            {
+                node = node ? tree_type::predecessor(node) : owner->maxNode();
+                return *this;
+            }
+            const_iterator operator--(int)
+            {
+                const_iterator tmp(*this);
+                --(*this);
+                return tmp;
+            }
+
+            bool operator==(const const_iterator& other) const { return node == other.node; }
+            bool operator!=(const const_iterator& other) const { return node != other.node; }
+        };
+
+        using iterator               = const_iterator;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        keyed_set() : EBO<Compare>(), tree(Compare(), Allocator()) {}
+
+        explicit keyed_set(const Allocator& alloc) : EBO<Compare>(), tree(Compare(), alloc) {}
+
+        explicit keyed_set(const Compare& comp, const Allocator& alloc = Allocator())
+            : EBO<Compare>(comp), tree(comp, alloc) {}
+
+        keyed_set(std::initializer_list<value_type> init,
+                  const Compare& comp = Compare(),
+                  const Allocator& alloc = Allocator())
+            : EBO<Compare>(comp), tree(comp, alloc)
+        {
+            for (const auto& elem : init)
+                insert(elem);
+        }
+
+        // Копирование, перенос и присваивание – как у дерева (с учётом propagate_on_container_*)
+        keyed_set(const keyed_set&) = default;
+        keyed_set(keyed_set&&) noexcept = default;
+        keyed_set& operator=(const keyed_set&) = default;
+        keyed_set& operator=(keyed_set&&) = default;
+
+        allocator_type get_allocator() const noexcept { return tree.get_allocator(); }
+
+        // -- ИТЕРАТОРЫ --
+
+        const_iterator begin() const { return const_iterator(tree.minNode(), &tree); }
+        const_iterator end() const   { return const_iterator(nullptr, &tree); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const   { return end(); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return size() == 0; }
+
+        size_type size() const { return tree.TreeSize(); }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max(); }
+
+        // -- СТАТИСТИКА И ПАМЯТЬ --
+
+        stats_type stats() const { return tree.collectStats(); }
+
+        void reset_stats() { tree.resetStats(); }
+
+        // Живые байты: узлы плюс внешние буферы значений (mystl::heap_usage<Value>)
+        size_type memory_usage() const { return tree.memoryUsage(); }
+
+        void recompute_memory_usage() { tree.recomputeMemoryUsage(); }
+
+        // См. map::reserved_bytes()
+        size_type reserved_bytes() const { return tree.reservedBytes(); }
+
+        // См. map::compact(), map::reserve() и map::shrink_to_fit()
+        void compact(CompactOrder order = CompactOrder::VanEmdeBoas) { tree.compact(order); }
+
+        void reserve(size_type n) { tree.reserve(n); }
+
+        size_type capacity() const { return tree.capacity(); }
+
+        void shrink_to_fit() { tree.shrinkToFit(); }
+
+        bool validate() { return tree.validate(); }
+
+        // -- МОДИФИКАТОРЫ --
+
+        // Вставляет value, если элемента с таким ключом нет; иначе возвращает существующий
+        std::pair<iterator, bool> insert(const value_type& value)
+        {
+            auto [node, inserted] = tree.insertNode(value);
+            return {iterator(node, &tree), inserted};
+        }
+
+        template <typename... Args>
+            requires std::is_constructible_v<value_type, Args&&...>
+        std::pair<iterator, bool> emplace(Args&&... args)
+        {
+            return insert(value_type(std::forward<Args>(args)...));
+        }
+
+        template <typename InputIt>
+        void insert_range(InputIt first, InputIt last)
+        {
+            for (auto it = first; it != last; ++it)
+                insert(*it);
+        }
+
+        size_type erase(const key_type& key)
+        {
+            node_type* node = tree.find(key);
+            if (!node)
+                return 0;
+            tree.eraseNode(node);
+            return 1;
+        }
+
+        iterator erase(iterator pos)
+        {
+            if (pos == end())
+                return pos;
+            iterator next = std::next(pos);
+            tree.eraseNode(pos.node);
+            return next;
+        }
+
+        void clear() { tree.clear(); }
+
+        void swap(keyed_set& other) noexcept
+        {
+            using std::swap;
+            tree.swap(other.tree);
+            swap(get_compare(), other.get_compare());
+        }
+
+        // -- ПОИСК --
+
+        const_iterator find(const key_type& key) const { return const_iterator(tree.find(key), &tree); }
+
+        size_type count(const key_type& key) const { return tree.find(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const { return tree.find(key) != nullptr; }
+
+        const_iterator lower_bound(const key_type& key) const { return const_iterator(bound<false>(key), &tree); }
+
+        const_iterator upper_bound(const key_type& key) const { return const_iterator(bound<true>(key), &tree); }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        key_compare key_comp() const { return get_compare(); }
+
+        key_extractor key_extract() const { return KeyOf(); }
+
+        friend bool operator==(const keyed_set& lhs, const keyed_set& rhs)
+        {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const keyed_set& lhs, const keyed_set& rhs) { return !(lhs == rhs); }
+    };
+
+    namespace pmr {
+
+        // mystl::keyed_set на std::pmr::polymorphic_allocator (см. mystl::pmr::map)
+        template <typename Value, typename KeyOf,
+                  typename Compare = std::less<std::remove_cvref_t<std::invoke_result_t<KeyOf, const Value&>>>,
+                  typename Stats = NullTreeStats>
+        using keyed_set = mystl::keyed_set<Value, KeyOf, Compare, std::pmr::polymorphic_allocator<Value>, Stats>;
+
+    } // namespace pmr
+
+} // namespace mystl
+
+#endif // KEYED_SET_HPP
@@ -0,0 +1,413 @@
+#ifndef MAP_TRACE_HPP
+#define MAP_TRACE_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Запись трассы операций mystl::map в компактный бинарный файл.
+ *
+ * Включается при компиляции макросом MYSTL_MAP_TRACE. Файл трассы задаётся
+ * переменной окружения MYSTL_MAP_TRACE_FILE или вызовом recorder::instance().open(path).
+ *
+ * Формат: 8 байт "MYTRACE1", затем записи
+ *   u8 op | u8 key_kind | varint map_id | varint ts_delta_ns | ключ
+ * где ключ – zigzag-varint для целых, varint длины + байты для строк,
+ * 8 байт хэша для остальных типов и пусто для операций без ключа.
+ */
+namespace mystl {
+namespace trace {
+
+    enum class op_type : std::uint8_t
+    {
+        insert = 1,
+        assign,      // insert_or_assign
+        find,        // find / count / contains / at
+        access,      // operator[]
+        erase,
+        lower_bound,
+        upper_bound,
+        clear
+    };
+
+    enum class key_kind : std::uint8_t
+    {
+        none = 0,
+        integer,
+        bytes,
+        hash
+    };
+
+    constexpr char magic[8] = {'M', 'Y', 'T', 'R', 'A', 'C', 'E', '1'};
+
+    struct event
+    {
+        op_type op = op_type::find;
+        key_kind kind = key_kind::none;
+        std::uint32_t map_id = 0;
+        std::uint64_t timestamp_ns = 0;   // от открытия трассы
+        std::int64_t int_key = 0;          // integer
+        std::uint64_t hash_key = 0;        // hash
+        std::string bytes_key;             // bytes
+    };
+
+    inline void put_varint(std::vector<std::uint8_t>& out, std::uint64_t v)
+    {
+        while (v >= 0x80)
+        {
+            out.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    inline std::uint64_t zigzag(std::int64_t v)
+    {
+        return (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63);
+    }
+
+    inline std::int64_t unzigzag(std::uint64_t v)
+    {
+        return static_cast<std::int64_t>(v >> 1) ^ -static_cast<std::int64_t>(v & 1);
+    }
+
+    /**
+     * Кодирование ключа в запись трассы. Целые сохраняются как есть, строки – побайтно,
+     * для прочих типов сохраняется std::hash (достаточно для воспроизведения нагрузки).
+     */
+    template <typename K, typename = void>
+    struct key_encoder
+    {
+        static key_kind encode(std::vector<std::uint8_t>&, const K&) { return key_kind::none; }
+    };
+
+    template <typename K>
+    struct key_encoder<K, std::enable_if_t<std::is_integral<K>::value || std::is_enum<K>::value>>
+    {
+        static key_kind encode(std::vector<std::uint8_t>& out, const K& key)
+        {
+            put_varint(out, zigzag(static_cast<std::int64_t>(key)));
+            return key_kind::integer;
+        }
+    };
+
+    template <typename K>
+    struct key_encoder<K, std::enable_if_t<std::is_convertible<const K&, std::string_view>::value>>
+    {
+        static key_kind encode(std::vector<std::uint8_t>& out, const K& key)
+        {
+            std::string_view sv(key);
+            put_varint(out, sv.size());
+            out.insert(out.end(), sv.begin(), sv.end());
+            return key_kind::bytes;
+        }
+    };
+
+    template <typename K>
+    struct key_encoder<K, std::enable_if_t<!std::is_integral<K>::value && !std::is_enum<K>::value &&
+                                           !std::is_convertible<const K&, std::string_view>::value,
+                                           std::void_t<decltype(std::hash<K>{}(std::declval<const K&>()))>>>
+    {
+        static key_kind encode(std::vector<std::uint8_t>& out, const K& key)
+        {
+            std::uint64_t h = std::hash<K>{}(key);
+            for (int i = 0; i < 8; ++i)
+                out.push_back(static_cast<std::uint8_t>(h >> (8 * i)));
+            return key_kind::hash;
+        }
+    };
+
+    class recorder
+    {
+    public:
+        static recorder& instance()
+        {
+            static recorder r;
+            return r;
+        }
+
+        bool open(const char* path)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            close_locked();
+            file = std::fopen(path, "wb");
+            if (!file)
+                return false;
+            std::fwrite(magic, 1, sizeof(magic), file);
+            last = now();
+            active.store(true, std::memory_order_release);
+            return true;
+        }
+
+        void close()
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            close_locked();
+        }
+
+        bool enabled() const { return active.load(std::memory_order_acquire); }
+
+        template <typename K>
+        void record(op_type op, std::uint32_t map_id, const K* key)
+        {
+            if (!enabled())
+                return;
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!file)
+                return;
+
+            std::uint64_t t = now();
+            scratch.clear();
+            key_kind kind = key ? key_encoder<K>::encode(scratch, *key) : key_kind::none;
+
+            buffer.push_back(static_cast<std::uint8_t>(op));
+            buffer.push_back(static_cast<std::uint8_t>(kind));
+            put_varint(buffer, map_id);
+            put_varint(buffer, t - last);
+            buffer.insert(buffer.end(), scratch.begin(), scratch.end());
+            last = t;
+
+            if (buffer.size() >= flush_threshold)
+                flush_locked();
+        }
+
+        static std::uint32_t next_map_id()
+        {
+            static std::atomic<std::uint32_t> counter{0};
+            return ++counter;
+        }
+
+        ~recorder() { close(); }
+
+        recorder(const recorder&) = delete;
+        recorder& operator=(const recorder&) = delete;
+
+    private:
+        static constexpr std::size_t flush_threshold = 1 << 16;
+
+        recorder()
+        {
+            if (const char* path = std::getenv("MYSTL_MAP_TRACE_FILE"))
+                open(path);
+        }
+
+        static std::uint64_t now()
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count());
+        }
+
+        void flush_locked()
+        {
+            if (file && !buffer.empty())
+                std::fwrite(buffer.data(), 1, buffer.size(), file);
+            buffer.clear();
+        }
+
+        void close_locked()
+        {
+            active.store(false, std::memory_order_release);
+            flush_locked();
+            if (file)
+                std::fclose(file);
+            file = nullptr;
+        }
+
+        std::mutex mutex;
+        std::atomic<bool> active{false};
+        std::FILE* file = nullptr;
+        std::vector<std::uint8_t> buffer;
+        std::vector<std::uint8_t> scratch;
+        std::uint64_t last = 0;
+    };
+
+    /**
+     * Записывает операцию только на внешнем уровне своей карты: operator[], try_emplace
+     * и т.п. внутри вызывают find/insert той же карты, которые не должны попадать
+     * в трассу повторно. Вложенность считается по map_id в каждом потоке, поэтому
+     * операции над другой картой внутри операции (вложенные карты) записываются.
+     */
+    class scope
+    {
+    public:
+        template <typename K>
+        scope(op_type op, std::uint32_t map_id, const K* key)
+        {
+            auto& open = active();
+            for (std::uint32_t id : open)
+                if (id == map_id)
+                    return;
+            open.push_back(map_id);
+            owner = true;
+            recorder::instance().record(op, map_id, key);
+        }
+
+        ~scope()
+        {
+            if (owner)
+                active().pop_back();
+        }
+
+        scope(const scope&) = delete;
+        scope& operator=(const scope&) = delete;
+
+    private:
+        friend class suspend;
+
+        bool owner = false;
+
+        // Карты, операции которых сейчас выполняются в этом потоке, от внешней к внутренней
+        static std::vector<std::uint32_t>& active()
+        {
+            thread_local std::vector<std::uint32_t> ids;
+            return ids;
+        }
+    };
+
+    /**
+     * Снимает отметку «внутри операции» с карты на время пользовательского кода,
+     * вызванного из операции (обработчик вытеснения бюджета): его операции над той же
+     * картой – настоящие и должны попасть в трассу.
+     */
+    class suspend
+    {
+    public:
+        explicit suspend(std::uint32_t map_id)
+        {
+            auto& open = scope::active();
+            for (std::size_t i = 0; i < open.size(); ++i)
+            {
+                if (open[i] == map_id)
+                {
+                    saved = std::move(open);
+                    open.assign(saved.begin(), saved.begin() + static_cast<std::ptrdiff_t>(i));
+                    return;
+                }
+            }
+        }
+
+        ~suspend()
+        {
+            if (!saved.empty())
+                scope::active() = std::move(saved);
+        }
+
+        suspend(const suspend&) = delete;
+        suspend& operator=(const suspend&) = delete;
+
+    private:
+        std::vector<std::uint32_t> saved;
+    };
+
+    /**
+     * Последовательное чтение файла трассы.
+     */
+    class reader
+    {
+    public:
+        explicit reader(const char* path) : file(std::fopen(path, "rb"))
+        {
+            char header[sizeof(magic)];
+            if (file && (std::fread(header, 1, sizeof(header), file) != sizeof(header) ||
+                         std::memcmp(header, magic, sizeof(magic)) != 0))
+            {
+                std::fclose(file);
+                file = nullptr;
+            }
+        }
+
+        ~reader()
+        {
+            if (file)
+                std::fclose(file);
+        }
+
+        reader(const reader&) = delete;
+        reader& operator=(const reader&) = delete;
+
+        bool valid() const { return file != nullptr; }
+
+        bool next(event& ev)
+        {
+            int op = file ? std::fgetc(file) : EOF;
+            int kind = op == EOF ? EOF : std::fgetc(file);
+            if (kind == EOF)
+                return false;
+
+            ev.op = static_cast<op_type>(op);
+            ev.kind = static_cast<key_kind>(kind);
+            std::uint64_t id = 0, delta = 0;
+            if (!get_varint(id) || !get_varint(delta))
+                return false;
+            ev.map_id = static_cast<std::uint32_t>(id);
+            timestamp += delta;
+            ev.timestamp_ns = timestamp;
+
+            switch (ev.kind)
+            {
+                case key_kind::none:
+                    return true;
+                case key_kind::integer:
+                {
+                    std::uint64_t v = 0;
+                    if (!get_varint(v))
+                        return false;
+                    ev.int_key = unzigzag(v);
+                    return true;
+                }
+                case key_kind::bytes:
+                {
+                    std::uint64_t len = 0;
+                    if (!get_varint(len))
+                        return false;
+                    ev.bytes_key.resize(len);
+                    return std::fread(ev.bytes_key.data(), 1, len, file) == len;
+                }
+                case key_kind::hash:
+                {
+                    unsigned char raw[8];
+                    if (std::fread(raw, 1, 8, file) != 8)
+                        return false;
+                    ev.hash_key = 0;
+                    for (int i = 0; i < 8; ++i)
+                        ev.hash_key |= static_cast<std::uint64_t>(raw[i]) << (8 * i);
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        bool get_varint(std::uint64_t& v)
+        {
+            v = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                int c = std::fgetc(file);
+                if (c == EOF)
+                    return false;
+                v |= static_cast<std::uint64_t>(c & 0x7F) << shift;
+                if (!(c & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        std::FILE* file;
+        std::uint64_t timestamp = 0;
+    };
+
+} // namespace trace
+} // namespace mystl
+
+#endif // MAP_TRACE_HPP
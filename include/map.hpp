@@ -2,6 +2,7 @@
 #define map_HPP
 
 #include "red-black-tree.hpp"
+#include "hot-key-sampler.hpp"
 #include <functional>
 #include <iterator>
 #include <stdexcept>
@@ -9,8 +10,21 @@
 #include <limits>
 #include <algorithm>
 #include <initializer_list>
+#include <memory_resource>
 #include <type_traits>
 
+#ifdef MYSTL_MAP_TRACE
+#include "map-trace.hpp"
+// Запись операции в трассу (см. map-trace.hpp); без MYSTL_MAP_TRACE макрос пустой
+#define MYSTL_MAP_TRACE_OP(op, key) \
+    ::mystl::trace::scope mystl_trace_scope_(::mystl::trace::op_type::op, trace_id, key)
+// Пользовательский код внутри операции (обработчик бюджета) пишет свои операции в трассу
+#define MYSTL_MAP_TRACE_SUSPEND() ::mystl::trace::suspend mystl_trace_suspend_(trace_id)
+#else
+#define MYSTL_MAP_TRACE_OP(op, key) ((void)0)
+#define MYSTL_MAP_TRACE_SUSPEND() ((void)0)
+#endif
+
 /**
  * EBO (Empty Base Optimization) – приём, позволяющий хранить объекты пустых типов,
  * не занимая дополнительного места в памяти, путём наследования от них.
@@ -43,9 +57,29 @@ struct EBO<T, false>
 };
 
 namespace mystl {
+    /**
+     * Исключение вставки сверх бюджета памяти карты (см. map::set_memory_budget).
+     */
+    class memory_budget_exceeded : public std::length_error 
+    {
+    public:
+        using std::length_error::length_error;
+    };
+
+    /**
+     * Stats – политика статистики дерева (см. red-black-tree.hpp). По умолчанию
+     * NullTreeStats ничего не считает; с TreeCounters map::stats() дополнительно
+     * возвращает счётчики сравнений, поворотов, перекрашиваний и т.д.
+     *
+     * Layout – раскладка узла: PlainNodeLayout, CachedKeyPrefix (первые 8 байт
+     * строкового ключа в узле, чтобы поиск реже читал буфер строки) или OutOfLineValues
+     * (пары в отдельных блоках, в узле – ключ и указатель, для больших T).
+     */
     template <typename Key, typename T,
               typename Compare = std::less<Key>,
-              typename Allocator = std::allocator<std::pair<const Key, T>>>
+              typename Allocator = std::allocator<std::pair<const Key, T>>,
+              typename Stats = NullTreeStats,
+              typename Layout = PlainNodeLayout>
     class map : private EBO<Compare>,
                 private EBO<Allocator>
     {
@@ -55,14 +89,77 @@ namespace mystl {
         const Compare& get_compare() const { return static_cast<const EBO<Compare>&>(*this).get(); }
         Compare& get_compare() { return static_cast<EBO<Compare>&>(*this).get(); }
 
-        const Allocator& get_allocator() const { return static_cast<const EBO<Allocator>&>(*this).get(); }
-        Allocator& get_allocator() { return static_cast<EBO<Allocator>&>(*this).get(); }
+        const Allocator& alloc_ref() const { return static_cast<const EBO<Allocator>&>(*this).get(); }
+        Allocator& alloc_ref() { return static_cast<EBO<Allocator>&>(*this).get(); }
+
+        using tree_type = RedBlackTree<Key, T, Compare, Allocator, Stats, Layout>;
+        using alloc_traits = std::allocator_traits<Allocator>;
+
+        tree_type tree;
+
+        // Бюджет памяти в байтах (0 – без ограничения) и обработчик его превышения
+        std::size_t budget_bytes = 0;
+        std::function<void(map&, std::size_t)> on_budget_exceeded;
+        bool evicting = false;
+
+        // Наблюдатель ключей поиска (например, hot_key_sampler); nullptr – выключен
+        key_observer<Key>* key_sampler = nullptr;
+
+#ifdef MYSTL_MAP_TRACE
+        std::uint32_t trace_id = trace::recorder::next_map_id();
+#endif
+
+        tree_type init_tree() 
+        {
+            return tree_type(get_compare(), alloc_ref());
+        }
 
-        RedBlackTree<Key, T, Compare, Allocator> tree;
+        // Освобождает место под bytes: вызывает обработчик вытеснения, а если его
+        // нет или он не справился – бросает memory_budget_exceeded. Возвращает true,
+        // если обработчик вызывался и дерево могло измениться
+        bool reserve_budget(std::size_t bytes) 
+        {
+            if (tree.memoryUsage() + bytes <= budget_bytes)
+                return false;
+            bool called = false;
+            if (on_budget_exceeded && !evicting) 
+            {
+                evicting = true;
+                try {
+                    MYSTL_MAP_TRACE_SUSPEND();
+                    called = true;
+                    on_budget_exceeded(*this, tree.memoryUsage() + bytes - budget_bytes);
+                } catch (...) {
+                    evicting = false;
+                    throw;
+                }
+                evicting = false;
+            }
+            if (tree.memoryUsage() + bytes > budget_bytes)
+                throw memory_budget_exceeded("map memory budget exceeded");
+            return called;
+        }
+
+        // Вставка на место pos, найденное locate(value.first), с учётом бюджета: место
+        // ищется заново, только если обработчик вытеснения изменил дерево
+        std::pair<typename tree_type::Node*, bool> insert_at(typename tree_type::InsertPosition pos,
+                                                            const std::pair<const Key, T>& value)
+        {
+            if (pos.found)
+                return {pos.node, false};
+            if (budget_bytes && reserve_budget(tree_type::nodeBytes(value))) 
+            {
+                pos = tree.locate(value.first);
+                if (pos.found)
+                    return {pos.node, false};
+            }
+            return {tree.insertAt(pos, value), true};
+        }
 
-        RedBlackTree<Key, T, Compare, Allocator> init_tree() 
+        // Вставка с учётом бюджета; возвращает узел с ключом без повторного поиска
+        std::pair<typename tree_type::Node*, bool> insert_node(const std::pair<const Key, T>& value)
         {
-            return RedBlackTree<Key, T, Compare, Allocator>(get_compare(), get_allocator());
+            return insert_at(tree.locate(value.first), value);
         }
 
     public:
@@ -77,7 +174,8 @@ namespace mystl {
         using pointer         = typename std::allocator_traits<Allocator>::pointer;
         using const_pointer   = typename std::allocator_traits<Allocator>::const_pointer;
 
-        using node_type       = typename RedBlackTree<Key, T, Compare, Allocator>::Node;
+        using node_type       = typename tree_type::Node;
+        using stats_type      = TreeStats<Stats>;
 
         using reference       = value_type&;
         using const_reference = const value_type&;
@@ -91,15 +189,16 @@ namespace mystl {
             using reference         = value_type&;
 
             node_type* node;
+            const tree_type* owner;   // нужен, чтобы --end() попал на последний узел
 
-            explicit iterator(node_type* n = nullptr) : node(n) {}
+            explicit iterator(node_type* n = nullptr, const tree_type* t = nullptr) : node(n), owner(t) {}
 
-            reference operator*() const { return node->data; }
-            pointer operator->() const { return &(node->data); }
+            reference operator*() const { return node->value(); }
+            pointer operator->() const { return &(node->value()); }
 
             iterator& operator++() 
             {
-                node = RedBlackTree<Key, T, Compare, Allocator>::successor(node);
+                node = tree_type::successor(node);
                 return *this;
             }
 
@@ -112,7 +211,7 @@ namespace mystl {
 
             iterator& operator--() 
             {
-                node = RedBlackTree<Key, T, Compare, Allocator>::predecessor(node);
+                node = node ? tree_type::predecessor(node) : owner->maxNode();
                 return *this;
             }
 
@@ -140,17 +239,18 @@ namespace mystl {
             using reference         = const value_type&;
 
             node_type* node;
+            const tree_type* owner;
 
-            explicit const_iterator(node_type* n = nullptr) : node(n) {}
+            explicit const_iterator(node_type* n = nullptr, const tree_type* t = nullptr) : node(n), owner(t) {}
 
-            const_iterator(const iterator& it) : node(it.node) {}
+            const_iterator(const iterator& it) : node(it.node), owner(it.owner) {}
 
-            reference operator*() const { return node->data; }
-            pointer operator->() const { return &(node->data); }
+            reference operator*() const { return node->value(); }
+            pointer operator->() const { return &(node->value()); }
 
             const_iterator& operator++() 
             {
-                node = RedBlackTree<Key, T, Compare, Allocator>::successor(node);
+                node = tree_type::successor(node);
                 return *this;
             }
             const_iterator operator++(int) 
@@ -162,7 +262,7 @@ namespace mystl {
 
             const_iterator& operator--() 
             {
-                node = RedBlackTree<Key, T, Compare, Allocator>::predecessor(node);
+                node = node ? tree_type::predecessor(node) : owner->maxNode();
                 return *this;
             }
             const_iterator operator--(int) 
@@ -202,10 +302,16 @@ namespace mystl {
 
         ~map() = default;
 
+        // Бюджет памяти и обработчик вытеснения копируются и переносятся вместе с элементами.
+        // Наблюдатель ключей (attach_sampler) относится к самому объекту: копирование его
+        // не передаёт (копия создаётся без него, присваивание сохраняет свой), перенос – передаёт,
+        // и источник остаётся без наблюдателя: одного наблюдателя не кормят две карты
         map(const map& other)
             : EBO<Compare>(other.get_compare()),
-              EBO<Allocator>(other.get_allocator()),
-              tree(other.tree)
+              EBO<Allocator>(alloc_traits::select_on_container_copy_construction(other.alloc_ref())),
+              tree(other.tree),
+              budget_bytes(other.budget_bytes),
+              on_budget_exceeded(other.on_budget_exceeded)
         {}
 
         map& operator=(const map& other) 
@@ -213,8 +319,18 @@ namespace mystl {
             if (this != &other) 
             {
                 clear();
-                for (auto it = other.begin(); it != other.end(); ++it)
-                    insert(*it);
+                budget_bytes = other.budget_bytes;
+                on_budget_exceeded = other.on_budget_exceeded;
+                if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+                {
+                    alloc_ref() = other.alloc_ref();
+                    tree = other.tree;
+                }
+                else
+                {
+                    for (auto it = other.begin(); it != other.end(); ++it)
+                        insert(*it);
+                }
             }
 
             return *this;
@@ -223,29 +339,41 @@ namespace mystl {
         map(map&& other) noexcept
             : EBO<Compare>(std::move(static_cast<EBO<Compare>&>(other).get())),
               EBO<Allocator>(std::move(static_cast<EBO<Allocator>&>(other).get())),
-              tree(std::move(other.tree)) {}
-
-        map& operator=(map&& other) noexcept 
+              tree(std::move(other.tree)),
+              budget_bytes(other.budget_bytes),
+              on_budget_exceeded(std::move(other.on_budget_exceeded)),
+              key_sampler(std::exchange(other.key_sampler, nullptr)) {}
+
+        // Без propagate_on_container_move_assignment и при разных аллокаторах (разные
+        // std::pmr-ресурсы) элементы копируются в свой ресурс, а other очищается
+        map& operator=(map&& other) 
+            noexcept(alloc_traits::propagate_on_container_move_assignment::value || alloc_traits::is_always_equal::value)
         {
             if (this != &other) 
             {
-                clear();
+                if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+                    alloc_ref() = std::move(other.alloc_ref());
                 tree = std::move(other.tree);
+                budget_bytes = other.budget_bytes;
+                on_budget_exceeded = std::move(other.on_budget_exceeded);
+                key_sampler = std::exchange(other.key_sampler, nullptr);
             }
 
             return *this;
         }
 
+        allocator_type get_allocator() const noexcept { return alloc_ref(); }
+
         // -- ИТЕРАТОРЫ --
 
-        iterator begin() { return iterator(tree.minNode()); }
-        iterator end()   { return iterator(nullptr); }
+        iterator begin() { return iterator(tree.minNode(), &tree); }
+        iterator end()   { return iterator(nullptr, &tree); }
 
-        const_iterator begin() const { return const_iterator(tree.minNode()); }
-        const_iterator end() const   { return const_iterator(nullptr); }
+        const_iterator begin() const { return const_iterator(tree.minNode(), &tree); }
+        const_iterator end() const   { return const_iterator(nullptr, &tree); }
 
-        const_iterator cbegin() const { return const_iterator(tree.minNode()); }
-        const_iterator cend() const   { return const_iterator(nullptr); }
+        const_iterator cbegin() const { return const_iterator(tree.minNode(), &tree); }
+        const_iterator cend() const   { return const_iterator(nullptr, &tree); }
 
         reverse_iterator rbegin() { return reverse_iterator(end()); }
         reverse_iterator rend()   { return reverse_iterator(begin()); }
@@ -264,36 +392,116 @@ namespace mystl {
 
         size_type max_size() const { return std::numeric_limits<size_type>::max(); }
 
+        // -- СТАТИСТИКА --
+
+        // Форма дерева (высота, чёрная высота, глубины узлов) и счётчики политики Stats
+        stats_type stats() const { return tree.collectStats(); }
+
+        void reset_stats() { tree.resetStats(); }
+
+        // -- ПАМЯТЬ --
+
+        using eviction_callback = std::function<void(map&, size_type)>;
+
+        // Живые байты: узлы дерева плюс внешние буферы ключей и значений (mystl::heap_usage)
+        size_type memory_usage() const { return tree.memoryUsage(); }
+
+        // Внешние буферы учитываются на момент вставки; после изменения значений на месте
+        // точное значение восстанавливается обходом за O(n)
+        void recompute_memory_usage() { tree.recomputeMemoryUsage(); }
+
+        // Байты под узлы, выделенные reserve() или освобождённые в блоке compact(), но пока
+        // не занятые элементами. В memory_usage() и бюджет памяти не входят
+        size_type reserved_bytes() const { return tree.reservedBytes(); }
+
+        /**
+         * Переносит узлы, разбросанные по куче долгой серией вставок и удалений, в один
+         * непрерывный блок в порядке order (по умолчанию ван Эмде Боаса). Форма дерева
+         * не меняется; итераторы и ссылки на элементы после вызова недействительны.
+         * Узлы, удалённые из блока позже, переиспользуются вставками. O(n) времени и
+         * временно вдвое больше памяти под узлы.
+         */
+        void compact(CompactOrder order = CompactOrder::VanEmdeBoas) { tree.compact(order); }
+
+        /**
+         * Готовит место под n элементов: недостающие узлы выделяются одним блоком,
+         * и вставки до n элементов не обращаются к аллокатору. Освобождённые узлы блока
+         * остаются в резерве карты до clear(), compact() или shrink_to_fit().
+         */
+        void reserve(size_type n) { tree.reserve(n); }
+
+        // Сколько элементов поместится без обращения к аллокатору
+        size_type capacity() const { return tree.capacity(); }
+
+        // Отдаёт неиспользованный резерв; если он был, узлы переезжают как в compact()
+        // и итераторы становятся недействительными
+        void shrink_to_fit() { tree.shrinkToFit(); }
+
+        /**
+         * Ограничивает memory_usage() значением bytes (0 снимает ограничение).
+         * Бюджет считает только живые байты: резерв reserve() и compact() (см. reserved_bytes())
+         * в него не входит, и вставка в зарезервированный узел расходует бюджет как обычная.
+         * Вставка сверх бюджета вызывает on_exceeded(*this, сколько_байт_не_хватает),
+         * который может удалить элементы; если места всё равно нет (или обработчика нет),
+         * бросается memory_budget_exceeded и карта не меняется.
+         */
+        void set_memory_budget(size_type bytes, eviction_callback on_exceeded = nullptr) 
+        {
+            budget_bytes = bytes;
+            on_budget_exceeded = std::move(on_exceeded);
+        }
+
+        size_type memory_budget() const { return budget_bytes; }
+
+        // -- СЭМПЛИРОВАНИЕ КЛЮЧЕЙ --
+
+        /**
+         * Подключает наблюдателя, которому find(), at() и operator[] передают ключ
+         * каждого поиска (nullptr отключает). Карта не владеет наблюдателем;
+         * копирование его не передаёт, перенос и swap – передают (после переноса
+         * у источника наблюдателя нет).
+         */
+        void attach_sampler(key_observer<Key>* sampler) { key_sampler = sampler; }
+
+        key_observer<Key>* sampler() const { return key_sampler; }
+
+        // Проверка свойств красно-чёрного дерева (для отладки и fuzz-тестов)
+        bool validate() { return tree.validate(); }
+
         // -- ОПЕРАЦИИ ДОСТУПА --
 
         mapped_type& operator[](const key_type& key) 
         {
-            auto it = find(key);
-            if (it == end()) 
-            {
-                insert(std::make_pair(key, mapped_type()));
-                it = find(key);
-            }
-
-            return it.node->data.second;
+            MYSTL_MAP_TRACE_OP(access, &key);
+            if (key_sampler)
+                key_sampler->observe(key);
+            auto pos = tree.locate(key);
+            node_type* node = pos.found ? pos.node : insert_at(pos, std::make_pair(key, mapped_type())).first;
+            return node->value().second;
         }
 
         mapped_type& at(const key_type& key) 
         {
+            MYSTL_MAP_TRACE_OP(find, &key);
             auto it = find(key);
             if (it == end())
                 throw std::out_of_range("Key not found");
-            return it.node->data.second;
+            return it.node->value().second;
         }
 
         const mapped_type& at(const key_type& key) const {
+            MYSTL_MAP_TRACE_OP(find, &key);
             auto it = find(key);
             if (it == end())
                 throw std::out_of_range("Key not found");
-            return it.node->data.second;
+            return it.node->value().second;
         }
 
-        void insert(const value_type& value) { tree.insertNode(value); }
+        void insert(const value_type& value) 
+        {
+            MYSTL_MAP_TRACE_OP(insert, &value.first);
+            insert_node(value);
+        }
 
         void emplace(const key_type& key, const mapped_type& value) { insert(std::make_pair(key, value)); }
 
@@ -304,7 +512,11 @@ namespace mystl {
                 insert(*it);
         }
 
-        void erase(const key_type& key) { tree.removeNode(key); }
+        void erase(const key_type& key) 
+        {
+            MYSTL_MAP_TRACE_OP(erase, &key);
+            tree.removeNode(key);
+        }
 
         iterator erase(iterator pos) {
             if (pos == end()) return pos;
@@ -334,19 +546,25 @@ namespace mystl {
             return count;
         }
 
-        void clear() { tree.clear(); }
+        void clear() 
+        {
+            MYSTL_MAP_TRACE_OP(clear, static_cast<const key_type*>(nullptr));
+            tree.clear();
+        }
 
         void insert_or_assign(const key_type& key, const mapped_type& value) 
         {
-            auto it = find(key);
-            if (it != end())
-                it.node->data.second = value;
+            MYSTL_MAP_TRACE_OP(assign, &key);
+            auto pos = tree.locate(key);
+            if (pos.found)
+                pos.node->value().second = value;
             else
-                insert(std::make_pair(key, value));
+                insert_at(pos, std::make_pair(key, value));
         }
 
         iterator emplace_hint(iterator /*hint*/, const value_type& value) 
         {
+            MYSTL_MAP_TRACE_OP(insert, &value.first);
             insert(value);
             return find(value.first);
         }
@@ -354,16 +572,17 @@ namespace mystl {
         template <typename... Args>
         std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) 
         {
-            auto it = find(key);
-            if (it != end())
-                return {it, false};
+            MYSTL_MAP_TRACE_OP(insert, &key);
+            auto pos = tree.locate(key);
+            if (pos.found)
+                return {iterator(pos.node, &tree), false};
             mapped_type value(std::forward<Args>(args)...);
-            insert(std::make_pair(key, value));
-            return {find(key), true};
+            return {iterator(insert_at(pos, std::make_pair(key, value)).first, &tree), true};
         }
 
         value_type extract(const key_type& key) 
         {
+            MYSTL_MAP_TRACE_OP(erase, &key);
             auto it = find(key);
             if (it == end())
                 throw std::out_of_range("Key not found");
@@ -393,20 +612,41 @@ namespace mystl {
             }
         }
 
-        iterator find(const key_type& key) { return iterator(tree.find(key)); }
-        const_iterator find(const key_type& key) const { return const_iterator(tree.find(key)); }
+        iterator find(const key_type& key) 
+        {
+            MYSTL_MAP_TRACE_OP(find, &key);
+            if (key_sampler)
+                key_sampler->observe(key);
+            return iterator(tree.find(key), &tree);
+        }
+        const_iterator find(const key_type& key) const 
+        {
+            MYSTL_MAP_TRACE_OP(find, &key);
+            if (key_sampler)
+                key_sampler->observe(key);
+            return const_iterator(tree.find(key), &tree);
+        }
 
-        size_type count(const key_type& key) const { return tree.find(key) ? 1 : 0; }
+        size_type count(const key_type& key) const 
+        {
+            MYSTL_MAP_TRACE_OP(find, &key);
+            return tree.find(key) ? 1 : 0;
+        }
 
-        bool contains(const key_type& key) const { return tree.find(key) != nullptr; }
+        bool contains(const key_type& key) const 
+        {
+            MYSTL_MAP_TRACE_OP(find, &key);
+            return tree.find(key) != nullptr;
+        }
 
         iterator lower_bound(const key_type& key) 
         {
+            MYSTL_MAP_TRACE_OP(lower_bound, &key);
             auto current = tree.getRoot();
             node_type* candidate = nullptr;
             while (current) 
             {
-                if (!get_compare()(current->data.first, key)) 
+                if (!get_compare()(current->key(), key)) 
                 {
                     candidate = current;
                     current = current->left;
@@ -416,15 +656,16 @@ namespace mystl {
                     current = current->right;
                 }
             }
-            return iterator(candidate);
+            return iterator(candidate, &tree);
         }
         const_iterator lower_bound(const key_type& key) const 
         {
+            MYSTL_MAP_TRACE_OP(lower_bound, &key);
             auto current = tree.getRoot();
             node_type* candidate = nullptr;
             while (current) 
             {
-                if (!get_compare()(current->data.first, key)) 
+                if (!get_compare()(current->key(), key)) 
                 {
                     candidate = current;
                     current = current->left;
@@ -434,16 +675,17 @@ namespace mystl {
                     current = current->right;
                 }
             }
-            return const_iterator(candidate);
+            return const_iterator(candidate, &tree);
         }
 
         iterator upper_bound(const key_type& key) 
         {
+            MYSTL_MAP_TRACE_OP(upper_bound, &key);
             auto current = tree.getRoot();
             node_type* candidate = nullptr;
             while (current) 
             {
-                if (get_compare()(key, current->data.first)) 
+                if (get_compare()(key, current->key())) 
                 {
                     candidate = current;
                     current = current->left;
@@ -453,15 +695,16 @@ namespace mystl {
                     current = current->right;
                 }
             }
-            return iterator(candidate);
+            return iterator(candidate, &tree);
         }
         const_iterator upper_bound(const key_type& key) const 
         {
+            MYSTL_MAP_TRACE_OP(upper_bound, &key);
             auto current = tree.getRoot();
             node_type* candidate = nullptr;
             while (current) 
             {
-                if (get_compare()(key, current->data.first)) 
+                if (get_compare()(key, current->key())) 
                 {
                     candidate = current;
                     current = current->left;
@@ -471,7 +714,7 @@ namespace mystl {
                     current = current->right;
                 }
             }
-            return const_iterator(candidate);
+            return const_iterator(candidate, &tree);
         }
 
         key_compare key_comp() const { return get_compare(); }
@@ -513,9 +756,36 @@ namespace mystl {
         friend bool operator>(const map& lhs, const map& rhs) { return rhs < lhs; }
         friend bool operator>=(const map& lhs, const map& rhs) { return !(lhs < rhs); }
 
-        void swap(map& other) { std::swap(tree, other.tree); }
+        void swap(map& other) noexcept 
+        {
+            using std::swap;
+            tree.swap(other.tree);
+            swap(get_compare(), other.get_compare());
+            swap(budget_bytes, other.budget_bytes);
+            swap(on_budget_exceeded, other.on_budget_exceeded);
+            swap(key_sampler, other.key_sampler);
+            if constexpr (alloc_traits::propagate_on_container_swap::value)
+                swap(alloc_ref(), other.alloc_ref());
+        }
     };
 
+    namespace pmr {
+
+        /**
+         * mystl::map на std::pmr::polymorphic_allocator: узлы берутся из memory_resource,
+         * а ключи и значения с pmr-аллокатором (std::pmr::string и т.п.) получают тот же ресурс.
+         *
+         *   std::pmr::monotonic_buffer_resource pool;
+         *   mystl::pmr::map<std::pmr::string, int> m(&pool);
+         */
+        template <typename Key, typename T,
+                  typename Compare = std::less<Key>,
+                  typename Stats = NullTreeStats,
+                  typename Layout = PlainNodeLayout>
+        using map = mystl::map<Key, T, Compare, std::pmr::polymorphic_allocator<std::pair<const Key, T>>, Stats, Layout>;
+
+    } // namespace pmr
+
 } // namespace mystl
 
 #endif // map_HPP
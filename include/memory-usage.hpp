@@ -0,0 +1,62 @@
+#ifndef MEMORY_USAGE_HPP
+#define MEMORY_USAGE_HPP
+
+#include <cstddef>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace mystl {
+
+    /**
+     * Точка расширения для учёта памяти: сколько байт объект держит вне себя
+     * (в куче). По умолчанию 0. Для своих типов достаточно специализации:
+     *
+     *   template <> struct mystl::heap_usage<Order> {
+     *       std::size_t operator()(const Order& o) const { return o.payload.capacity(); }
+     *   };
+     */
+    template <typename T, typename = void>
+    struct heap_usage
+    {
+        std::size_t operator()(const T&) const noexcept { return 0; }
+    };
+
+    template <typename CharT, typename Traits, typename Alloc>
+    struct heap_usage<std::basic_string<CharT, Traits, Alloc>>
+    {
+        std::size_t operator()(const std::basic_string<CharT, Traits, Alloc>& s) const noexcept
+        {
+            // Короткая строка живёт во внутреннем буфере (SSO) и кучу не использует
+            const char* self = reinterpret_cast<const char*>(&s);
+            const char* data = reinterpret_cast<const char*>(s.data());
+            if (data >= self && data < self + sizeof(s))
+                return 0;
+            return (s.capacity() + 1) * sizeof(CharT);
+        }
+    };
+
+    template <typename U, typename Alloc>
+    struct heap_usage<std::vector<U, Alloc>>
+    {
+        std::size_t operator()(const std::vector<U, Alloc>& v) const noexcept
+        {
+            std::size_t bytes = v.capacity() * sizeof(U);
+            for (const auto& item : v)
+                bytes += heap_usage<U>{}(item);
+            return bytes;
+        }
+    };
+
+    template <typename A, typename B>
+    struct heap_usage<std::pair<A, B>>
+    {
+        std::size_t operator()(const std::pair<A, B>& p) const noexcept
+        {
+            return heap_usage<std::remove_const_t<A>>{}(p.first) + heap_usage<std::remove_const_t<B>>{}(p.second);
+        }
+    };
+
+} // namespace mystl
+
+#endif // MEMORY_USAGE_HPP
@@ -0,0 +1,267 @@
+#ifndef NODE_CACHE_HPP
+#define NODE_CACHE_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace mystl {
+
+    // Обращения потоков к общим пулам (под мьютексом) по всем размерам блоков
+    struct node_pool_stats
+    {
+        std::size_t chunks = 0;     // блоков памяти, взятых у operator new
+        std::size_t refills = 0;    // пакетов, выданных локальным кэшам
+        std::size_t flushes = 0;    // пакетов, возвращённых локальными кэшами
+    };
+
+    namespace detail {
+
+        inline std::atomic<std::size_t> pool_chunks{0};
+        inline std::atomic<std::size_t> pool_refills{0};
+        inline std::atomic<std::size_t> pool_flushes{0};
+
+        // Свободный блок; next_batch используется только у первого блока пакета в пуле
+        struct free_block
+        {
+            free_block* next;
+            free_block* next_batch;
+        };
+
+        /**
+         * Общий пул блоков размера Size: стек пакетов ровно по Batch блоков (каждый – односвязный
+         * список, пакеты сцеплены через первый блок) под одним мьютексом. Память берётся
+         * у operator new кусками по Batch блоков и возвращается только при завершении программы.
+         * Остатки кэшей завершившихся потоков собираются в loose, пока не наберётся полный пакет.
+         */
+        template <std::size_t Size, std::size_t Align, std::size_t Batch>
+        class node_pool
+        {
+        public:
+            static node_pool& instance()
+            {
+                static node_pool pool;
+                return pool;
+            }
+
+            node_pool(const node_pool&) = delete;
+            node_pool& operator=(const node_pool&) = delete;
+
+            ~node_pool()
+            {
+                for (void* chunk : chunks)
+                    ::operator delete(chunk, std::align_val_t(Align));
+            }
+
+            // Пакет из Batch блоков: готовый из пула или нарезанный из нового куска
+            free_block* take()
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pool_refills.fetch_add(1, std::memory_order_relaxed);
+                if (batches)
+                {
+                    free_block* head = batches;
+                    batches = head->next_batch;
+                    return head;
+                }
+                chunks.reserve(chunks.size() + 1);
+                char* chunk = static_cast<char*>(::operator new(Size * Batch, std::align_val_t(Align)));
+                chunks.push_back(chunk);
+                pool_chunks.fetch_add(1, std::memory_order_relaxed);
+                free_block* head = nullptr;
+                for (std::size_t i = Batch; i-- > 0;)
+                    head = ::new (chunk + i * Size) free_block{head, nullptr};
+                return head;
+            }
+
+            // Принимает пакет ровно из Batch блоков
+            void give(free_block* head) noexcept
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pool_flushes.fetch_add(1, std::memory_order_relaxed);
+                head->next_batch = batches;
+                batches = head;
+            }
+
+            // Принимает список любой длины: блоки по одному переходят в loose, полные пакеты – в стек
+            void give_partial(free_block* head) noexcept
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                pool_flushes.fetch_add(1, std::memory_order_relaxed);
+                while (head)
+                {
+                    free_block* next = head->next;
+                    head->next = loose;
+                    loose = head;
+                    if (++loose_count == Batch)
+                    {
+                        loose->next_batch = batches;
+                        batches = loose;
+                        loose = nullptr;
+                        loose_count = 0;
+                    }
+                    head = next;
+                }
+            }
+
+        private:
+            node_pool() = default;
+
+            std::mutex mutex;
+            free_block* batches = nullptr;
+            free_block* loose = nullptr;
+            std::size_t loose_count = 0;
+            std::vector<void*> chunks;
+        };
+
+        /**
+         * Кэш одного потока: стек свободных блоков без синхронизации. Пустой кэш берёт
+         * пакет у пула; когда в кэше накопилось 2 * Batch блоков, Batch из них уходят
+         * в пул одним списком. При завершении потока всё оставшееся (от 0 до 2 * Batch - 1
+         * блоков) возвращается в пул через give_partial, так что в стеке пула лежат только
+         * полные пакеты и count после take() равен Batch.
+         */
+        template <std::size_t Size, std::size_t Align, std::size_t Batch>
+        class node_cache
+        {
+            using pool_type = node_pool<Size, Align, Batch>;
+
+        public:
+            static node_cache& local()
+            {
+                thread_local node_cache cache;
+                return cache;
+            }
+
+            node_cache(const node_cache&) = delete;
+            node_cache& operator=(const node_cache&) = delete;
+
+            ~node_cache()
+            {
+                if (head)
+                    pool.give_partial(head);
+            }
+
+            void* allocate()
+            {
+                if (!head)
+                {
+                    head = pool.take();
+                    count = Batch;
+                }
+                free_block* b = head;
+                head = b->next;
+                --count;
+                return b;
+            }
+
+            void deallocate(void* p) noexcept
+            {
+                head = ::new (p) free_block{head, nullptr};
+                if (++count >= 2 * Batch)
+                    flush();
+            }
+
+        private:
+            // Пул создаётся раньше кэша и поэтому разрушается позже
+            node_cache() : pool(pool_type::instance()) {}
+
+            pool_type& pool;
+            free_block* head = nullptr;
+            std::size_t count = 0;
+
+            // Отделяет Batch блоков с вершины стека и отдаёт их пулу
+            void flush() noexcept
+            {
+                free_block* first = head;
+                free_block* last = head;
+                for (std::size_t i = 1; i < Batch; ++i)
+                    last = last->next;
+                head = last->next;
+                last->next = nullptr;
+                count -= Batch;
+                pool.give(first);
+            }
+        };
+
+    } // namespace detail
+
+    inline node_pool_stats thread_cache_stats() noexcept
+    {
+        return {detail::pool_chunks.load(std::memory_order_relaxed),
+                detail::pool_refills.load(std::memory_order_relaxed),
+                detail::pool_flushes.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * Аллокатор узлов с кэшем свободных блоков в каждом потоке. Одиночные выделения
+     * (узлы дерева) берутся из thread_local стека без блокировок; обмен с общим пулом
+     * идёт пакетами по BatchSize блоков, так что мьютекс пула захватывается не чаще
+     * раза на BatchSize выделений или освобождений. Выделения n > 1 идут в operator new.
+     *
+     * Аллокатор не хранит состояния: блок, выделенный в одном потоке, можно освободить
+     * в другом – он попадёт в кэш освобождающего потока. Память пула не возвращается
+     * системе до завершения программы, поэтому пик числа узлов определяет её объём.
+     * Потоки, использующие аллокатор, должны завершиться раньше статических деструкторов.
+     *
+     *   using Alloc = mystl::thread_cached_allocator<std::pair<const std::uint64_t, std::uint64_t>>;
+     *   mystl::map<std::uint64_t, std::uint64_t, std::less<std::uint64_t>, Alloc> m;
+     */
+    template <typename T, std::size_t BatchSize = 64>
+    class thread_cached_allocator
+    {
+        static_assert(BatchSize > 0, "BatchSize must be positive");
+
+        static constexpr std::size_t block_align = std::max(alignof(T), alignof(detail::free_block));
+        static constexpr std::size_t block_size =
+            (std::max(sizeof(T), sizeof(detail::free_block)) + block_align - 1) / block_align * block_align;
+
+        using cache_type = detail::node_cache<block_size, block_align, BatchSize>;
+
+    public:
+        using value_type = T;
+        using is_always_equal = std::true_type;
+
+        template <typename U>
+        struct rebind
+        {
+            using other = thread_cached_allocator<U, BatchSize>;
+        };
+
+        thread_cached_allocator() noexcept = default;
+
+        template <typename U>
+        thread_cached_allocator(const thread_cached_allocator<U, BatchSize>&) noexcept {}
+
+        T* allocate(std::size_t n)
+        {
+            if (n == 1)
+                return static_cast<T*>(cache_type::local().allocate());
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+                throw std::bad_array_new_length();
+            return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept
+        {
+            if (n == 1)
+                cache_type::local().deallocate(p);
+            else
+                ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+
+        template <typename U>
+        friend bool operator==(const thread_cached_allocator&, const thread_cached_allocator<U, BatchSize>&) noexcept { return true; }
+
+        template <typename U>
+        friend bool operator!=(const thread_cached_allocator&, const thread_cached_allocator<U, BatchSize>&) noexcept { return false; }
+    };
+
+} // namespace mystl
+
+#endif // NODE_CACHE_HPP
@@ -0,0 +1,1303 @@
+#ifndef RADIX_MAP_HPP
+#define RADIX_MAP_HPP
+
+#include "memory-usage.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace mystl {
+
+    /**
+     * Точка расширения radix_map: побайтовое представление ключа, порядок которого
+     * (побайтовое сравнение без знака, при общем начале короткий ключ меньше)
+     * совпадает с std::less<Key>. encode() возвращает объект с data() и size(),
+     * живущий не дольше самого ключа.
+     */
+    template <typename Key, typename = void>
+    struct radix_key;
+
+    // Целые числа: big-endian, у знаковых инвертирован старший бит
+    template <typename Key>
+    struct radix_key<Key, std::enable_if_t<std::is_integral_v<Key> && !std::is_same_v<Key, bool>>>
+    {
+        using encoded_type = std::array<unsigned char, sizeof(Key)>;
+
+        static encoded_type encode(Key key)
+        {
+            using U = std::make_unsigned_t<Key>;
+            U bits = static_cast<U>(key);
+            if constexpr (std::is_signed_v<Key>)
+                bits ^= static_cast<U>(U(1) << (sizeof(Key) * 8 - 1));
+            encoded_type out;
+            for (std::size_t i = sizeof(Key); i-- > 0; )
+            {
+                out[i] = static_cast<unsigned char>(bits & 0xFF);
+                bits = static_cast<U>(bits >> 8);
+            }
+            return out;
+        }
+    };
+
+    // Строки уже упорядочены побайтово (char_traits<char>::lt сравнивает как unsigned char)
+    template <>
+    struct radix_key<std::string>
+    {
+        using encoded_type = std::string_view;
+
+        static encoded_type encode(const std::string& key) { return key; }
+    };
+
+    /**
+     * Упорядоченная карта на адаптивном радиксном дереве (ART, Leis et al., ICDE 2013).
+     * Ключ раскладывается в байты через radix_key<Key>, и спуск идёт по одному байту
+     * на уровень без сравнений ключей целиком: глубина зависит от длины ключа, а не от
+     * числа элементов. Внутренние узлы меняют размер по числу детей (4, 16, 48, 256),
+     * общие части ключей хранятся один раз (сжатие префиксов).
+     *
+     * Ключ может быть началом другого ключа (строки "ab" и "abc"): такой лист хранится
+     * в поле value внутреннего узла и идёт раньше всех его детей.
+     *
+     * Листы дополнительно связаны в двусвязный список по порядку ключей, поэтому
+     * итераторы двунаправленные, ++it – O(1), а *it даёт настоящий value_type&.
+     * Итераторы остаются действительными до удаления их элемента, как у mystl::map.
+     */
+    template <typename Key, typename T,
+              typename Allocator = std::allocator<std::pair<const Key, T>>>
+    class radix_map
+    {
+    private:
+        using key_traits   = radix_key<Key>;
+        using encoded_type = typename key_traits::encoded_type;
+
+    public:
+        using key_type        = Key;
+        using mapped_type     = T;
+        using value_type      = std::pair<const Key, T>;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using allocator_type  = Allocator;
+        using reference       = value_type&;
+        using const_reference = const value_type&;
+
+    private:
+        struct list_node
+        {
+            list_node* prev;
+            list_node* next;
+        };
+
+        enum class node_kind : std::uint8_t { leaf, node4, node16, node48, node256 };
+
+        struct node_base
+        {
+            node_kind kind;
+
+            explicit node_base(node_kind k) : kind(k) {}
+        };
+
+        struct leaf : node_base, list_node
+        {
+            value_type data;
+
+            template <typename... Args>
+            explicit leaf(Args&&... args)
+                : node_base(node_kind::leaf), list_node{nullptr, nullptr}, data(std::forward<Args>(args)...) {}
+        };
+
+        // Сколько байт префикса хранится в узле; остальное читается из ключа любого листа поддерева
+        static constexpr std::size_t max_prefix = 10;
+
+        struct inner : node_base
+        {
+            std::uint16_t count = 0;           // число детей
+            std::uint32_t prefix_len = 0;      // длина сжатого префикса
+            unsigned char prefix[max_prefix];
+            leaf* value = nullptr;             // ключ, который заканчивается на этом узле
+
+            explicit inner(node_kind k) : node_base(k) {}
+        };
+
+        struct node4 : inner
+        {
+            unsigned char keys[4];
+            node_base* children[4];
+
+            node4() : inner(node_kind::node4) {}
+        };
+
+        struct node16 : inner
+        {
+            unsigned char keys[16];
+            node_base* children[16];
+
+            node16() : inner(node_kind::node16) {}
+        };
+
+        struct node48 : inner
+        {
+            unsigned char index[256] = {};     // 0 – нет ребёнка, иначе номер слота + 1
+            node_base* children[48] = {};
+
+            node48() : inner(node_kind::node48) {}
+        };
+
+        struct node256 : inner
+        {
+            node_base* children[256] = {};
+
+            node256() : inner(node_kind::node256) {}
+        };
+
+    public:
+        template <bool Const>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = std::conditional_t<Const, const std::pair<const Key, T>, std::pair<const Key, T>>;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = value_type*;
+            using reference         = value_type&;
+
+            list_node* node = nullptr;
+
+            basic_iterator() = default;
+            explicit basic_iterator(list_node* n) : node(n) {}
+
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other) : node(other.node) {}
+
+            reference operator*() const { return static_cast<leaf*>(node)->data; }
+            pointer operator->() const { return &static_cast<leaf*>(node)->data; }
+
+            basic_iterator& operator++() { node = node->next; return *this; }
+            basic_iterator& operator--() { node = node->prev; return *this; }
+            basic_iterator operator++(int) { basic_iterator tmp(*this); node = node->next; return tmp; }
+            basic_iterator operator--(int) { basic_iterator tmp(*this); node = node->prev; return tmp; }
+
+            bool operator==(const basic_iterator& other) const { return node == other.node; }
+            bool operator!=(const basic_iterator& other) const { return node != other.node; }
+        };
+
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        radix_map() { head.prev = head.next = &head; }
+
+        explicit radix_map(const Allocator& alloc) : alloc(alloc) { head.prev = head.next = &head; }
+
+        radix_map(std::initializer_list<value_type> init, const Allocator& alloc = Allocator())
+            : radix_map(alloc)
+        {
+            insert_range(init.begin(), init.end());
+        }
+
+        radix_map(const radix_map& other)
+            : radix_map(std::allocator_traits<Allocator>::select_on_container_copy_construction(other.alloc))
+        {
+            // Вставка по возрастанию: каждый новый лист – последний в списке
+            for (const auto& kv : other)
+                insert(kv);
+        }
+
+        radix_map(radix_map&& other) noexcept
+            : alloc(std::move(other.alloc))
+        {
+            head.prev = head.next = &head;
+            steal(other);
+        }
+
+        radix_map& operator=(const radix_map& other)
+        {
+            if (this != &other)
+            {
+                radix_map copy(other);
+                swap(copy);
+            }
+            return *this;
+        }
+
+        // Как у RedBlackTree: узлы забираются, если аллокатор переносится или аллокаторы равны,
+        // иначе элементы копируются в свой аллокатор
+        radix_map& operator=(radix_map&& other)
+            noexcept(std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value ||
+                     std::allocator_traits<Allocator>::is_always_equal::value)
+        {
+            if (this == &other)
+                return *this;
+
+            clear();
+            if constexpr (std::allocator_traits<Allocator>::propagate_on_container_move_assignment::value)
+            {
+                alloc = std::move(other.alloc);
+                steal(other);
+            }
+            else if (alloc == other.alloc)
+                steal(other);
+            else
+            {
+                for (const auto& kv : other)
+                    insert(kv);
+                other.clear();
+            }
+            return *this;
+        }
+
+        ~radix_map() { clear(); }
+
+        // -- ИТЕРАТОРЫ --
+
+        iterator begin() { return iterator(head.next); }
+        iterator end()   { return iterator(&head); }
+
+        const_iterator begin() const { return const_iterator(head.next); }
+        const_iterator end() const   { return const_iterator(const_cast<list_node*>(&head)); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const   { return end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const   { return rend(); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return element_count == 0; }
+
+        size_type size() const { return element_count; }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max(); }
+
+        // Байты листов и внутренних узлов плюс внешние буферы ключей и значений (mystl::heap_usage)
+        size_type memory_usage() const { return node_bytes + external_bytes; }
+
+        allocator_type get_allocator() const { return alloc; }
+
+        // -- ОПЕРАЦИИ ДОСТУПА --
+
+        mapped_type& operator[](const key_type& key) { return try_emplace(key).first->second; }
+
+        mapped_type& at(const key_type& key)
+        {
+            leaf* l = find_leaf(key_traits::encode(key));
+            if (!l)
+                throw std::out_of_range("Key not found");
+            return l->data.second;
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            leaf* l = find_leaf(key_traits::encode(key));
+            if (!l)
+                throw std::out_of_range("Key not found");
+            return l->data.second;
+        }
+
+        // -- МОДИФИКАЦИЯ --
+
+        void insert(const value_type& value)
+        {
+            emplace_leaf(value.first, [&] { return create<leaf>(value); });
+        }
+
+        void emplace(const key_type& key, const mapped_type& value) { try_emplace(key, value); }
+
+        template <typename InputIt>
+        void insert_range(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        void insert_or_assign(const key_type& key, const mapped_type& value)
+        {
+            auto result = try_emplace(key, value);
+            if (!result.second)
+                result.first->second = value;
+        }
+
+        iterator emplace_hint(const_iterator /*hint*/, const value_type& value)
+        {
+            return iterator(emplace_leaf(value.first, [&] { return create<leaf>(value); }).first);
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            auto result = emplace_leaf(key, [&]
+            {
+                return create<leaf>(std::piecewise_construct, std::forward_as_tuple(key),
+                                    std::forward_as_tuple(std::forward<Args>(args)...));
+            });
+            return {iterator(result.first), result.second};
+        }
+
+        void erase(const key_type& key)
+        {
+            if (leaf* l = detach(key_traits::encode(key)))
+                destroy_leaf(l);
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            list_node* next = pos.node->next;
+            erase(static_cast<leaf*>(pos.node)->data.first);
+            return iterator(next);
+        }
+
+        iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+        template <typename Predicate>
+        size_type erase_if(Predicate pred)
+        {
+            size_type count = 0;
+            for (auto it = begin(); it != end(); )
+            {
+                if (pred(*it))
+                {
+                    it = erase(it);
+                    ++count;
+                }
+                else
+                    ++it;
+            }
+            return count;
+        }
+
+        void clear()
+        {
+            destroy_subtree(root);
+            root = nullptr;
+            head.prev = head.next = &head;
+            element_count = 0;
+            node_bytes = 0;
+            external_bytes = 0;
+        }
+
+        value_type extract(const key_type& key)
+        {
+            leaf* l = detach(key_traits::encode(key));
+            if (!l)
+                throw std::out_of_range("Key not found");
+            release_bytes(l);
+            value_type val(std::move(const_cast<Key&>(l->data.first)), std::move(l->data.second));
+            dispose(l);
+            --element_count;
+            return val;
+        }
+
+        void merge(radix_map& source)
+        {
+            if (&source == this)
+                return;
+            for (auto it = source.begin(); it != source.end(); )
+            {
+                if (!contains(it->first))
+                {
+                    insert(*it);
+                    it = source.erase(it);
+                }
+                else
+                    ++it;
+            }
+        }
+
+        void swap(radix_map& other)
+        {
+            if (this == &other)
+                return;
+            radix_map tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        // -- ПОИСК --
+
+        iterator find(const key_type& key)
+        {
+            leaf* l = find_leaf(key_traits::encode(key));
+            return l ? iterator(l) : end();
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            leaf* l = find_leaf(key_traits::encode(key));
+            return l ? const_iterator(l) : end();
+        }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const { return find_leaf(key_traits::encode(key)) != nullptr; }
+
+        iterator lower_bound(const key_type& key) { return iterator(lower_leaf(key_traits::encode(key), false)); }
+        const_iterator lower_bound(const key_type& key) const { return const_iterator(lower_leaf(key_traits::encode(key), false)); }
+
+        iterator upper_bound(const key_type& key) { return iterator(lower_leaf(key_traits::encode(key), true)); }
+        const_iterator upper_bound(const key_type& key) const { return const_iterator(lower_leaf(key_traits::encode(key), true)); }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key) { return {lower_bound(key), upper_bound(key)}; }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        friend bool operator==(const radix_map& lhs, const radix_map& rhs)
+        {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const radix_map& lhs, const radix_map& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const radix_map& lhs, const radix_map& rhs)
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+        friend bool operator<=(const radix_map& lhs, const radix_map& rhs) { return !(rhs < lhs); }
+        friend bool operator>(const radix_map& lhs, const radix_map& rhs) { return rhs < lhs; }
+        friend bool operator>=(const radix_map& lhs, const radix_map& rhs) { return !(lhs < rhs); }
+
+    private:
+        node_base* root = nullptr;
+        list_node head;                     // страж списка листов: head.next – первый, head.prev – последний
+        size_type element_count = 0;
+        size_type node_bytes = 0;
+        size_type external_bytes = 0;
+        [[no_unique_address]] Allocator alloc;
+
+        // -- ПАМЯТЬ --
+
+        template <typename Node, typename... Args>
+        Node* create(Args&&... args)
+        {
+            using node_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+            using traits = std::allocator_traits<node_alloc>;
+            node_alloc a(alloc);
+            Node* p = traits::allocate(a, 1);
+            try {
+                traits::construct(a, p, std::forward<Args>(args)...);
+            } catch (...) {
+                traits::deallocate(a, p, 1);
+                throw;
+            }
+            node_bytes += sizeof(Node);
+            if constexpr (std::is_same_v<Node, leaf>)
+                external_bytes += externalBytes(p->data);
+            return p;
+        }
+
+        template <typename Node>
+        void dispose(Node* p)
+        {
+            using node_alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+            using traits = std::allocator_traits<node_alloc>;
+            node_alloc a(alloc);
+            traits::destroy(a, p);
+            traits::deallocate(a, p, 1);
+            node_bytes -= sizeof(Node);
+        }
+
+        static std::size_t externalBytes(const value_type& val)
+        {
+            return heap_usage<Key>{}(val.first) + heap_usage<T>{}(val.second);
+        }
+
+        // Значение могло измениться после вставки, поэтому не уходим ниже нуля
+        void release_bytes(leaf* l)
+        {
+            std::size_t bytes = externalBytes(l->data);
+            external_bytes -= bytes < external_bytes ? bytes : external_bytes;
+        }
+
+        void destroy_leaf(leaf* l)
+        {
+            release_bytes(l);
+            dispose(l);
+            --element_count;
+        }
+
+        void destroy_inner(inner* n)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:   dispose(static_cast<node4*>(n)); break;
+                case node_kind::node16:  dispose(static_cast<node16*>(n)); break;
+                case node_kind::node48:  dispose(static_cast<node48*>(n)); break;
+                default:                 dispose(static_cast<node256*>(n)); break;
+            }
+        }
+
+        // Глубина рекурсии ограничена числом ветвлений на пути, а не размером карты
+        void destroy_subtree(node_base* n)
+        {
+            if (!n)
+                return;
+            if (n->kind == node_kind::leaf)
+            {
+                dispose(static_cast<leaf*>(n));
+                return;
+            }
+            inner* in = static_cast<inner*>(n);
+            if (in->value)
+                dispose(in->value);
+            for_each_child(in, [&](unsigned char, node_base* child) { destroy_subtree(child); });
+            destroy_inner(in);
+        }
+
+        void steal(radix_map& other)
+        {
+            root = std::exchange(other.root, nullptr);
+            element_count = std::exchange(other.element_count, 0);
+            node_bytes = std::exchange(other.node_bytes, 0);
+            external_bytes = std::exchange(other.external_bytes, 0);
+            if (element_count)
+            {
+                head.next = other.head.next;
+                head.prev = other.head.prev;
+                head.next->prev = &head;
+                head.prev->next = &head;
+            }
+            other.head.prev = other.head.next = &other.head;
+        }
+
+        // -- СПИСОК ЛИСТОВ --
+
+        void link_before(leaf* l, list_node* pos)
+        {
+            list_node* node = l;
+            node->next = pos;
+            node->prev = pos->prev;
+            pos->prev->next = node;
+            pos->prev = node;
+            ++element_count;
+        }
+
+        static void unlink(leaf* l)
+        {
+            list_node* node = l;
+            node->prev->next = node->next;
+            node->next->prev = node->prev;
+        }
+
+        list_node* first_leaf_or_end(node_base* subtree)
+        {
+            return subtree ? static_cast<list_node*>(minimum(subtree)) : &head;
+        }
+
+        list_node* first_leaf_or_end(node_base* subtree) const
+        {
+            return subtree ? static_cast<list_node*>(minimum(subtree)) : const_cast<list_node*>(&head);
+        }
+
+        // -- КЛЮЧИ --
+
+        static unsigned char byte_at(const encoded_type& key, std::size_t i)
+        {
+            return static_cast<unsigned char>(key.data()[i]);
+        }
+
+        static bool equal_keys(const encoded_type& a, const encoded_type& b)
+        {
+            return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size()) == 0;
+        }
+
+        // Байтовое сравнение: < 0, 0 или > 0
+        static int compare_keys(const encoded_type& a, const encoded_type& b)
+        {
+            std::size_t n = std::min<std::size_t>(a.size(), b.size());
+            if (int c = n ? std::memcmp(a.data(), b.data(), n) : 0)
+                return c;
+            return a.size() < b.size() ? -1 : (a.size() > b.size() ? 1 : 0);
+        }
+
+        static leaf* minimum(node_base* n)
+        {
+            while (n->kind != node_kind::leaf)
+            {
+                inner* in = static_cast<inner*>(n);
+                if (in->value)
+                    return in->value;
+                n = first_child(in);
+            }
+            return static_cast<leaf*>(n);
+        }
+
+        // i-й байт префикса узла, который начинается с байта depth ключа
+        static unsigned char prefix_byte(inner* n, std::size_t depth, std::size_t i)
+        {
+            if (i < max_prefix)
+                return n->prefix[i];
+            return byte_at(key_traits::encode(minimum(n)->data.first), depth + i);
+        }
+
+        /**
+         * Позиция первого расхождения префикса узла с ключом начиная с depth
+         * (prefix_len, если префикс совпал целиком; конец ключа – тоже расхождение).
+         * Байты дальше max_prefix сверяются с ключом самого левого листа поддерева.
+         */
+        static std::size_t prefix_mismatch(inner* n, const encoded_type& key, std::size_t depth)
+        {
+            std::size_t len = n->prefix_len;
+            std::size_t avail = key.size() - depth;
+            std::size_t stored = std::min(len, max_prefix);
+            std::size_t i = 0;
+            for (; i < stored; ++i)
+                if (i >= avail || n->prefix[i] != byte_at(key, depth + i))
+                    return i;
+            if (len > max_prefix)
+            {
+                auto full = key_traits::encode(minimum(n)->data.first);
+                for (; i < len; ++i)
+                    if (i >= avail || byte_at(full, depth + i) != byte_at(key, depth + i))
+                        return i;
+            }
+            return len;
+        }
+
+        // -- ДЕТИ ВНУТРЕННИХ УЗЛОВ --
+
+        static node_base** find_child(inner* n, unsigned char b)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:
+                {
+                    node4* nn = static_cast<node4*>(n);
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        if (nn->keys[i] == b)
+                            return &nn->children[i];
+                    return nullptr;
+                }
+                case node_kind::node16:
+                {
+                    node16* nn = static_cast<node16*>(n);
+#if defined(__SSE2__)
+                    __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8(static_cast<char>(b)),
+                                                 _mm_loadu_si128(reinterpret_cast<const __m128i*>(nn->keys)));
+                    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(cmp)) & ((1u << nn->count) - 1);
+                    return mask ? &nn->children[__builtin_ctz(mask)] : nullptr;
+#else
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        if (nn->keys[i] == b)
+                            return &nn->children[i];
+                    return nullptr;
+#endif
+                }
+                case node_kind::node48:
+                {
+                    node48* nn = static_cast<node48*>(n);
+                    return nn->index[b] ? &nn->children[nn->index[b] - 1] : nullptr;
+                }
+                default:
+                {
+                    node256* nn = static_cast<node256*>(n);
+                    return nn->children[b] ? &nn->children[b] : nullptr;
+                }
+            }
+        }
+
+        // Ребёнок с наименьшим байтом больше b (nullptr, если такого нет)
+        static node_base* next_child(inner* n, unsigned char b)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:
+                {
+                    node4* nn = static_cast<node4*>(n);
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        if (nn->keys[i] > b)
+                            return nn->children[i];
+                    return nullptr;
+                }
+                case node_kind::node16:
+                {
+                    node16* nn = static_cast<node16*>(n);
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        if (nn->keys[i] > b)
+                            return nn->children[i];
+                    return nullptr;
+                }
+                case node_kind::node48:
+                {
+                    node48* nn = static_cast<node48*>(n);
+                    for (unsigned i = b + 1u; i < 256; ++i)
+                        if (nn->index[i])
+                            return nn->children[nn->index[i] - 1];
+                    return nullptr;
+                }
+                default:
+                {
+                    node256* nn = static_cast<node256*>(n);
+                    for (unsigned i = b + 1u; i < 256; ++i)
+                        if (nn->children[i])
+                            return nn->children[i];
+                    return nullptr;
+                }
+            }
+        }
+
+        static node_base* first_child(inner* n)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:  return static_cast<node4*>(n)->children[0];
+                case node_kind::node16: return static_cast<node16*>(n)->children[0];
+                case node_kind::node48:
+                {
+                    node48* nn = static_cast<node48*>(n);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->index[i])
+                            return nn->children[nn->index[i] - 1];
+                    return nullptr;
+                }
+                default:
+                {
+                    node256* nn = static_cast<node256*>(n);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->children[i])
+                            return nn->children[i];
+                    return nullptr;
+                }
+            }
+        }
+
+        // Вызывает f(байт, ребёнок) для всех детей по возрастанию байта
+        template <typename F>
+        static void for_each_child(inner* n, F&& f)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:
+                {
+                    node4* nn = static_cast<node4*>(n);
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        f(nn->keys[i], nn->children[i]);
+                    break;
+                }
+                case node_kind::node16:
+                {
+                    node16* nn = static_cast<node16*>(n);
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        f(nn->keys[i], nn->children[i]);
+                    break;
+                }
+                case node_kind::node48:
+                {
+                    node48* nn = static_cast<node48*>(n);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->index[i])
+                            f(static_cast<unsigned char>(i), nn->children[nn->index[i] - 1]);
+                    break;
+                }
+                default:
+                {
+                    node256* nn = static_cast<node256*>(n);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->children[i])
+                            f(static_cast<unsigned char>(i), nn->children[i]);
+                    break;
+                }
+            }
+        }
+
+        static void copy_header(inner* to, const inner* from)
+        {
+            to->prefix_len = from->prefix_len;
+            std::memcpy(to->prefix, from->prefix, std::min<std::size_t>(from->prefix_len, max_prefix));
+            to->value = from->value;
+        }
+
+        // Вставка в отсортированный массив node4/node16 (место гарантировано)
+        template <typename Node>
+        static void sorted_insert(Node* n, unsigned char b, node_base* child)
+        {
+            unsigned i = 0;
+            while (i < n->count && n->keys[i] < b)
+                ++i;
+            std::memmove(n->keys + i + 1, n->keys + i, n->count - i);
+            std::memmove(n->children + i + 1, n->children + i, (n->count - i) * sizeof(node_base*));
+            n->keys[i] = b;
+            n->children[i] = child;
+            ++n->count;
+        }
+
+        template <typename Node>
+        static void sorted_remove(Node* n, unsigned char b)
+        {
+            unsigned i = 0;
+            while (n->keys[i] != b)
+                ++i;
+            std::memmove(n->keys + i, n->keys + i + 1, n->count - i - 1);
+            std::memmove(n->children + i, n->children + i + 1, (n->count - i - 1) * sizeof(node_base*));
+            --n->count;
+        }
+
+        static void node48_insert(node48* n, unsigned char b, node_base* child)
+        {
+            unsigned slot = 0;
+            while (n->children[slot])
+                ++slot;
+            n->children[slot] = child;
+            n->index[b] = static_cast<unsigned char>(slot + 1);
+            ++n->count;
+        }
+
+        // Добавляет ребёнка; заполненный узел заменяется следующим по размеру (ref – ссылка на узел)
+        void add_child(node_base*& ref, inner* n, unsigned char b, node_base* child)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:
+                {
+                    node4* nn = static_cast<node4*>(n);
+                    if (nn->count < 4)
+                    {
+                        sorted_insert(nn, b, child);
+                        return;
+                    }
+                    node16* bigger = create<node16>();
+                    copy_header(bigger, nn);
+                    for (unsigned i = 0; i < 4; ++i)
+                        sorted_insert(bigger, nn->keys[i], nn->children[i]);
+                    sorted_insert(bigger, b, child);
+                    ref = bigger;
+                    dispose(nn);
+                    return;
+                }
+                case node_kind::node16:
+                {
+                    node16* nn = static_cast<node16*>(n);
+                    if (nn->count < 16)
+                    {
+                        sorted_insert(nn, b, child);
+                        return;
+                    }
+                    node48* bigger = create<node48>();
+                    copy_header(bigger, nn);
+                    for (unsigned i = 0; i < 16; ++i)
+                        node48_insert(bigger, nn->keys[i], nn->children[i]);
+                    node48_insert(bigger, b, child);
+                    ref = bigger;
+                    dispose(nn);
+                    return;
+                }
+                case node_kind::node48:
+                {
+                    node48* nn = static_cast<node48*>(n);
+                    if (nn->count < 48)
+                    {
+                        node48_insert(nn, b, child);
+                        return;
+                    }
+                    node256* bigger = create<node256>();
+                    copy_header(bigger, nn);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->index[i])
+                            bigger->children[i] = nn->children[nn->index[i] - 1];
+                    bigger->children[b] = child;
+                    bigger->count = 49;
+                    ref = bigger;
+                    dispose(nn);
+                    return;
+                }
+                default:
+                {
+                    node256* nn = static_cast<node256*>(n);
+                    nn->children[b] = child;
+                    ++nn->count;
+                    return;
+                }
+            }
+        }
+
+        /**
+         * Удаляет ребёнка b. Узел уменьшается с запасом (256 -> 48 при 36 детях, 48 -> 16 при 12,
+         * 16 -> 4 при 3), чтобы вставки и удаления на границе не перестраивали его каждый раз;
+         * node4 с единственным потомком сливается с ним.
+         */
+        void remove_child(node_base*& ref, inner* n, unsigned char b)
+        {
+            switch (n->kind)
+            {
+                case node_kind::node4:
+                {
+                    sorted_remove(static_cast<node4*>(n), b);
+                    collapse(ref, static_cast<node4*>(n));
+                    return;
+                }
+                case node_kind::node16:
+                {
+                    node16* nn = static_cast<node16*>(n);
+                    sorted_remove(nn, b);
+                    if (nn->count > 3)
+                        return;
+                    node4* smaller = create<node4>();
+                    copy_header(smaller, nn);
+                    for (unsigned i = 0; i < nn->count; ++i)
+                        sorted_insert(smaller, nn->keys[i], nn->children[i]);
+                    ref = smaller;
+                    dispose(nn);
+                    return;
+                }
+                case node_kind::node48:
+                {
+                    node48* nn = static_cast<node48*>(n);
+                    nn->children[nn->index[b] - 1] = nullptr;
+                    nn->index[b] = 0;
+                    --nn->count;
+                    if (nn->count > 12)
+                        return;
+                    node16* smaller = create<node16>();
+                    copy_header(smaller, nn);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->index[i])
+                            sorted_insert(smaller, static_cast<unsigned char>(i), nn->children[nn->index[i] - 1]);
+                    ref = smaller;
+                    dispose(nn);
+                    return;
+                }
+                default:
+                {
+                    node256* nn = static_cast<node256*>(n);
+                    nn->children[b] = nullptr;
+                    --nn->count;
+                    if (nn->count > 36)
+                        return;
+                    node48* smaller = create<node48>();
+                    copy_header(smaller, nn);
+                    for (unsigned i = 0; i < 256; ++i)
+                        if (nn->children[i])
+                            node48_insert(smaller, static_cast<unsigned char>(i), nn->children[i]);
+                    ref = smaller;
+                    dispose(nn);
+                    return;
+                }
+            }
+        }
+
+        // node4 без детей заменяется своим листом value, с одним ребёнком и без value – ребёнком
+        void collapse(node_base*& ref, node4* n)
+        {
+            if (n->count + (n->value ? 1 : 0) > 1)
+                return;
+            if (n->count == 0)
+            {
+                ref = n->value;
+            }
+            else
+            {
+                node_base* child = n->children[0];
+                if (child->kind != node_kind::leaf)
+                {
+                    // Префикс ребёнка = префикс узла + байт ребёнка + собственный префикс ребёнка
+                    inner* c = static_cast<inner*>(child);
+                    unsigned char merged[max_prefix];
+                    std::size_t k = 0;
+                    for (std::size_t i = 0; i < std::min<std::size_t>(n->prefix_len, max_prefix) && k < max_prefix; ++i)
+                        merged[k++] = n->prefix[i];
+                    if (k < max_prefix)
+                        merged[k++] = n->keys[0];
+                    for (std::size_t i = 0; i < std::min<std::size_t>(c->prefix_len, max_prefix) && k < max_prefix; ++i)
+                        merged[k++] = c->prefix[i];
+                    c->prefix_len = n->prefix_len + 1 + c->prefix_len;
+                    std::memcpy(c->prefix, merged, k);
+                }
+                ref = child;
+            }
+            dispose(n);
+        }
+
+        // -- ОПЕРАЦИИ ДЕРЕВА --
+
+        /**
+         * Поиск с «оптимистичной» проверкой префиксов: байты дальше max_prefix пропускаются,
+         * а ключ найденного листа сверяется целиком.
+         */
+        leaf* find_leaf(const encoded_type& key) const
+        {
+            node_base* n = root;
+            std::size_t depth = 0;
+            while (n)
+            {
+                if (n->kind == node_kind::leaf)
+                {
+                    leaf* l = static_cast<leaf*>(n);
+                    return equal_keys(key_traits::encode(l->data.first), key) ? l : nullptr;
+                }
+                inner* in = static_cast<inner*>(n);
+                std::size_t len = in->prefix_len;
+                if (key.size() - depth < len)
+                    return nullptr;
+                for (std::size_t i = 0, stored = std::min(len, max_prefix); i < stored; ++i)
+                    if (in->prefix[i] != byte_at(key, depth + i))
+                        return nullptr;
+                depth += len;
+                if (depth == key.size())
+                {
+                    leaf* l = in->value;
+                    return l && equal_keys(key_traits::encode(l->data.first), key) ? l : nullptr;
+                }
+                node_base** child = find_child(in, byte_at(key, depth));
+                if (!child)
+                    return nullptr;
+                n = *child;
+                ++depth;
+            }
+            return nullptr;
+        }
+
+        /**
+         * Первый лист с ключом >= key (> key при strict) или страж. По пути запоминается
+         * ближайшее поддерево правее пути спуска: если в текущем поддереве подходящего
+         * ключа нет, ответ – самый левый лист этого поддерева.
+         */
+        list_node* lower_leaf(const encoded_type& key, bool strict) const
+        {
+            node_base* n = root;
+            node_base* right = nullptr;
+            std::size_t depth = 0;
+            while (n)
+            {
+                if (n->kind == node_kind::leaf)
+                {
+                    leaf* l = static_cast<leaf*>(n);
+                    int c = compare_keys(key_traits::encode(l->data.first), key);
+                    return c > 0 || (c == 0 && !strict) ? static_cast<list_node*>(l) : first_leaf_or_end(right);
+                }
+                inner* in = static_cast<inner*>(n);
+                std::size_t p = prefix_mismatch(in, key, depth);
+                if (p < in->prefix_len)
+                {
+                    if (depth + p == key.size() || byte_at(key, depth + p) < prefix_byte(in, depth, p))
+                        return minimum(in);
+                    return first_leaf_or_end(right);
+                }
+                depth += p;
+                if (depth == key.size())
+                {
+                    // Все ключи поддерева начинаются с key; равным может быть только value
+                    if (strict && in->value)
+                        return static_cast<list_node*>(in->value)->next;
+                    return minimum(in);
+                }
+                unsigned char b = byte_at(key, depth);
+                if (node_base* next = next_child(in, b))
+                    right = next;
+                node_base** child = find_child(in, b);
+                if (!child)
+                    return first_leaf_or_end(right);
+                n = *child;
+                ++depth;
+            }
+            return first_leaf_or_end(right);
+        }
+
+        /**
+         * Вставляет лист, созданный make(), если ключа ещё нет. Как и в lower_leaf,
+         * по пути запоминается ближайшее поддерево правее: его самый левый лист –
+         * следующий за новым в списке.
+         */
+        template <typename Make>
+        std::pair<leaf*, bool> emplace_leaf(const key_type& k, Make&& make)
+        {
+            encoded_type key = key_traits::encode(k);
+            node_base** ref = &root;
+            node_base* right = nullptr;
+            std::size_t depth = 0;
+            while (true)
+            {
+                node_base* n = *ref;
+                if (!n)
+                {
+                    leaf* l = make();
+                    *ref = l;
+                    link_before(l, &head);
+                    return {l, true};
+                }
+
+                if (n->kind == node_kind::leaf)
+                {
+                    leaf* old = static_cast<leaf*>(n);
+                    auto oldKey = key_traits::encode(old->data.first);
+                    std::size_t p = depth;
+                    std::size_t limit = std::min<std::size_t>(key.size(), oldKey.size());
+                    while (p < limit && byte_at(key, p) == byte_at(oldKey, p))
+                        ++p;
+                    if (p == key.size() && p == oldKey.size())
+                        return {old, false};
+
+                    node4* split = create<node4>();
+                    leaf* l;
+                    try {
+                        l = make();
+                    } catch (...) {
+                        dispose(split);
+                        throw;
+                    }
+                    split->prefix_len = static_cast<std::uint32_t>(p - depth);
+                    for (std::size_t i = 0; i < std::min(p - depth, max_prefix); ++i)
+                        split->prefix[i] = byte_at(key, depth + i);
+                    place(split, old, oldKey, p);
+                    place(split, l, key, p);
+                    *ref = split;
+                    bool before = p == key.size() || (p < oldKey.size() && byte_at(key, p) < byte_at(oldKey, p));
+                    link_before(l, before ? static_cast<list_node*>(old) : first_leaf_or_end(right));
+                    return {l, true};
+                }
+
+                inner* in = static_cast<inner*>(n);
+                std::size_t p = prefix_mismatch(in, key, depth);
+                if (p < in->prefix_len)
+                {
+                    // Ключ расходится с префиксом: новый node4 над узлом с общей частью префикса
+                    node4* split = create<node4>();
+                    leaf* l;
+                    try {
+                        l = make();
+                    } catch (...) {
+                        dispose(split);
+                        throw;
+                    }
+                    leaf* first = minimum(in);
+                    auto firstKey = key_traits::encode(first->data.first);
+                    unsigned char branch = byte_at(firstKey, depth + p);
+
+                    split->prefix_len = static_cast<std::uint32_t>(p);
+                    std::memcpy(split->prefix, in->prefix, std::min(p, max_prefix));
+                    std::size_t rest = in->prefix_len - p - 1;
+                    for (std::size_t i = 0; i < std::min(rest, max_prefix); ++i)
+                        in->prefix[i] = byte_at(firstKey, depth + p + 1 + i);
+                    in->prefix_len = static_cast<std::uint32_t>(rest);
+
+                    sorted_insert(split, branch, in);
+                    bool before = depth + p == key.size();
+                    if (before)
+                        split->value = l;
+                    else
+                    {
+                        before = byte_at(key, depth + p) < branch;
+                        sorted_insert(split, byte_at(key, depth + p), l);
+                    }
+                    *ref = split;
+                    link_before(l, before ? static_cast<list_node*>(first) : first_leaf_or_end(right));
+                    return {l, true};
+                }
+
+                depth += p;
+                if (depth == key.size())
+                {
+                    if (in->value)
+                        return {in->value, false};
+                    leaf* l = make();
+                    in->value = l;
+                    link_before(l, minimum(first_child(in)));
+                    return {l, true};
+                }
+
+                unsigned char b = byte_at(key, depth);
+                if (node_base* next = next_child(in, b))
+                    right = next;
+                if (node_base** child = find_child(in, b))
+                {
+                    ref = child;
+                    ++depth;
+                    continue;
+                }
+
+                leaf* l = make();
+                try {
+                    add_child(*ref, in, b, l);
+                } catch (...) {
+                    release_bytes(l);
+                    dispose(l);
+                    throw;
+                }
+                link_before(l, first_leaf_or_end(right));
+                return {l, true};
+            }
+        }
+
+        // Кладёт лист в только что созданный node4 на позиции p его ключа
+        static void place(node4* split, leaf* l, const encoded_type& key, std::size_t p)
+        {
+            if (p == key.size())
+                split->value = l;
+            else
+                sorted_insert(split, byte_at(key, p), l);
+        }
+
+        // Вынимает лист с ключом из дерева и списка (но не освобождает); nullptr, если ключа нет
+        leaf* detach(const encoded_type& key)
+        {
+            node_base** ref = &root;
+            node_base** parentRef = nullptr;
+            unsigned char parentByte = 0;
+            std::size_t depth = 0;
+            while (node_base* n = *ref)
+            {
+                if (n->kind == node_kind::leaf)
+                {
+                    leaf* l = static_cast<leaf*>(n);
+                    if (!equal_keys(key_traits::encode(l->data.first), key))
+                        return nullptr;
+                    if (parentRef)
+                        remove_child(*parentRef, static_cast<inner*>(*parentRef), parentByte);
+                    else
+                        root = nullptr;
+                    unlink(l);
+                    return l;
+                }
+                inner* in = static_cast<inner*>(n);
+                std::size_t p = prefix_mismatch(in, key, depth);
+                if (p < in->prefix_len)
+                    return nullptr;
+                depth += p;
+                if (depth == key.size())
+                {
+                    leaf* l = in->value;
+                    if (!l)
+                        return nullptr;
+                    in->value = nullptr;
+                    if (in->kind == node_kind::node4)
+                        collapse(*ref, static_cast<node4*>(in));
+                    unlink(l);
+                    return l;
+                }
+                unsigned char b = byte_at(key, depth);
+                node_base** child = find_child(in, b);
+                if (!child)
+                    return nullptr;
+                parentRef = ref;
+                parentByte = b;
+                ref = child;
+                ++depth;
+            }
+            return nullptr;
+        }
+    };
+
+} // namespace mystl
+
+#endif // RADIX_MAP_HPP
@@ -1,13 +1,23 @@
 #ifndef REDBLACKTREE_HPP
 #define REDBLACKTREE_HPP
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <limits>
 #include <memory>
+#include <new>
 #include <functional>
+#include <string>
+#include <string_view>
 #include <utility>
 #include <type_traits>
+#include <vector>
+
+#include "memory-usage.hpp"
 
 enum Color { RED, BLACK };
 
@@ -19,32 +29,602 @@ struct is_transparent_helper : std::false_type {};
 template <typename C>
 struct is_transparent_helper<C, std::void_t<typename C::is_transparent>> : std::true_type {};
 
+/**
+ * Аллокатор с пустым deallocate (память возвращается разом вместе с ареной, см.
+ * mystl::arena_allocator) объявляет using is_monotonic = std::true_type. Тогда дерево
+ * с тривиально разрушаемыми Key и T очищается без обхода узлов.
+ */
+template <typename A, typename = void>
+struct is_monotonic_allocator : std::false_type {};
+
+template <typename A>
+struct is_monotonic_allocator<A, std::void_t<typename A::is_monotonic>> : A::is_monotonic {};
+
+/**
+ * Ключи, для которых годится CachedKeyPrefix: std::basic_string<char> с любым аллокатором
+ * (в том числе std::pmr::string) и std::string_view. У них std::less сравнивает байты как
+ * unsigned char, то есть в том же порядке, что и закэшированный префикс. const char* сюда
+ * не входит: std::less<const char*> сравнивает адреса, а не строки.
+ */
+template <typename Key>
+struct is_prefix_cacheable_string : std::false_type {};
+
+template <typename Alloc>
+struct is_prefix_cacheable_string<std::basic_string<char, std::char_traits<char>, Alloc>> : std::true_type {};
+
+template <>
+struct is_prefix_cacheable_string<std::string_view> : std::true_type {};
+
+/**
+ * Политика статистики по умолчанию: все обработчики пустые и вызовы исчезают
+ * после инлайнинга, а сам объект не занимает места ([[no_unique_address]]).
+ */
+struct NullTreeStats 
+{
+    static constexpr bool enabled = false;
+
+    void onComparison() {}
+    void onRotation() {}
+    void onRecolor() {}
+    void onFixupIteration() {}
+    void onAllocation() {}
+    void onDeallocation() {}
+    void onLookup(std::size_t) {}
+};
+
+/**
+ * Политика, подсчитывающая операции дерева. Подключается пятым параметром шаблона:
+ * RedBlackTree<Key, T, Compare, Allocator, TreeCounters> (или mystl::map с тем же параметром).
+ */
+struct TreeCounters 
+{
+    static constexpr bool enabled = true;
+
+    std::uint64_t comparisons = 0;
+    std::uint64_t rotations = 0;
+    std::uint64_t recolorings = 0;
+    std::uint64_t fixupIterations = 0;
+    std::uint64_t allocations = 0;
+    std::uint64_t deallocations = 0;
+    std::uint64_t lookups = 0;
+    std::uint64_t lookupDepthTotal = 0;   // сумма узлов, пройденных всеми поисками
+    std::uint64_t maxLookupDepth = 0;
+
+    void onComparison() { ++comparisons; }
+    void onRotation() { ++rotations; }
+    void onRecolor() { ++recolorings; }
+    void onFixupIteration() { ++fixupIterations; }
+    void onAllocation() { ++allocations; }
+    void onDeallocation() { ++deallocations; }
+    void onLookup(std::size_t depth) 
+    {
+        ++lookups;
+        lookupDepthTotal += depth;
+        if (depth > maxLookupDepth)
+            maxLookupDepth = depth;
+    }
+
+    double averageLookupDepth() const 
+    {
+        return lookups ? static_cast<double>(lookupDepthTotal) / static_cast<double>(lookups) : 0.0;
+    }
+};
+
+/**
+ * Форма дерева (вычисляется обходом) и копия счётчиков политики Stats.
+ * Глубина корня – 0, высота – число уровней (0 для пустого дерева).
+ */
+template <typename Stats>
+struct TreeStats 
+{
+    std::size_t size = 0;
+    std::size_t height = 0;
+    std::size_t blackHeight = 0;
+    double averageDepth = 0.0;
+    std::vector<std::size_t> depthHistogram;   // depthHistogram[d] – число узлов на глубине d
+    Stats counters;
+};
+
+/**
+ * Раскладка узла по умолчанию: только пара, цвет и три указателя.
+ */
+struct PlainNodeLayout 
+{
+    static constexpr bool cacheKeyPrefix = false;
+    static constexpr bool outOfLineValues = false;
+};
+
+/**
+ * Раскладка для строковых ключей: первые 8 байт ключа хранятся в узле как big-endian
+ * число. Если числа различаются, порядок ключей известен без обращения к буферу
+ * строки в куче; иначе строки сравниваются целиком. Требует Compare = std::less<Key>
+ * (или std::less<>) и Key – std::string (с любым аллокатором) или std::string_view.
+ * Узел больше на 8 байт.
+ */
+struct CachedKeyPrefix 
+{
+    static constexpr bool cacheKeyPrefix = true;
+    static constexpr bool outOfLineValues = false;
+};
+
+/**
+ * Раскладка для больших T: узел хранит копию ключа, цвет, связи и указатель на пару
+ * (Key, T), а сами пары лежат плотно в блоках значений дерева. Спуск читает только
+ * маленькие узлы, пара нужна лишь при разыменовании итератора. Ключ хранится дважды,
+ * поэтому раскладка выгодна, когда sizeof(T) заметно больше sizeof(Key). Пара не
+ * переезжает при compact(); свободные слоты значений возвращаются аллокатору в clear().
+ */
+struct OutOfLineValues 
+{
+    static constexpr bool cacheKeyPrefix = false;
+    static constexpr bool outOfLineValues = true;
+};
+
+/**
+ * Раскладка для значений, которые сами содержат ключ (Order{id, ...}): узел хранит
+ * одно значение T, а ключ получается проекцией KeyOf{}(value). Ключ не хранится
+ * второй раз, как в паре (Key, T). KeyOf – функтор без состояния, возвращающий
+ * ключ (лучше по ссылке на поле значения). Используется mystl::keyed_set.
+ */
+template <typename KeyOf>
+struct ProjectedKey 
+{
+    static constexpr bool cacheKeyPrefix = false;
+    static constexpr bool outOfLineValues = false;
+    using key_of = KeyOf;
+};
+
+// Проекция ключа раскладки: Layout::key_of или void, если значение – пара (Key, T)
+template <typename Layout, typename = void>
+struct layout_key_of { using type = void; };
+
+template <typename Layout>
+struct layout_key_of<Layout, std::void_t<typename Layout::key_of>> { using type = typename Layout::key_of; };
+
+// Первые 8 байт строки как big-endian число, недостающие байты – нули. Если числа
+// двух строк различаются, их порядок совпадает с порядком самих строк
+inline std::uint64_t keyPrefix(std::string_view key) 
+{
+    unsigned char bytes[8] = {};
+    std::memcpy(bytes, key.data(), key.size() < 8 ? key.size() : 8);
+    std::uint64_t prefix = 0;
+    for (unsigned char b : bytes)
+        prefix = (prefix << 8) | b;
+    return prefix;
+}
+
+/**
+ * Порядок узлов в памяти после RedBlackTree::compact():
+ * VanEmdeBoas – верхняя половина уровней любого поддерева, затем его нижние поддеревья,
+ * рекурсивно: спуск на любой глубине проходит по небольшому числу соседних блоков;
+ * DepthFirst – прямой обход: левый потомок лежит сразу за родителем, обход по порядку
+ * ключей идёт почти последовательно.
+ */
+enum class CompactOrder { VanEmdeBoas, DepthFirst };
+
+/**
+ * Значение узла: пара внутри узла (по умолчанию), указатель на пару плюс копия ключа
+ * (OutOfLineValues) или одно T с ключом-проекцией (ProjectedKey). Дерево обращается
+ * к ключу через key(), к значению – через value(), к ключу ещё не вставленного
+ * значения – через keyOf().
+ */
+template <typename Key, typename T, bool OutOfLine, typename KeyOf = void>
+struct NodeValue;
+
+template <typename Key, typename T>
+struct NodeValue<Key, T, false, void> 
+{
+    using value_type = std::pair<const Key, T>;
+
+    std::pair<const Key, T> data;
+
+    explicit NodeValue(const std::pair<const Key, T>& val) : data(val) {}
+
+    explicit NodeValue(std::pair<const Key, T>&& val) : data(std::move(val)) {}
+
+    template <typename A, typename V>
+    NodeValue(std::allocator_arg_t, const A& alloc, V&& val)
+        : data(std::make_obj_using_allocator<std::pair<const Key, T>>(alloc, std::forward<V>(val))) {}
+
+    const Key& key() const { return data.first; }
+
+    std::pair<const Key, T>& value() { return data; }
+    const std::pair<const Key, T>& value() const { return data; }
+
+    static const Key& keyOf(const value_type& val) { return val.first; }
+};
+
+template <typename Key, typename T>
+struct NodeValue<Key, T, true, void> 
+{
+    using value_type = std::pair<const Key, T>;
+
+    const Key storedKey;
+    std::pair<const Key, T>* slot;
+
+    explicit NodeValue(std::pair<const Key, T>* slot) : storedKey(slot->first), slot(slot) {}
+
+    template <typename A>
+    NodeValue(std::allocator_arg_t, const A& alloc, std::pair<const Key, T>* slot)
+        : storedKey(std::make_obj_using_allocator<Key>(alloc, slot->first)), slot(slot) {}
+
+    const Key& key() const { return storedKey; }
+
+    std::pair<const Key, T>& value() { return *slot; }
+    const std::pair<const Key, T>& value() const { return *slot; }
+
+    static const Key& keyOf(const value_type& val) { return val.first; }
+};
+
+template <typename Key, typename T, typename KeyOf>
+struct NodeValue<Key, T, false, KeyOf> 
+{
+    using value_type = T;
+
+    T data;
+
+    explicit NodeValue(const T& val) : data(val) {}
+
+    explicit NodeValue(T&& val) : data(std::move(val)) {}
+
+    template <typename A, typename V>
+    NodeValue(std::allocator_arg_t, const A& alloc, V&& val)
+        : data(std::make_obj_using_allocator<T>(alloc, std::forward<V>(val))) {}
+
+    decltype(auto) key() const { return KeyOf{}(data); }
+
+    T& value() { return data; }
+    const T& value() const { return data; }
+
+    static decltype(auto) keyOf(const T& val) { return KeyOf{}(val); }
+};
+
+template <bool Enabled>
+struct NodeKeyPrefix {};
+
+template <>
+struct NodeKeyPrefix<true> 
+{
+    std::uint64_t keyPrefix = 0;
+};
+
 template <typename Key, typename T, typename Compare = std::less<Key>,
-          typename Allocator = std::allocator<std::pair<const Key, T>>>
+          typename Allocator = std::allocator<std::pair<const Key, T>>,
+          typename Stats = NullTreeStats,
+          typename Layout = PlainNodeLayout>
 class RedBlackTree 
 {
+    static_assert(!Layout::cacheKeyPrefix
+                      || (is_prefix_cacheable_string<Key>::value
+                          && (std::is_same_v<Compare, std::less<Key>> || std::is_same_v<Compare, std::less<>>)),
+                  "CachedKeyPrefix needs a std::string or std::string_view Key ordered by std::less");
+
+    using key_of = typename layout_key_of<Layout>::type;
+    static constexpr bool projectedKey = !std::is_void_v<key_of>;
+    static_assert(!(projectedKey && Layout::outOfLineValues), "ProjectedKey stores values inline");
+
 public:
     struct Node;
 
-    struct Node 
+    using value_storage = NodeValue<Key, T, Layout::outOfLineValues, key_of>;
+    using value_type = typename value_storage::value_type;
+
+    struct Node : NodeKeyPrefix<Layout::cacheKeyPrefix>, value_storage
     {
-        std::pair<const Key, T> data;
         Color color;
         Node* left;
         Node* right;
         Node* parent;
 
-        explicit Node(const std::pair<const Key, T>& val)
-            : data(val), color(RED), left(nullptr), right(nullptr), parent(nullptr) {}
+        // Аллокаторы с uses-allocator конструированием (std::pmr::polymorphic_allocator,
+        // std::scoped_allocator_adaptor) передают себя в ключ и значение через конструктор
+        // с std::allocator_arg_t
+        using allocator_type = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+        // Аргументы – значение (const& или && при переносе в compact()) либо, для
+        // OutOfLineValues, указатель на пару в блоке значений
+        template <typename V>
+        explicit Node(V&& val)
+            : value_storage(std::forward<V>(val)), color(RED), left(nullptr), right(nullptr), parent(nullptr) 
+        {
+            if constexpr (Layout::cacheKeyPrefix)
+                this->keyPrefix = ::keyPrefix(this->key());
+        }
+
+        template <typename A, typename V>
+        Node(std::allocator_arg_t, const A& alloc, V&& val)
+            : value_storage(std::allocator_arg, alloc, std::forward<V>(val)),
+              color(RED), left(nullptr), right(nullptr), parent(nullptr) 
+        {
+            if constexpr (Layout::cacheKeyPrefix)
+                this->keyPrefix = ::keyPrefix(this->key());
+        }
     };
 
 private:
     Node* root;
     Compare comp;
+    [[no_unique_address]] mutable Stats stats;
 
     using NodeAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+    using NodeAllocTraits = std::allocator_traits<NodeAllocator>;
     NodeAllocator node_alloc;
 
+    // Обход при очистке ничего бы не сделал: деструкторы тривиальны, deallocate пуст
+    static constexpr bool skipClearWalk =
+        is_monotonic_allocator<NodeAllocator>::value && std::is_trivially_destructible_v<Node>
+        && std::is_trivially_destructible_v<value_type>;
+
+    using ValueAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<value_type>;
+    using ValueAllocTraits = std::allocator_traits<ValueAllocator>;
+
+    /**
+     * Блоки значений для OutOfLineValues: пары лежат плотно в слотах, освобождённые
+     * слоты идут в список и достаются следующим вставкам. Блоки растут от 8 до 1024
+     * слотов и возвращаются аллокатору в clear(). В нулевом слоте блока – заголовок.
+     */
+    struct ValueSlot 
+    {
+        alignas(value_type) alignas(void*) unsigned char bytes[sizeof(value_type) > 2 * sizeof(void*)
+                                                               ? sizeof(value_type) : 2 * sizeof(void*)];
+    };
+
+    struct ValueChunkHeader 
+    {
+        ValueSlot* next;
+        std::size_t capacity;
+    };
+
+    struct ValuePool 
+    {
+        ValueSlot* chunks = nullptr;
+        ValueSlot* free = nullptr;    // слоты списка хранят указатель на следующий
+        ValueSlot* next = nullptr;    // ещё не выданная часть последнего блока
+        ValueSlot* end = nullptr;
+        std::size_t chunkCapacity = 8;
+    };
+
+    struct NoValuePool {};
+
+    using ValueSlotAllocator = typename std::allocator_traits<Allocator>::template rebind_alloc<ValueSlot>;
+
+    [[no_unique_address]] std::conditional_t<Layout::outOfLineValues, ValuePool, NoValuePool> values;
+
+    // Байты на элемент без внешних буферов: узел и, для OutOfLineValues, слот значения
+    static constexpr std::size_t inlineBytes = sizeof(Node) + (Layout::outOfLineValues ? sizeof(ValueSlot) : 0);
+
+    value_type* allocateValue() 
+    {
+        if (values.free) 
+        {
+            ValueSlot* slot = values.free;
+            values.free = *std::launder(reinterpret_cast<ValueSlot**>(slot));
+            return reinterpret_cast<value_type*>(slot);
+        }
+        if (values.next == values.end) 
+        {
+            ValueSlotAllocator slotAlloc(node_alloc);
+            ValueSlot* chunk = slotAlloc.allocate(values.chunkCapacity + 1);
+            ::new (static_cast<void*>(chunk)) ValueChunkHeader{values.chunks, values.chunkCapacity};
+            values.chunks = chunk;
+            values.next = chunk + 1;
+            values.end = chunk + 1 + values.chunkCapacity;
+            values.chunkCapacity = std::min<std::size_t>(values.chunkCapacity * 2, 1024);
+        }
+        return reinterpret_cast<value_type*>(values.next++);
+    }
+
+    void freeValue(value_type* v) noexcept 
+    {
+        ::new (static_cast<void*>(v)) ValueSlot*(values.free);
+        values.free = reinterpret_cast<ValueSlot*>(v);
+    }
+
+    void releaseValues() noexcept 
+    {
+        if constexpr (Layout::outOfLineValues) 
+        {
+            ValueSlotAllocator slotAlloc(node_alloc);
+            while (values.chunks) 
+            {
+                auto* header = std::launder(reinterpret_cast<ValueChunkHeader*>(values.chunks));
+                ValueSlot* next = header->next;
+                slotAlloc.deallocate(values.chunks, header->capacity + 1);
+                values.chunks = next;
+            }
+            values = ValuePool();
+        }
+    }
+
+    // Байты вне узлов (буферы строк, векторов и т.п.), см. mystl::heap_usage
+    std::size_t external_bytes = 0;
+
+    /**
+     * Блок узлов, выделенный одним node_alloc.allocate(capacity + 1) (compact(), reserve()):
+     * в нулевом слоте заголовок, дальше capacity узлов. Освобождённые узлы блока
+     * не возвращаются аллокатору по одному, а идут в free_slots и достаются следующим
+     * вставкам; блок освобождается целиком в clear(), compact() или shrinkToFit().
+     */
+    struct SlabHeader 
+    {
+        Node* next;
+        std::size_t capacity;
+    };
+
+    struct FreeSlot 
+    {
+        FreeSlot* next;
+    };
+
+    static_assert(sizeof(SlabHeader) <= sizeof(Node) && sizeof(FreeSlot) <= sizeof(Node));
+
+    Node* slabs = nullptr;
+    FreeSlot* free_slots = nullptr;
+    std::size_t free_slot_count = 0;
+    // Ещё не выданная часть блока последнего reserve(): страницы не трогаются до вставок
+    Node* reserve_next = nullptr;
+    Node* reserve_end = nullptr;
+
+    static SlabHeader* slabHeader(Node* slab) { return std::launder(reinterpret_cast<SlabHeader*>(slab)); }
+
+    // Блоков обычно один-два, поэтому линейный поиск; без блоков – одно сравнение
+    bool inSlab(const Node* node) const 
+    {
+        std::less<const Node*> before;
+        for (Node* slab = slabs; slab; slab = slabHeader(slab)->next)
+            if (!before(node, slab + 1) && before(node, slab + 1 + slabHeader(slab)->capacity))
+                return true;
+        return false;
+    }
+
+    void releaseSlabs() noexcept 
+    {
+        while (slabs) 
+        {
+            Node* next = slabHeader(slabs)->next;
+            node_alloc.deallocate(slabs, slabHeader(slabs)->capacity + 1);
+            slabs = next;
+        }
+        free_slots = nullptr;
+        free_slot_count = 0;
+        reserve_next = reserve_end = nullptr;
+    }
+
+    std::size_t spareSlots() const { return free_slot_count + static_cast<std::size_t>(reserve_end - reserve_next); }
+
+    Node* allocateNode() 
+    {
+        if (free_slots) 
+        {
+            FreeSlot* slot = free_slots;
+            free_slots = slot->next;
+            --free_slot_count;
+            return reinterpret_cast<Node*>(slot);
+        }
+        if (reserve_next != reserve_end)
+            return reserve_next++;
+        return node_alloc.allocate(1);
+    }
+
+    void freeNode(Node* node) 
+    {
+        if (slabs && inSlab(node)) 
+        {
+            free_slots = ::new (static_cast<void*>(node)) FreeSlot{free_slots};
+            ++free_slot_count;
+        }
+        else
+            node_alloc.deallocate(node, 1);
+    }
+
+    void destroyNode(Node* node) 
+    {
+        releaseBytes(node);
+        if constexpr (Layout::outOfLineValues) 
+        {
+            ValueAllocator valueAlloc(node_alloc);
+            ValueAllocTraits::destroy(valueAlloc, node->slot);
+            freeValue(node->slot);
+        }
+        NodeAllocTraits::destroy(node_alloc, node);
+        freeNode(node);
+        stats.onDeallocation();
+    }
+
+    // Прямой обход без рекурсии
+    void depthFirstOrder(std::vector<Node*>& out) const 
+    {
+        std::vector<Node*> stack;
+        if (root)
+            stack.push_back(root);
+        while (!stack.empty()) 
+        {
+            Node* node = stack.back();
+            stack.pop_back();
+            out.push_back(node);
+            if (node->right)
+                stack.push_back(node->right);
+            if (node->left)
+                stack.push_back(node->left);
+        }
+    }
+
+    static void nodesAtDepth(Node* node, std::size_t depth, std::vector<Node*>& out) 
+    {
+        if (!node)
+            return;
+        if (depth == 0)
+            out.push_back(node);
+        else 
+        {
+            nodesAtDepth(node->left, depth - 1, out);
+            nodesAtDepth(node->right, depth - 1, out);
+        }
+    }
+
+    // Раскладка ван Эмде Боаса для levels уровней поддерева node; корни нижних
+    // поддеревьев копятся в общем scratch, чтобы не выделять вектор на каждый вызов
+    static void vanEmdeBoasOrder(Node* node, std::size_t levels, std::vector<Node*>& out, std::vector<Node*>& scratch) 
+    {
+        if (!node)
+            return;
+        if (levels == 1) 
+        {
+            out.push_back(node);
+            return;
+        }
+        std::size_t top = levels / 2;
+        vanEmdeBoasOrder(node, top, out, scratch);
+        std::size_t first = scratch.size();
+        nodesAtDepth(node, top, scratch);
+        std::size_t last = scratch.size();
+        for (std::size_t i = first; i < last; ++i)
+            vanEmdeBoasOrder(scratch[i], levels - top, out, scratch);
+        scratch.resize(first);
+    }
+
+    static std::size_t externalBytes(const value_type& val) 
+    {
+        if constexpr (projectedKey)
+            return mystl::heap_usage<T>{}(val);
+        else
+            return mystl::heap_usage<Key>{}(val.first) + mystl::heap_usage<T>{}(val.second);
+    }
+
+    // Значение могло вырасти или уменьшиться после вставки, поэтому не уходим ниже нуля
+    void releaseBytes(Node* node) 
+    {
+        std::size_t bytes = externalBytes(node->value());
+        external_bytes -= bytes < external_bytes ? bytes : external_bytes;
+    }
+
+    template <typename A, typename B>
+    bool less(const A& a, const B& b) const 
+    {
+        stats.onComparison();
+        return comp(a, b);
+    }
+
+    /**
+     * Трёхстороннее сравнение ключа с ключом узла для CachedKeyPrefix:
+     * сначала закэшированные 8 байт, строки – только при их совпадении.
+     */
+    template <typename K>
+    int comparePrefixed(const K& key, std::uint64_t prefix, const Node* node) const 
+    {
+        stats.onComparison();
+        if (prefix != node->keyPrefix)
+            return prefix < node->keyPrefix ? -1 : 1;
+        return std::string_view(key).compare(std::string_view(node->key()));
+    }
+
+    void paint(Node* node, Color color) 
+    {
+        if (node->color != color)
+            stats.onRecolor();
+        node->color = color;
+    }
+
     // Возвращает указатель на указатель, через который доступен узел (у родителя или root)
     Node** getLink(Node* x) 
     {
@@ -60,6 +640,7 @@ private:
     {
         if (!x || !x->right)
             return;
+        stats.onRotation();
         Node** xLink = getLink(x);
         Node* y = x->right;
 
@@ -76,6 +657,7 @@ private:
     {
         if (!y || !y->left)
             return;
+        stats.onRotation();
         Node** yLink = getLink(y);
         Node* x = y->left;
 
@@ -92,14 +674,15 @@ private:
     {
         while (z != root && z->parent->color == RED) 
         {
+            stats.onFixupIteration();
             if (z->parent == z->parent->parent->left) 
             {
                 Node* y = z->parent->parent->right;
                 if (y && y->color == RED) 
                 {
-                    z->parent->color = BLACK;
-                    y->color = BLACK;
-                    z->parent->parent->color = RED;
+                    paint(z->parent, BLACK);
+                    paint(y, BLACK);
+                    paint(z->parent->parent, RED);
                     z = z->parent->parent;
                 } 
                 else 
@@ -109,8 +692,8 @@ private:
                         z = z->parent;
                         leftRotate(z);
                     }
-                    z->parent->color = BLACK;
-                    z->parent->parent->color = RED;
+                    paint(z->parent, BLACK);
+                    paint(z->parent->parent, RED);
                     rightRotate(z->parent->parent);
                 }
             } 
@@ -119,9 +702,9 @@ private:
                 Node* y = z->parent->parent->left;
                 if (y && y->color == RED) 
                 {
-                    z->parent->color = BLACK;
-                    y->color = BLACK;
-                    z->parent->parent->color = RED;
+                    paint(z->parent, BLACK);
+                    paint(y, BLACK);
+                    paint(z->parent->parent, RED);
                     z = z->parent->parent;
                 } 
                 else 
@@ -131,14 +714,14 @@ private:
                         z = z->parent;
                         rightRotate(z);
                     }
-                    z->parent->color = BLACK;
-                    z->parent->parent->color = RED;
+                    paint(z->parent, BLACK);
+                    paint(z->parent->parent, RED);
                     leftRotate(z->parent->parent);
                 }
             }
         }
         if (root)
-            root->color = BLACK;
+            paint(root, BLACK);
     }
 
     void transplant(Node* u, Node* v) 
@@ -149,83 +732,87 @@ private:
         *uLink = v;
     }
 
-    void fixDelete(Node* x) 
+    // x может быть nullptr (удалённый чёрный лист), поэтому его родитель передаётся отдельно
+    void fixDelete(Node* x, Node* xParent) 
     {
-        while (x != root && x->color == BLACK) 
+        while (x != root && isBlack(x)) 
         {
-            if (x == x->parent->left) 
+            stats.onFixupIteration();
+            if (x == xParent->left) 
             {
-                Node* w = x->parent->right;
-                if (w && w->color == RED) 
+                Node* w = xParent->right;
+                if (isRed(w)) 
                 {
-                    w->color = BLACK;
-                    x->parent->color = RED;
-                    leftRotate(x->parent);
-                    w = x->parent->right;
+                    paint(w, BLACK);
+                    paint(xParent, RED);
+                    leftRotate(xParent);
+                    w = xParent->right;
                 }
-                if ((!(w->left) || w->left->color == BLACK) &&
-                    (!(w->right) || w->right->color == BLACK)) 
+                if (isBlack(w->left) && isBlack(w->right)) 
                 {
-                    w->color = RED;
-                    x = x->parent;
+                    paint(w, RED);
+                    x = xParent;
+                    xParent = x->parent;
                 } 
                 else 
                 {
-                    if (!(w->right) || w->right->color == BLACK) 
+                    if (isBlack(w->right)) 
                     {
-                        if (w->left)
-                            w->left->color = BLACK;
-                        w->color = RED;
+                        paint(w->left, BLACK);
+                        paint(w, RED);
                         rightRotate(w);
-                        w = x->parent->right;
+                        w = xParent->right;
                     }
-                    w->color = x->parent->color;
-                    x->parent->color = BLACK;
+                    paint(w, xParent->color);
+                    paint(xParent, BLACK);
                     if (w->right)
-                        w->right->color = BLACK;
-                    leftRotate(x->parent);
+                        paint(w->right, BLACK);
+                    leftRotate(xParent);
                     x = root;
                 }
             } 
             else 
             {
-                Node* w = x->parent->left;
-                if (w && w->color == RED) 
+                Node* w = xParent->left;
+                if (isRed(w)) 
                 {
-                    w->color = BLACK;
-                    x->parent->color = RED;
-                    rightRotate(x->parent);
-                    w = x->parent->left;
+                    paint(w, BLACK);
+                    paint(xParent, RED);
+                    rightRotate(xParent);
+                    w = xParent->left;
                 }
-                if ((!(w->right) || w->right->color == BLACK) &&
-                    (!(w->left) || w->left->color == BLACK)) 
+                if (isBlack(w->right) && isBlack(w->left)) 
                 {
-                    w->color = RED;
-                    x = x->parent;
+                    paint(w, RED);
+                    x = xParent;
+                    xParent = x->parent;
                 } 
                 else 
                 {
-                    if (!(w->left) || w->left->color == BLACK) 
+                    if (isBlack(w->left)) 
                     {
-                        if (w->right)
-                            w->right->color = BLACK;
-                        w->color = RED;
+                        paint(w->right, BLACK);
+                        paint(w, RED);
                         leftRotate(w);
-                        w = x->parent->left;
+                        w = xParent->left;
                     }
-                    w->color = x->parent->color;
-                    x->parent->color = BLACK;
+                    paint(w, xParent->color);
+                    paint(xParent, BLACK);
                     if (w->left)
-                        w->left->color = BLACK;
-                    rightRotate(x->parent);
+                        paint(w->left, BLACK);
+                    rightRotate(xParent);
                     x = root;
                 }
             }
         }
         if (x)
-            x->color = BLACK;
+            paint(x, BLACK);
     }
 
+    // Отсутствующий потомок считается чёрным листом
+    static bool isBlack(const Node* node) { return !node || node->color == BLACK; }
+    static bool isRed(const Node* node) { return node && node->color == RED; }
+
     static Node* minimum(Node* node) 
     {
         while (node && node->left)
@@ -246,23 +833,82 @@ private:
         {
             clearHelper(node->left);
             clearHelper(node->right);
-            std::allocator_traits<NodeAllocator>::destroy(node_alloc, node);
-            node_alloc.deallocate(node, 1);
+            destroyNode(node);
         }
     }
 
-    Node* createNode(const std::pair<const Key, T>& val) 
+    // Прямой обход: вставка в том же порядке повторяет форму исходного дерева
+    void copyFrom(Node* node) 
     {
-        Node* p = node_alloc.allocate(1);
-        try {
-            std::allocator_traits<NodeAllocator>::construct(node_alloc, p, val);
-        } catch (...) {
-            node_alloc.deallocate(p, 1);
-            throw;
+        if (node) 
+        {
+            insertNode(node->value());
+            copyFrom(node->left);
+            copyFrom(node->right);
         }
+    }
+
+    void takeNodes(RedBlackTree& other) noexcept 
+    {
+        root = std::exchange(other.root, nullptr);
+        slabs = std::exchange(other.slabs, nullptr);
+        free_slots = std::exchange(other.free_slots, nullptr);
+        free_slot_count = std::exchange(other.free_slot_count, 0);
+        reserve_next = std::exchange(other.reserve_next, nullptr);
+        reserve_end = std::exchange(other.reserve_end, nullptr);
+        values = std::exchange(other.values, {});
+        external_bytes = std::exchange(other.external_bytes, 0);
+        node_count = std::exchange(other.node_count, 0);
+    }
+
+    Node* createNode(const value_type& val) 
+    {
+        Node* p = allocateNode();
+        if constexpr (Layout::outOfLineValues) 
+        {
+            ValueAllocator valueAlloc(node_alloc);
+            value_type* v = nullptr;
+            try {
+                v = allocateValue();
+                ValueAllocTraits::construct(valueAlloc, v, val);
+            } catch (...) {
+                if (v)
+                    freeValue(v);
+                freeNode(p);
+                throw;
+            }
+            try {
+                NodeAllocTraits::construct(node_alloc, p, v);
+            } catch (...) {
+                ValueAllocTraits::destroy(valueAlloc, v);
+                freeValue(v);
+                freeNode(p);
+                throw;
+            }
+        }
+        else 
+        {
+            try {
+                NodeAllocTraits::construct(node_alloc, p, val);
+            } catch (...) {
+                freeNode(p);
+                throw;
+            }
+        }
+        stats.onAllocation();
+        external_bytes += externalBytes(p->value());
         return p;
     }
 
+    // Узел для compact(): пара переносится (или копируется), у OutOfLineValues – только ключ
+    void relocateNode(Node* to, Node* from) 
+    {
+        if constexpr (Layout::outOfLineValues)
+            NodeAllocTraits::construct(node_alloc, to, from->slot);
+        else
+            NodeAllocTraits::construct(node_alloc, to, std::move_if_noexcept(from->data));
+    }
+
 public:
     std::size_t node_count = 0;
 
@@ -274,20 +920,28 @@ public:
 
     ~RedBlackTree() { clear(); }
 
+    // Аллокатор копии выбирает select_on_container_copy_construction (для std::pmr –
+    // ресурс по умолчанию), при присваивании он переходит, только если это велят
+    // propagate_on_container_copy_assignment / move_assignment / swap
     RedBlackTree(const RedBlackTree& other)
-        : root(nullptr), comp(other.comp), node_alloc(other.node_alloc), node_count(0) 
+        : root(nullptr), comp(other.comp),
+          node_alloc(NodeAllocTraits::select_on_container_copy_construction(other.node_alloc)), node_count(0) 
     {
-        std::function<void(Node*)> copyHelper = [&](Node* node) 
-        {
-            if (node) 
-            {
-                insertNode(node->data);
-                copyHelper(node->left);
-                copyHelper(node->right);
-            }
-        };
+        copyFrom(other.root);
+    }
 
-        copyHelper(other.root);
+    RedBlackTree(RedBlackTree&& other) noexcept
+        : root(std::exchange(other.root, nullptr)), comp(std::move(other.comp)),
+          node_alloc(std::move(other.node_alloc)),
+          external_bytes(std::exchange(other.external_bytes, 0)),
+          slabs(std::exchange(other.slabs, nullptr)),
+          free_slots(std::exchange(other.free_slots, nullptr)),
+          free_slot_count(std::exchange(other.free_slot_count, 0)),
+          reserve_next(std::exchange(other.reserve_next, nullptr)),
+          reserve_end(std::exchange(other.reserve_end, nullptr)),
+          node_count(std::exchange(other.node_count, 0)) 
+    {
+        values = std::exchange(other.values, {});
     }
 
     RedBlackTree& operator=(const RedBlackTree& other) 
@@ -296,28 +950,70 @@ public:
         {
             clear();
             comp = other.comp;
-            node_alloc = other.node_alloc;
-            std::function<void(Node*)> copyHelper = [&](Node* node) 
-            {
-                if (node) 
-                {
-                    insertNode(node->data);
-                    copyHelper(node->left);
-                    copyHelper(node->right);
-                }
-            };
+            if constexpr (NodeAllocTraits::propagate_on_container_copy_assignment::value)
+                node_alloc = other.node_alloc;
+            copyFrom(other.root);
+        }
 
-            copyHelper(other.root);
+        return *this;
+    }
+
+    RedBlackTree& operator=(RedBlackTree&& other) 
+        noexcept(NodeAllocTraits::propagate_on_container_move_assignment::value || NodeAllocTraits::is_always_equal::value)
+    {
+        if (this == &other)
+            return *this;
+
+        clear();
+        comp = std::move(other.comp);
+        if constexpr (NodeAllocTraits::propagate_on_container_move_assignment::value) 
+        {
+            node_alloc = std::move(other.node_alloc);
+            takeNodes(other);
+        }
+        else if (node_alloc == other.node_alloc)
+            takeNodes(other);
+        else 
+        {
+            // Узлы чужого ресурса забрать нельзя – элементы копируются в свой
+            copyFrom(other.root);
+            other.clear();
         }
 
         return *this;
     }
 
+    // Без propagate_on_container_swap аллокаторы должны быть равны, как у стандартных контейнеров
+    void swap(RedBlackTree& other) noexcept 
+    {
+        using std::swap;
+        if constexpr (NodeAllocTraits::propagate_on_container_swap::value)
+            swap(node_alloc, other.node_alloc);
+        else
+            assert(node_alloc == other.node_alloc);
+        swap(root, other.root);
+        swap(comp, other.comp);
+        swap(external_bytes, other.external_bytes);
+        swap(slabs, other.slabs);
+        swap(free_slots, other.free_slots);
+        swap(free_slot_count, other.free_slot_count);
+        swap(reserve_next, other.reserve_next);
+        swap(reserve_end, other.reserve_end);
+        swap(values, other.values);
+        swap(node_count, other.node_count);
+    }
+
+    Allocator get_allocator() const { return Allocator(node_alloc); }
+
     void clear() 
     { 
-        clearHelper(root); 
+        if constexpr (!skipClearWalk)
+            clearHelper(root); 
+        releaseSlabs();
+        releaseValues();
         root = nullptr;
         node_count = 0;
+        external_bytes = 0;
     }
 
     template <typename K>
@@ -325,43 +1021,116 @@ public:
     find(const K& key) const
     {
         Node* current = root;
+        std::size_t depth = 0;
+        if constexpr (Layout::cacheKeyPrefix && std::is_convertible_v<const K&, std::string_view>) 
+        {
+            std::uint64_t prefix = keyPrefix(key);
+            while (current) 
+            {
+                ++depth;
+                int c = comparePrefixed(key, prefix, current);
+                if (c == 0)
+                    break;
+                current = c < 0 ? current->left : current->right;
+            }
+            stats.onLookup(depth);
+            return current;
+        }
         while (current) 
         {
-            if (comp(key, current->data.first))
+            ++depth;
+            if (less(key, current->key()))
                 current = current->left;
-            else if (comp(current->data.first, key))
+            else if (less(current->key(), key))
                 current = current->right;
             else
-                return current;
+                break;
         }
 
-        return nullptr;
+        stats.onLookup(depth);
+        return current;
     }
 
-    void insertNode(const std::pair<const Key, T>& val)
+    /**
+     * Место ключа в дереве: найденный узел (found) либо будущий родитель нового узла
+     * и сторона, с которой он встанет. Действительно до следующего изменения дерева.
+     */
+    struct InsertPosition 
     {
-        Node* newNode = createNode(val);
-        newNode->color = RED;
-        Node* y = nullptr;
+        Node* node = nullptr;
+        bool goLeft = false;
+        bool found = false;
+    };
+
+    template <typename K>
+    InsertPosition locate(const K& key) const
+    {
+        InsertPosition pos;
         Node* x = root;
+        if constexpr (Layout::cacheKeyPrefix) 
+        {
+            std::uint64_t prefix = keyPrefix(key);
+            while (x) 
+            {
+                pos.node = x;
+                int c = comparePrefixed(key, prefix, x);
+                if (c == 0) 
+                {
+                    pos.found = true;
+                    return pos;
+                }
+                pos.goLeft = c < 0;
+                x = pos.goLeft ? x->left : x->right;
+            }
+        }
         while (x) 
         {
-            y = x;
-            if (comp(newNode->data.first, x->data.first))
+            pos.node = x;
+            if (less(key, x->key())) 
+            {
+                pos.goLeft = true;
                 x = x->left;
-            else
+            }
+            else if (less(x->key(), key)) 
+            {
+                pos.goLeft = false;
                 x = x->right;
+            }
+            else 
+            {
+                pos.found = true;
+                return pos;
+            }
         }
-        newNode->parent = y;
-        if (!y)
+        return pos;
+    }
+
+    // Вставляет val на место pos, полученное locate(ключ val) без изменений дерева после него
+    Node* insertAt(const InsertPosition& pos, const value_type& val)
+    {
+        assert(!pos.found);
+        Node* newNode = createNode(val);
+        newNode->color = RED;
+        newNode->parent = pos.node;
+        if (!pos.node)
             root = newNode;
-        else if (comp(newNode->data.first, y->data.first))
-            y->left = newNode;
+        else if (pos.goLeft)
+            pos.node->left = newNode;
         else
-            y->right = newNode;
+            pos.node->right = newNode;
 
         fixInsert(newNode);
         node_count++;
+        return newNode;
+    }
+
+    // Вставляет val, если такого ключа ещё нет; возвращает узел с ключом и признак вставки
+    std::pair<Node*, bool> insertNode(const value_type& val)
+    {
+        InsertPosition pos = locate(value_storage::keyOf(val));
+        if (pos.found)
+            return {pos.node, false};
+        return {insertAt(pos, val), true};
     }
 
     void removeNode(const Key& key)
@@ -373,12 +1142,148 @@ public:
             return;
         }
 
+        eraseNode(z);
+    }
+
+    // Удаляет узел, уже найденный вызывающим: без повторного спуска и без вывода ключа
+    void eraseNode(Node* z)
+    {
         deleteNode(z);
         node_count--;
     }
 
     std::size_t TreeSize() const { return node_count; }
 
+    // Живые байты: узлы плюс внешние буферы ключей и значений на момент вставки
+    std::size_t memoryUsage() const { return node_count * inlineBytes + external_bytes; }
+
+    // Выделенные, но незанятые узлы блоков reserve()/compact(); в memoryUsage() не входят
+    std::size_t reservedBytes() const { return spareSlots() * sizeof(Node); }
+
+    // Сколько байт добавит вставка val
+    static std::size_t nodeBytes(const value_type& val) { return inlineBytes + externalBytes(val); }
+
+    // Пересчитывает внешние байты обходом дерева (после изменения значений на месте)
+    void recomputeMemoryUsage() 
+    {
+        external_bytes = 0;
+        for (Node* node = minimum(root); node; node = successor(node))
+            external_bytes += externalBytes(node->value());
+    }
+
+    /**
+     * Переносит все узлы в один новый блок в порядке order, сохраняя форму дерева
+     * и цвета; старые узлы и блоки освобождаются. Значения перемещаются, если это
+     * не бросает исключений, иначе копируются; при исключении дерево не меняется.
+     * Указатели на узлы (итераторы) после compact() недействительны.
+     */
+    void compact(CompactOrder order = CompactOrder::VanEmdeBoas) 
+    {
+        if (!root) 
+        {
+            releaseSlabs();
+            return;
+        }
+
+        std::vector<Node*> old;
+        old.reserve(node_count);
+        if (order == CompactOrder::DepthFirst)
+            depthFirstOrder(old);
+        else 
+        {
+            std::vector<Node*> scratch;
+            vanEmdeBoasOrder(root, collectHeight(), old, scratch);
+        }
+
+        Node* slab = node_alloc.allocate(old.size() + 1);
+        Node* fresh = slab + 1;
+        std::size_t built = 0;
+        try {
+            for (; built < old.size(); ++built)
+                relocateNode(fresh + built, old[built]);
+        } catch (...) {
+            while (built > 0)
+                NodeAllocTraits::destroy(node_alloc, fresh + --built);
+            node_alloc.deallocate(slab, old.size() + 1);
+            throw;
+        }
+
+        // Старый parent указывает на новую копию узла, пока связи переводятся на новые адреса
+        for (std::size_t i = 0; i < old.size(); ++i) 
+        {
+            fresh[i].color = old[i]->color;
+            fresh[i].left = old[i]->left;
+            fresh[i].right = old[i]->right;
+        }
+        for (std::size_t i = 0; i < old.size(); ++i)
+            old[i]->parent = fresh + i;
+        for (std::size_t i = 0; i < old.size(); ++i) 
+        {
+            if (fresh[i].left) 
+            {
+                fresh[i].left = fresh[i].left->parent;
+                fresh[i].left->parent = fresh + i;
+            }
+            if (fresh[i].right) 
+            {
+                fresh[i].right = fresh[i].right->parent;
+                fresh[i].right->parent = fresh + i;
+            }
+        }
+        root = root->parent;
+        root->parent = nullptr;
+
+        // Старые узлы из блоков освобождаются вместе с блоками
+        for (Node* node : old) 
+        {
+            NodeAllocTraits::destroy(node_alloc, node);
+            if (!slabs || !inSlab(node))
+                node_alloc.deallocate(node, 1);
+        }
+        releaseSlabs();
+        slabs = slab;
+        ::new (static_cast<void*>(slab)) SlabHeader{nullptr, old.size()};
+    }
+
+    // Узлов, которые можно вставить без обращения к аллокатору, плюс живые узлы
+    std::size_t capacity() const { return node_count + spareSlots(); }
+
+    /**
+     * Выделяет недостающие до n узлы одним блоком; следующие вставки берут узлы
+     * из него по возрастанию адресов, так что страницы блока заполняются по мере
+     * вставок, а не в момент reserve. Каждый вызов, который что-то выделил, добавляет
+     * блок, а освобождение узла ищет его блок перебором, поэтому reserve рассчитан
+     * на редкие вызовы с итоговым размером, а не на рост по одному элементу.
+     */
+    void reserve(std::size_t n) 
+    {
+        if (n <= capacity())
+            return;
+        std::size_t count = n - capacity();
+        Node* slab = node_alloc.allocate(count + 1);
+        ::new (static_cast<void*>(slab)) SlabHeader{slabs, count};
+        slabs = slab;
+        // Остаток предыдущего резерва переходит в список свободных
+        while (reserve_next != reserve_end) 
+        {
+            free_slots = ::new (static_cast<void*>(reserve_next++)) FreeSlot{free_slots};
+            ++free_slot_count;
+        }
+        reserve_next = slab + 1;
+        reserve_end = slab + 1 + count;
+    }
+
+    // Возвращает аллокатору свободные места блоков: узлы переезжают в блок точного размера
+    void shrinkToFit() 
+    {
+        if (spareSlots() == 0)
+            return;
+        if (!root)
+            releaseSlabs();
+        else
+            compact();
+    }
+
     Node* minNode() const { return minimum(root); }
 
     Node* maxNode() const { return maximum(root); }
@@ -417,31 +1322,111 @@ public:
 
     Node* getRoot() const { return root; }
 
+    const Stats& getStats() const { return stats; }
+
+    void resetStats() { stats = Stats(); }
+
+    // Число уровней дерева (0 для пустого)
+    std::size_t collectHeight() const 
+    {
+        std::size_t height = 0;
+        std::vector<std::pair<Node*, std::size_t>> stack;
+        if (root)
+            stack.emplace_back(root, 1);
+        while (!stack.empty()) 
+        {
+            auto [node, depth] = stack.back();
+            stack.pop_back();
+            height = std::max(height, depth);
+            if (node->left)
+                stack.emplace_back(node->left, depth + 1);
+            if (node->right)
+                stack.emplace_back(node->right, depth + 1);
+        }
+        return height;
+    }
+
+    // Обходит дерево и собирает высоту, чёрную высоту и распределение глубин узлов
+    TreeStats<Stats> collectStats() const 
+    {
+        TreeStats<Stats> result;
+        result.size = node_count;
+        result.counters = stats;
+
+        for (Node* node = root; node; node = node->left)
+            if (node->color == BLACK)
+                result.blackHeight++;
+
+        std::vector<std::pair<Node*, std::size_t>> stack;
+        if (root)
+            stack.emplace_back(root, 0);
+        std::size_t depthTotal = 0;
+        while (!stack.empty()) 
+        {
+            auto [node, depth] = stack.back();
+            stack.pop_back();
+            if (result.depthHistogram.size() <= depth)
+                result.depthHistogram.resize(depth + 1, 0);
+            result.depthHistogram[depth]++;
+            depthTotal += depth;
+            if (node->left)
+                stack.emplace_back(node->left, depth + 1);
+            if (node->right)
+                stack.emplace_back(node->right, depth + 1);
+        }
+
+        result.height = result.depthHistogram.size();
+        if (node_count)
+            result.averageDepth = static_cast<double>(depthTotal) / static_cast<double>(node_count);
+        return result;
+    }
+
+    /**
+     * Проверяет свойства красно-чёрного дерева: чёрный корень, отсутствие двух красных
+     * узлов подряд, одинаковую чёрную высоту всех путей, связи parent, порядок ключей
+     * (каждый ключ лежит между границами, заданными предками), число узлов и гарантию
+     * высоты h <= 2 * log2(n + 1).
+     */
     bool validate()
     {
-        std::function<bool(Node*, int, int&)> validateHelper =
-            [&](Node* node, int blackCount, int& pathBlackCount) -> bool 
+        if (root && (root->color != BLACK || root->parent))
+            return false;
+
+        std::size_t count = 0;
+        std::size_t height = 0;
+        // Возвращает чёрную высоту поддерева или -1 при нарушении. lo и hi – ближайшие
+        // предки, между ключами которых должны лежать все ключи поддерева (nullptr – без границы).
+        // Сравнение идёт напрямую через comp, чтобы проверка не попадала в статистику.
+        std::function<int(Node*, const Node*, const Node*, std::size_t)> validateHelper =
+            [&](Node* node, const Node* lo, const Node* hi, std::size_t depth) -> int 
         {
             if (!node) 
             {
-                if (pathBlackCount == -1)
-                    pathBlackCount = blackCount;
-                else if (blackCount != pathBlackCount)
-                    return false;
-
-                return true;
+                height = std::max(height, depth);
+                return 1;
             }
-            if (node->color == BLACK)
-                blackCount++;
-            else if (node->parent && node->parent->color == RED)
-                return false;
+            count++;
+            if (node->color == RED && (isRed(node->left) || isRed(node->right)))
+                return -1;
+            if ((node->left && node->left->parent != node) || (node->right && node->right->parent != node))
+                return -1;
+            if ((lo && !comp(lo->key(), node->key())) || (hi && !comp(node->key(), hi->key())))
+                return -1;
+
+            int leftBlack = validateHelper(node->left, lo, node, depth + 1);
+            if (leftBlack < 0)
+                return -1;
+            int rightBlack = validateHelper(node->right, node, hi, depth + 1);
+            if (rightBlack != leftBlack)
+                return -1;
 
-            return validateHelper(node->left, blackCount, pathBlackCount) &&
-                   validateHelper(node->right, blackCount, pathBlackCount);
+            return leftBlack + (node->color == BLACK ? 1 : 0);
         };
 
-        int pathBlackCount = -1;
-        return validateHelper(root, 0, pathBlackCount);
+        if (validateHelper(root, nullptr, nullptr, 0) < 0 || count != node_count)
+            return false;
+        // height здесь – число узлов на самом длинном пути
+        return static_cast<double>(height) <= 2.0 * std::log2(static_cast<double>(node_count) + 1.0);
     }
 
 private:
@@ -451,6 +1436,7 @@ private:
             return;
         Node* y = z;
         Node* x = nullptr;
+        Node* xParent = z->parent;
         Color y_original_color = y->color;
 
         if (!z->left) 
@@ -470,28 +1456,25 @@ private:
             x = y->right;
             if (y->parent == z) 
             {
-                if (x)
-                    x->parent = y;
+                xParent = y;
             } 
             else 
             {
+                xParent = y->parent;
                 transplant(y, y->right);
                 y->right = z->right;
-                if (y->right)
-                    y->right->parent = y;
+                y->right->parent = y;
             }
 
             transplant(z, y);
             y->left = z->left;
-            if (y->left)
-                y->left->parent = y;
+            y->left->parent = y;
             y->color = z->color;
         }
 
-        std::allocator_traits<NodeAllocator>::destroy(node_alloc, z);
-        node_alloc.deallocate(z, 1);
-        if (y_original_color == BLACK && x)
-            fixDelete(x);
+        destroyNode(z);
+        if (y_original_color == BLACK)
+            fixDelete(x, xParent);
     }
 };
 
@@ -0,0 +1,617 @@
+#ifndef SMALL_MAP_HPP
+#define SMALL_MAP_HPP
+
+#include "map.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace mystl {
+
+    /**
+     * Карта со встроенным хранилищем: до N элементов лежат в отсортированном массиве
+     * внутри самого объекта и не требуют выделений памяти. Вставка (N+1)-го элемента
+     * переносит содержимое в mystl::map, дальше карта работает как обычное дерево.
+     * Интерфейс повторяет mystl::map.
+     *
+     * Пока карта встроенная, вставка и удаление сдвигают элементы массива и, как
+     * у vector, делают недействительными итераторы правее места изменения. Во встроенный
+     * режим карта возвращается только в clear() и shrink_to_fit(), чтобы размер около N
+     * не приводил к постоянным переносам туда и обратно.
+     *
+     * Массив хранит std::pair<Key, T> (ключ не const, чтобы сдвиг переносил его, а не
+     * копировал), поэтому *it – прокси-пара ссылок std::pair<const Key&, T&>, как у flat_map.
+     * Сдвиг переносит элементы по одному, и исключение посреди него оставило бы дыру
+     * в массиве, поэтому Key и T должны переноситься без исключений.
+     */
+    template <typename Key, typename T, std::size_t N = 16,
+              typename Compare = std::less<Key>,
+              typename Allocator = std::allocator<std::pair<const Key, T>>>
+    class small_map : private EBO<Compare>,
+                      private EBO<Allocator>
+    {
+        static_assert(N > 0, "small_map: inline capacity must be positive");
+        static_assert(std::is_nothrow_move_constructible<Key>::value && std::is_nothrow_move_constructible<T>::value,
+                      "small_map: Key and T must be nothrow move constructible");
+
+    private:
+        const Compare& get_compare() const { return static_cast<const EBO<Compare>&>(*this).get(); }
+        const Allocator& get_allocator() const { return static_cast<const EBO<Allocator>&>(*this).get(); }
+
+        using big_type = map<Key, T, Compare, Allocator>;
+        using big_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<big_type>;
+        using big_traits = std::allocator_traits<big_allocator>;
+
+    public:
+        using value_type      = std::pair<const Key, T>;
+        using key_type        = Key;
+        using mapped_type     = T;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using key_compare     = Compare;
+        using allocator_type  = Allocator;
+        using reference       = std::pair<const Key&, T&>;
+        using const_reference = std::pair<const Key&, const T&>;
+
+        static constexpr size_type inline_capacity = N;
+
+    private:
+        using slot_type = std::pair<Key, T>;
+
+    public:
+        /**
+         * Итератор встроенного режима указывает на элемент массива (slot), итератор
+         * режима дерева – на узел mystl::map (it, slot == nullptr).
+         */
+        template <bool Const>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = std::pair<const Key, T>;
+            using difference_type   = std::ptrdiff_t;
+            using reference         = std::conditional_t<Const, std::pair<const Key&, const T&>, std::pair<const Key&, T&>>;
+            using slot_pointer      = std::conditional_t<Const, const slot_type*, slot_type*>;
+            using tree_iterator     = std::conditional_t<Const, typename big_type::const_iterator,
+                                                                typename big_type::iterator>;
+
+            // operator-> должен вернуть указатель, а пара ссылок – временный объект
+            struct pointer
+            {
+                reference ref;
+                const reference* operator->() const { return &ref; }
+            };
+
+            slot_pointer slot = nullptr;
+            tree_iterator it;
+
+            basic_iterator() = default;
+            explicit basic_iterator(slot_pointer s) : slot(s) {}
+            explicit basic_iterator(tree_iterator t) : it(t) {}
+
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other) : slot(other.slot), it(other.it) {}
+
+            reference operator*() const { return slot ? reference(slot->first, slot->second) : reference(it->first, it->second); }
+            pointer operator->() const { return pointer{**this}; }
+
+            basic_iterator& operator++()
+            {
+                if (slot)
+                    ++slot;
+                else
+                    ++it;
+                return *this;
+            }
+
+            basic_iterator operator++(int)
+            {
+                basic_iterator tmp(*this);
+                ++(*this);
+                return tmp;
+            }
+
+            basic_iterator& operator--()
+            {
+                if (slot)
+                    --slot;
+                else
+                    --it;
+                return *this;
+            }
+
+            basic_iterator operator--(int)
+            {
+                basic_iterator tmp(*this);
+                --(*this);
+                return tmp;
+            }
+
+            bool operator==(const basic_iterator& other) const { return slot == other.slot && it == other.it; }
+            bool operator!=(const basic_iterator& other) const { return !(*this == other); }
+        };
+
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        small_map() : EBO<Compare>(), EBO<Allocator>() {}
+
+        explicit small_map(const Compare& comp, const Allocator& alloc = Allocator())
+            : EBO<Compare>(comp), EBO<Allocator>(alloc) {}
+
+        small_map(std::initializer_list<value_type> init,
+                  const Compare& comp = Compare(),
+                  const Allocator& alloc = Allocator())
+            : EBO<Compare>(comp), EBO<Allocator>(alloc)
+        {
+            for (const auto& elem : init)
+                insert(elem);
+        }
+
+        small_map(const small_map& other)
+            : EBO<Compare>(other.get_compare()), EBO<Allocator>(other.get_allocator())
+        {
+            if (other.big)
+                big = make_big(*other.big);
+            else
+                for (; inline_size < other.inline_size; ++inline_size)
+                    ::new (static_cast<void*>(slots() + inline_size)) slot_type(other.slots()[inline_size]);
+        }
+
+        small_map(small_map&& other) noexcept
+            : EBO<Compare>(other.get_compare()), EBO<Allocator>(other.get_allocator())
+        {
+            steal(other);
+        }
+
+        small_map& operator=(const small_map& other)
+        {
+            if (this != &other)
+            {
+                small_map tmp(other);
+                clear();
+                steal(tmp);
+            }
+            return *this;
+        }
+
+        small_map& operator=(small_map&& other)
+        {
+            if (this != &other)
+            {
+                clear();
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~small_map() { clear(); }
+
+        // -- ИТЕРАТОРЫ --
+
+        iterator begin() { return big ? iterator(big->begin()) : iterator(slots()); }
+        iterator end()   { return big ? iterator(big->end()) : iterator(slots() + inline_size); }
+
+        const_iterator begin() const { return big ? const_iterator(std::as_const(*big).begin()) : const_iterator(slots()); }
+        const_iterator end() const   { return big ? const_iterator(std::as_const(*big).end()) : const_iterator(slots() + inline_size); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const   { return end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+        const_reverse_iterator crbegin() const { return rbegin(); }
+        const_reverse_iterator crend() const   { return rend(); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return size() == 0; }
+
+        size_type size() const { return big ? big->size() : inline_size; }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max(); }
+
+        // true, пока элементы хранятся во встроенном массиве
+        bool is_inline() const { return big == nullptr; }
+
+        // Возвращает элементы во встроенный массив, если они туда помещаются
+        void shrink_to_fit()
+        {
+            if (!big || big->size() > N)
+                return;
+            big_type* tree = big;
+            big = nullptr;
+            for (auto it = tree->begin(); it != tree->end(); ++it)
+                ::new (static_cast<void*>(slots() + inline_size++)) slot_type(it->first, std::move(it->second));
+            destroy_big(tree);
+        }
+
+        // -- ОПЕРАЦИИ ДОСТУПА --
+
+        mapped_type& operator[](const key_type& key)
+        {
+            if (big)
+                return (*big)[key];
+            return insert_unique(key, [] { return mapped_type(); }).first->second;
+        }
+
+        mapped_type& at(const key_type& key)
+        {
+            auto it = find(key);
+            if (it == end())
+                throw std::out_of_range("Key not found");
+            return it->second;
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            auto it = find(key);
+            if (it == end())
+                throw std::out_of_range("Key not found");
+            return it->second;
+        }
+
+        // -- МОДИФИКАЦИЯ --
+
+        void insert(const value_type& value)
+        {
+            insert_unique(value.first, [&] { return value.second; });
+        }
+
+        void emplace(const key_type& key, const mapped_type& value) { insert(std::make_pair(key, value)); }
+
+        template <typename InputIt>
+        void insert_range(InputIt first, InputIt last)
+        {
+            for (auto it = first; it != last; ++it)
+                insert(*it);
+        }
+
+        void insert_or_assign(const key_type& key, const mapped_type& value)
+        {
+            auto result = insert_unique(key, [&] { return value; });
+            if (!result.second)
+                result.first->second = value;
+        }
+
+        iterator emplace_hint(const_iterator /*hint*/, const value_type& value)
+        {
+            return insert_unique(value.first, [&] { return value.second; }).first;
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            return insert_unique(key, [&] { return mapped_type(std::forward<Args>(args)...); });
+        }
+
+        void erase(const key_type& key)
+        {
+            auto it = find(key);
+            if (it != end())
+                erase(it);
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            if (big)
+                return pos.it == big->cend() ? end() : iterator(big->erase(iterator_of(pos.it)));
+            size_type i = static_cast<size_type>(pos.slot - slots());
+            if (i < inline_size)
+                erase_at(i);
+            return iterator(slots() + i);
+        }
+
+        iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+        template <typename Predicate>
+        size_type erase_if(Predicate pred)
+        {
+            if (big)
+                return big->erase_if(pred);
+            size_type removed = 0;
+            for (size_type i = 0; i < inline_size; )
+            {
+                if (pred(const_reference(slots()[i].first, slots()[i].second)))
+                {
+                    erase_at(i);
+                    ++removed;
+                }
+                else
+                {
+                    ++i;
+                }
+            }
+            return removed;
+        }
+
+        void clear()
+        {
+            if (big)
+            {
+                destroy_big(big);
+                big = nullptr;
+            }
+            std::destroy_n(slots(), inline_size);
+            inline_size = 0;
+        }
+
+        value_type extract(const key_type& key)
+        {
+            if (big)
+                return big->extract(key);
+            size_type i = lower_index(key);
+            if (!matches(i, key))
+                throw std::out_of_range("Key not found");
+            value_type val(std::move(slots()[i].first), std::move(slots()[i].second));
+            erase_at(i);
+            return val;
+        }
+
+        template <std::size_t M>
+        void merge(small_map<Key, T, M, Compare, Allocator>& source)
+        {
+            for (auto it = source.begin(); it != source.end(); )
+            {
+                if (insert_unique(it->first, [&] { return it->second; }).second)
+                    it = source.erase(it);
+                else
+                    ++it;
+            }
+        }
+
+        void swap(small_map& other)
+        {
+            small_map tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+
+        // -- ПОИСК --
+
+        iterator find(const key_type& key)
+        {
+            if (big)
+                return iterator(big->find(key));
+            size_type i = lower_index(key);
+            return iterator(slots() + (matches(i, key) ? i : inline_size));
+        }
+
+        const_iterator find(const key_type& key) const
+        {
+            if (big)
+                return const_iterator(std::as_const(*big).find(key));
+            size_type i = lower_index(key);
+            return const_iterator(slots() + (matches(i, key) ? i : inline_size));
+        }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const
+        {
+            if (big)
+                return big->contains(key);
+            return matches(lower_index(key), key);
+        }
+
+        iterator lower_bound(const key_type& key)
+        {
+            return big ? iterator(big->lower_bound(key)) : iterator(slots() + lower_index(key));
+        }
+
+        const_iterator lower_bound(const key_type& key) const
+        {
+            return big ? const_iterator(std::as_const(*big).lower_bound(key)) : const_iterator(slots() + lower_index(key));
+        }
+
+        iterator upper_bound(const key_type& key)
+        {
+            return big ? iterator(big->upper_bound(key)) : iterator(slots() + upper_index(key));
+        }
+
+        const_iterator upper_bound(const key_type& key) const
+        {
+            return big ? const_iterator(std::as_const(*big).upper_bound(key)) : const_iterator(slots() + upper_index(key));
+        }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key) { return {lower_bound(key), upper_bound(key)}; }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        key_compare key_comp() const { return get_compare(); }
+
+        using value_compare = typename big_type::value_compare;
+
+        value_compare value_comp() const { return value_compare(get_compare()); }
+
+        friend bool operator==(const small_map& lhs, const small_map& rhs)
+        {
+            return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+        friend bool operator!=(const small_map& lhs, const small_map& rhs) { return !(lhs == rhs); }
+        friend bool operator<(const small_map& lhs, const small_map& rhs)
+        {
+            return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+        }
+        friend bool operator<=(const small_map& lhs, const small_map& rhs) { return !(rhs < lhs); }
+        friend bool operator>(const small_map& lhs, const small_map& rhs) { return rhs < lhs; }
+        friend bool operator>=(const small_map& lhs, const small_map& rhs) { return !(lhs < rhs); }
+
+    private:
+        slot_type* slots() { return std::launder(reinterpret_cast<slot_type*>(storage)); }
+        const slot_type* slots() const { return std::launder(reinterpret_cast<const slot_type*>(storage)); }
+
+        // Переносит элемент из src в неинициализированный dst и разрушает src; не бросает
+        static void relocate(slot_type* dst, slot_type* src) noexcept
+        {
+            ::new (static_cast<void*>(dst)) slot_type(std::move(*src));
+            src->~slot_type();
+        }
+
+        /**
+         * Для чисел и указателей на десятках элементов линейный проход быстрее двоичного
+         * поиска (нет непредсказуемых ветвлений); для дорогих сравнений (строки) важнее
+         * их число, поэтому там двоичный поиск.
+         */
+        size_type lower_index(const key_type& key) const
+        {
+            if constexpr (std::is_arithmetic<Key>::value || std::is_pointer<Key>::value)
+            {
+                size_type i = 0;
+                while (i < inline_size && get_compare()(slots()[i].first, key))
+                    ++i;
+                return i;
+            }
+            else
+            {
+                auto it = std::lower_bound(slots(), slots() + inline_size, key,
+                                           [&](const slot_type& v, const key_type& k) { return get_compare()(v.first, k); });
+                return static_cast<size_type>(it - slots());
+            }
+        }
+
+        size_type upper_index(const key_type& key) const
+        {
+            size_type i = lower_index(key);
+            return matches(i, key) ? i + 1 : i;
+        }
+
+        bool matches(size_type i, const key_type& key) const
+        {
+            return i < inline_size && !get_compare()(key, slots()[i].first);
+        }
+
+        static typename big_type::iterator iterator_of(typename big_type::const_iterator it)
+        {
+            return typename big_type::iterator(it.node, it.owner);
+        }
+
+        /**
+         * Вставляет ключ, если его ещё нет; make_value создаёт значение только при вставке.
+         * Переполненный массив сначала переносится в дерево.
+         */
+        template <typename MakeValue>
+        std::pair<iterator, bool> insert_unique(const key_type& key, MakeValue&& make_value)
+        {
+            if (!big)
+            {
+                size_type i = lower_index(key);
+                if (matches(i, key))
+                    return {iterator(slots() + i), false};
+                if (inline_size < N)
+                {
+                    insert_at(i, key, make_value());
+                    return {iterator(slots() + i), true};
+                }
+                spill();
+            }
+            auto it = big->find(key);
+            if (it != big->end())
+                return {iterator(it), false};
+            return {iterator(big->try_emplace(key, make_value()).first), true};
+        }
+
+        void insert_at(size_type i, const key_type& key, mapped_type&& value)
+        {
+            slot_type* s = slots();
+            if (i == inline_size)
+            {
+                ::new (static_cast<void*>(s + i)) slot_type(key, std::move(value));
+                ++inline_size;
+                return;
+            }
+            // Элемент собирается до сдвига: бросить может только копирование ключа
+            slot_type item(key, std::move(value));
+            for (size_type j = inline_size; j > i; --j)
+                relocate(s + j, s + j - 1);
+            ::new (static_cast<void*>(s + i)) slot_type(std::move(item));
+            ++inline_size;
+        }
+
+        void erase_at(size_type i)
+        {
+            slot_type* s = slots();
+            s[i].~slot_type();
+            for (size_type j = i; j + 1 < inline_size; ++j)
+                relocate(s + j, s + j + 1);
+            --inline_size;
+        }
+
+        void spill()
+        {
+            big_type* tree = make_big(get_compare(), get_allocator());
+            try {
+                for (size_type i = 0; i < inline_size; ++i)
+                    tree->try_emplace(slots()[i].first, slots()[i].second);
+            } catch (...) {
+                destroy_big(tree);
+                throw;
+            }
+            std::destroy_n(slots(), inline_size);
+            inline_size = 0;
+            big = tree;
+        }
+
+        // Дерево создаётся placement new, а не allocator_traits::construct: иначе
+        // polymorphic_allocator добавил бы к аргументам свой аллокатор
+        template <typename... Args>
+        big_type* make_big(const Args&... args)
+        {
+            big_allocator alloc(get_allocator());
+            big_type* tree = big_traits::allocate(alloc, 1);
+            try {
+                ::new (static_cast<void*>(tree)) big_type(args...);
+            } catch (...) {
+                big_traits::deallocate(alloc, tree, 1);
+                throw;
+            }
+            return tree;
+        }
+
+        void destroy_big(big_type* tree)
+        {
+            big_allocator alloc(get_allocator());
+            big_traits::destroy(alloc, tree);
+            big_traits::deallocate(alloc, tree, 1);
+        }
+
+        // Забирает содержимое other (this пуст); other остаётся пустым
+        void steal(small_map& other)
+        {
+            if (other.big)
+            {
+                big = other.big;
+                other.big = nullptr;
+                return;
+            }
+            for (; inline_size < other.inline_size; ++inline_size)
+                relocate(slots() + inline_size, other.slots() + inline_size);
+            other.inline_size = 0;
+        }
+
+        alignas(slot_type) unsigned char storage[N * sizeof(slot_type)];
+        size_type inline_size = 0;
+        big_type* big = nullptr;
+    };
+
+} // namespace mystl
+
+#endif // SMALL_MAP_HPP
@@ -0,0 +1,946 @@
+#ifndef STRING_BTREE_MAP_HPP
+#define STRING_BTREE_MAP_HPP
+
+#include "memory-usage.hpp"
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace mystl {
+
+    /**
+     * Карта со строковыми ключами на B+-дереве, листья которого хранят ключи
+     * с фронтальным кодированием: каждый ключ записан как (длина общего начала
+     * с предыдущим ключом, длина остатка, остаток). Для иерархических путей
+     * вида /tenant/bucket/object общие префиксы хранятся один раз на лист,
+     * а соседние ключи лежат в одном непрерывном буфере.
+     *
+     * Внутренние узлы хранят укороченные разделители (кратчайший префикс первого
+     * ключа правого листа, который больше последнего ключа левого), значения –
+     * в std::vector<T> листа. prefix_range(prefix) и erase_prefix(prefix)
+     * работают по диапазону листов: полностью покрытые листы удаляются целиком.
+     *
+     * *it – прокси-пара std::pair<std::string, T&>: ключ в листе не хранится целиком,
+     * поэтому возвращается копией, а значение – ссылкой. Любое изменение карты делает
+     * итераторы недействительными. Опустевший лист удаляется,
+     * но неполные листы не сливаются.
+     */
+    template <typename T, std::size_t LeafCapacity = 64>
+    class string_btree_map
+    {
+        static_assert(LeafCapacity >= 4, "LeafCapacity is too small");
+
+    public:
+        using key_type        = std::string;
+        using mapped_type     = T;
+        using value_type      = std::pair<std::string, T>;
+        using size_type       = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using reference       = std::pair<std::string, T&>;
+        using const_reference = std::pair<std::string, const T&>;
+
+    private:
+        static constexpr std::size_t inner_capacity = 64;   // детей во внутреннем узле
+        static constexpr std::size_t max_depth = 24;
+
+        struct node_base
+        {
+            bool is_leaf;
+        };
+
+        struct leaf_node : node_base
+        {
+            std::string block;              // закодированные ключи подряд
+            std::vector<T> values;
+            leaf_node* prev = nullptr;
+            leaf_node* next = nullptr;
+
+            leaf_node() : node_base{true} {}
+        };
+
+        struct inner_node : node_base
+        {
+            std::vector<std::string> keys;  // keys[i] <= ключей children[i + 1] и > ключей children[i]
+            std::vector<node_base*> children;
+
+            inner_node() : node_base{false} {}
+        };
+
+        // -- ФРОНТАЛЬНОЕ КОДИРОВАНИЕ --
+
+        static void put_varint(std::string& out, std::size_t v)
+        {
+            while (v >= 0x80)
+            {
+                out.push_back(static_cast<char>((v & 0x7F) | 0x80));
+                v >>= 7;
+            }
+            out.push_back(static_cast<char>(v));
+        }
+
+        static std::size_t get_varint(const std::string& in, std::size_t& pos)
+        {
+            std::size_t v = 0;
+            for (unsigned shift = 0; ; shift += 7)
+            {
+                auto b = static_cast<unsigned char>(in[pos++]);
+                v |= static_cast<std::size_t>(b & 0x7F) << shift;
+                if (!(b & 0x80))
+                    return v;
+            }
+        }
+
+        static std::size_t common_prefix(std::string_view a, std::string_view b)
+        {
+            std::size_t n = std::min(a.size(), b.size());
+            std::size_t i = 0;
+            while (i < n && a[i] == b[i])
+                ++i;
+            return i;
+        }
+
+        static void append_entry(std::string& out, std::string_view prev, std::string_view key)
+        {
+            std::size_t shared = common_prefix(prev, key);
+            put_varint(out, shared);
+            put_varint(out, key.size() - shared);
+            out.append(key.data() + shared, key.size() - shared);
+        }
+
+        /**
+         * Последовательное чтение листа: key – текущий ключ, start – смещение его записи,
+         * offset – смещение следующей записи.
+         */
+        struct cursor
+        {
+            const leaf_node* leaf;
+            std::size_t index = 0;
+            std::size_t start = 0;
+            std::size_t offset = 0;
+            std::string key;
+
+            explicit cursor(const leaf_node* l) : leaf(l) {}
+
+            bool at_end() const { return index == leaf->values.size(); }
+
+            // Читает запись index; перед вызовом offset указывает на неё
+            void load()
+            {
+                start = offset;
+                std::size_t shared = get_varint(leaf->block, offset);
+                std::size_t len = get_varint(leaf->block, offset);
+                key.resize(shared);
+                key.append(leaf->block, offset, len);
+                offset += len;
+            }
+        };
+
+    public:
+        template <bool Const>
+        class basic_iterator
+        {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type        = std::pair<std::string, T>;
+            using difference_type   = std::ptrdiff_t;
+            // Ключ возвращается по значению: он раскодирован в буфер самого итератора, и ссылка
+            // на него висела бы после разрушения временного итератора (std::reverse_iterator, *it++)
+            using reference         = std::conditional_t<Const, std::pair<std::string, const T&>, std::pair<std::string, T&>>;
+
+            struct pointer
+            {
+                reference ref;
+                const reference* operator->() const { return &ref; }
+            };
+
+            basic_iterator() = default;
+
+            template <bool C = Const, typename = std::enable_if_t<C>>
+            basic_iterator(const basic_iterator<false>& other)
+                : owner(other.owner), leaf(other.leaf), index(other.index), next_offset(other.next_offset), key(other.key) {}
+
+            reference operator*() const { return reference(key, leaf->values[index]); }
+            pointer operator->() const { return pointer{**this}; }
+
+            basic_iterator& operator++()
+            {
+                if (index + 1 < leaf->values.size())
+                {
+                    cursor c(leaf);
+                    c.index = index + 1;
+                    c.offset = next_offset;
+                    c.key = std::move(key);
+                    c.load();
+                    assign(c);
+                }
+                else
+                    seek_first(leaf->next);
+                return *this;
+            }
+
+            basic_iterator& operator--()
+            {
+                if (!leaf)
+                    seek_last(owner->last_leaf);
+                else if (index > 0)
+                    seek(leaf, index - 1);
+                else
+                    seek_last(leaf->prev);
+                return *this;
+            }
+
+            basic_iterator operator++(int) { basic_iterator tmp(*this); ++(*this); return tmp; }
+            basic_iterator operator--(int) { basic_iterator tmp(*this); --(*this); return tmp; }
+
+            bool operator==(const basic_iterator& other) const { return leaf == other.leaf && index == other.index; }
+            bool operator!=(const basic_iterator& other) const { return !(*this == other); }
+
+        private:
+            friend class string_btree_map;
+            friend class basic_iterator<!Const>;
+
+            const string_btree_map* owner = nullptr;
+            leaf_node* leaf = nullptr;        // nullptr – end()
+            std::size_t index = 0;
+            std::size_t next_offset = 0;
+            std::string key;
+
+            basic_iterator(const string_btree_map* m, leaf_node* l) : owner(m) { seek_first(l); }
+
+            void assign(cursor& c)
+            {
+                index = c.index;
+                next_offset = c.offset;
+                key = std::move(c.key);
+            }
+
+            void seek(leaf_node* l, std::size_t i)
+            {
+                leaf = l;
+                cursor c(l);
+                for (c.load(); c.index < i; ++c.index)
+                    c.load();
+                assign(c);
+            }
+
+            void seek_first(leaf_node* l)
+            {
+                if (l)
+                    seek(l, 0);
+                else
+                {
+                    leaf = nullptr;
+                    index = 0;
+                }
+            }
+
+            void seek_last(leaf_node* l) { seek(l, l->values.size() - 1); }
+        };
+
+        using iterator               = basic_iterator<false>;
+        using const_iterator         = basic_iterator<true>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        string_btree_map() = default;
+
+        string_btree_map(std::initializer_list<value_type> init)
+        {
+            for (const auto& kv : init)
+                insert(kv);
+        }
+
+        string_btree_map(const string_btree_map& other)
+        {
+            for (auto it = other.begin(); it != other.end(); ++it)
+                append_sorted(it->first, it->second);
+        }
+
+        string_btree_map(string_btree_map&& other) noexcept { steal(other); }
+
+        string_btree_map& operator=(const string_btree_map& other)
+        {
+            if (this != &other)
+            {
+                string_btree_map copy(other);
+                clear();
+                steal(copy);
+            }
+            return *this;
+        }
+
+        string_btree_map& operator=(string_btree_map&& other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                steal(other);
+            }
+            return *this;
+        }
+
+        ~string_btree_map() { clear(); }
+
+        // -- ИТЕРАТОРЫ --
+
+        iterator begin() { return iterator(this, first_leaf); }
+        iterator end()   { return iterator(this, nullptr); }
+
+        const_iterator begin() const { return const_iterator(this, first_leaf); }
+        const_iterator end() const   { return const_iterator(this, nullptr); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const   { return end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend()   { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const   { return const_reverse_iterator(begin()); }
+
+        // -- ЕМКОСТЬ --
+
+        bool empty() const { return element_count == 0; }
+
+        size_type size() const { return element_count; }
+
+        size_type max_size() const { return std::numeric_limits<size_type>::max(); }
+
+        /**
+         * Байты структуры: узлы, буферы листов (по capacity), массивы значений с их
+         * heap_usage и разделители. Считается обходом за O(размер карты).
+         */
+        size_type memory_usage() const { return root ? subtree_bytes(root) : 0; }
+
+        size_type leaf_count() const
+        {
+            size_type leaves = 0;
+            for (leaf_node* l = first_leaf; l; l = l->next)
+                ++leaves;
+            return leaves;
+        }
+
+        // -- ОПЕРАЦИИ ДОСТУПА --
+
+        mapped_type& operator[](const key_type& key) { return try_emplace(key).first->second; }
+
+        mapped_type& at(const key_type& key)
+        {
+            auto it = find(key);
+            if (it == end())
+                throw std::out_of_range("Key not found");
+            return it.leaf->values[it.index];
+        }
+
+        const mapped_type& at(const key_type& key) const
+        {
+            auto it = find(key);
+            if (it == end())
+                throw std::out_of_range("Key not found");
+            return it.leaf->values[it.index];
+        }
+
+        // -- МОДИФИКАЦИЯ --
+
+        void insert(const value_type& value) { try_emplace(value.first, value.second); }
+
+        void emplace(const key_type& key, const mapped_type& value) { try_emplace(key, value); }
+
+        template <typename InputIt>
+        void insert_range(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        void insert_or_assign(const key_type& key, const mapped_type& value)
+        {
+            auto result = try_emplace(key, value);
+            if (!result.second)
+                result.first->second = value;
+        }
+
+        template <typename... Args>
+        std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args)
+        {
+            if (!root)
+            {
+                std::unique_ptr<leaf_node> l(new leaf_node());
+                l->values.emplace_back(std::forward<Args>(args)...);
+                append_entry(l->block, std::string_view(), key);
+                root = first_leaf = last_leaf = l.release();
+                element_count = 1;
+                return {iterator(this, first_leaf), true};
+            }
+
+            path_type path;
+            leaf_node* l = descend(key, path);
+            scan_cursor c = scan<scan_cursor>(l, key);
+            if (!c.at_end() && c.key == key)
+            {
+                iterator it;
+                it.owner = this;
+                it.leaf = l;
+                it.assign(c);
+                return {it, false};
+            }
+
+            // Сначала значение: если его конструктор бросит, лист не изменится. Затем новая запись
+            // кодируется относительно предыдущего ключа, а следующая – относительно новой
+            std::size_t i = c.index;
+            bool append = c.at_end();   // at_end() сверяется с числом значений листа
+            auto value_pos = l->values.insert(l->values.begin() + static_cast<difference_type>(i),
+                                              T(std::forward<Args>(args)...));
+            try {
+                std::string encoded;
+                std::string_view prev = i > 0 ? std::string_view(c.prev_key) : std::string_view();
+                append_entry(encoded, prev, key);
+                if (append)
+                    l->block.append(encoded);
+                else
+                {
+                    append_entry(encoded, key, c.key);
+                    l->block.replace(c.start, c.offset - c.start, encoded);
+                }
+            } catch (...) {
+                l->values.erase(value_pos);
+                throw;
+            }
+            ++element_count;
+
+            if (l->values.size() > LeafCapacity)
+            {
+                leaf_node* right = split_leaf(l, path);
+                if (i >= l->values.size())
+                    return {iterator_at(right, i - l->values.size()), true};
+            }
+            return {iterator_at(l, i), true};
+        }
+
+        void erase(const key_type& key)
+        {
+            if (!root)
+                return;
+            path_type path;
+            leaf_node* l = descend(key, path);
+            scan_cursor c = scan<scan_cursor>(l, key);
+            if (c.at_end() || c.key != key)
+                return;
+            erase_entries(l, c, 1, path);
+        }
+
+        iterator erase(const_iterator pos)
+        {
+            std::string next_key;
+            bool has_next = false;
+            const_iterator next = pos;
+            if (++next != end())
+            {
+                next_key = next->first;
+                has_next = true;
+            }
+            erase(pos->first);
+            return has_next ? lower_bound(next_key) : end();
+        }
+
+        iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+        template <typename Predicate>
+        size_type erase_if(Predicate pred)
+        {
+            // Отбор в новое дерево: листы строятся заново последовательным дописыванием
+            string_btree_map kept;
+            size_type removed = 0;
+            for (auto it = begin(); it != end(); ++it)
+            {
+                if (pred(const_reference(it->first, it->second)))
+                    ++removed;
+                else
+                    kept.append_sorted(it->first, std::move(it->second));
+            }
+            *this = std::move(kept);
+            return removed;
+        }
+
+        void clear()
+        {
+            destroy(root);
+            root = nullptr;
+            first_leaf = last_leaf = nullptr;
+            element_count = 0;
+            depth = 0;
+        }
+
+        value_type extract(const key_type& key)
+        {
+            auto it = find(key);
+            if (it == end())
+                throw std::out_of_range("Key not found");
+            value_type val(key, std::move(it->second));
+            erase(key);
+            return val;
+        }
+
+        void swap(string_btree_map& other)
+        {
+            std::swap(root, other.root);
+            std::swap(first_leaf, other.first_leaf);
+            std::swap(last_leaf, other.last_leaf);
+            std::swap(element_count, other.element_count);
+            std::swap(depth, other.depth);
+        }
+
+        // -- ПОИСК --
+
+        iterator find(const key_type& key) { return find_impl<iterator>(this, key); }
+        const_iterator find(const key_type& key) const { return find_impl<const_iterator>(this, key); }
+
+        size_type count(const key_type& key) const { return contains(key) ? 1 : 0; }
+
+        bool contains(const key_type& key) const { return find(key) != end(); }
+
+        iterator lower_bound(std::string_view key) { return lower_impl<iterator>(this, key, false); }
+        const_iterator lower_bound(std::string_view key) const { return lower_impl<const_iterator>(this, key, false); }
+
+        iterator upper_bound(std::string_view key) { return lower_impl<iterator>(this, key, true); }
+        const_iterator upper_bound(std::string_view key) const { return lower_impl<const_iterator>(this, key, true); }
+
+        std::pair<iterator, iterator> equal_range(const key_type& key) { return {lower_bound(key), upper_bound(key)}; }
+
+        std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const
+        {
+            return {lower_bound(key), upper_bound(key)};
+        }
+
+        // -- ПРЕФИКСЫ --
+
+        // Все ключи, начинающиеся с prefix, – [first, last)
+        std::pair<iterator, iterator> prefix_range(std::string_view prefix)
+        {
+            std::string upper;
+            return {lower_bound(prefix), prefix_upper(prefix, upper) ? lower_bound(upper) : end()};
+        }
+
+        std::pair<const_iterator, const_iterator> prefix_range(std::string_view prefix) const
+        {
+            std::string upper;
+            return {lower_bound(prefix), prefix_upper(prefix, upper) ? lower_bound(upper) : end()};
+        }
+
+        /**
+         * Удаляет все ключи с началом prefix и возвращает их число. Граничные листы
+         * перекодируются, листы целиком внутри диапазона удаляются без разбора записей.
+         */
+        size_type erase_prefix(std::string_view prefix)
+        {
+            std::string upper;
+            bool bounded = prefix_upper(prefix, upper);
+            size_type removed = 0;
+            std::string from(prefix);
+            while (root)
+            {
+                path_type path;
+                leaf_node* l = descend(from, path);
+                scan_cursor c = scan<scan_cursor>(l, from);
+                if (c.at_end())
+                {
+                    // Всё в листе меньше from: продолжаем со следующего листа
+                    if (!l->next)
+                        break;
+                    cursor first(l->next);
+                    first.load();
+                    from = first.key;
+                    continue;
+                }
+
+                // Записи [c.index, конец диапазона) в этом листе
+                std::size_t count = l->values.size();
+                std::size_t n = 0;
+                cursor probe = c;
+                while (true)
+                {
+                    if (bounded && probe.key >= upper)
+                        break;
+                    ++n;
+                    if (++probe.index == count)
+                        break;
+                    probe.load();
+                }
+                if (n == 0)
+                    break;
+                bool reached_end = c.index + n == count;
+                removed += n;
+                if (c.index == 0 && reached_end)
+                    remove_leaf(l, path);
+                else
+                    erase_entries(l, c, n, path);
+                if (!reached_end)
+                    break;
+            }
+            return removed;
+        }
+
+        friend bool operator==(const string_btree_map& lhs, const string_btree_map& rhs)
+        {
+            if (lhs.size() != rhs.size())
+                return false;
+            for (auto a = lhs.begin(), b = rhs.begin(); a != lhs.end(); ++a, ++b)
+                if (a->first != b->first || a->second != b->second)
+                    return false;
+            return true;
+        }
+
+        friend bool operator!=(const string_btree_map& lhs, const string_btree_map& rhs) { return !(lhs == rhs); }
+
+    private:
+        using path_type = std::array<std::pair<inner_node*, std::size_t>, max_depth>;
+
+        node_base* root = nullptr;
+        leaf_node* first_leaf = nullptr;
+        leaf_node* last_leaf = nullptr;
+        size_type element_count = 0;
+        std::size_t depth = 0;             // число внутренних уровней
+
+        // cursor, запоминающий и предыдущий ключ (для вставки)
+        struct scan_cursor : cursor
+        {
+            std::string prev_key;
+
+            using cursor::cursor;
+        };
+
+        // Спускается к листу, в котором должен лежать key; path[d] – (узел, индекс ребёнка)
+        leaf_node* descend(std::string_view key, path_type& path) const
+        {
+            node_base* n = root;
+            for (std::size_t d = 0; !n->is_leaf; ++d)
+            {
+                inner_node* in = static_cast<inner_node*>(n);
+                auto it = std::upper_bound(in->keys.begin(), in->keys.end(), key,
+                                           [](std::string_view k, const std::string& sep) { return k < sep; });
+                std::size_t idx = static_cast<std::size_t>(it - in->keys.begin());
+                path[d] = {in, idx};
+                n = in->children[idx];
+            }
+            return static_cast<leaf_node*>(n);
+        }
+
+        // Первая запись листа с ключом >= key (или конец листа); scan_cursor помнит и ключ перед ней
+        template <typename Cursor>
+        static Cursor scan(const leaf_node* l, std::string_view key)
+        {
+            Cursor c(l);
+            for (; !c.at_end(); ++c.index)
+            {
+                if constexpr (std::is_same_v<Cursor, scan_cursor>)
+                    c.prev_key = c.key;
+                c.load();
+                if (std::string_view(c.key) >= key)
+                    break;
+            }
+            if constexpr (std::is_same_v<Cursor, scan_cursor>)
+                if (c.at_end())
+                    c.prev_key = c.key;
+            return c;
+        }
+
+        iterator iterator_at(leaf_node* l, std::size_t i)
+        {
+            iterator it;
+            it.owner = this;
+            it.seek(l, i);
+            return it;
+        }
+
+        template <typename It, typename Self>
+        static It find_impl(Self* self, const key_type& key)
+        {
+            It it = lower_impl<It>(self, key, false);
+            return it != self->end() && it.key == key ? it : self->end();
+        }
+
+        template <typename It, typename Self>
+        static It lower_impl(Self* self, std::string_view key, bool strict)
+        {
+            if (!self->root)
+                return self->end();
+            path_type path;
+            leaf_node* l = self->descend(key, path);
+            cursor c = scan<cursor>(l, key);
+            if (strict && !c.at_end() && std::string_view(c.key) == key && ++c.index < l->values.size())
+                c.load();
+            if (c.at_end())
+            {
+                It it;
+                it.owner = self;
+                it.seek_first(l->next);
+                return it;
+            }
+            It it;
+            it.owner = self;
+            it.leaf = l;
+            it.assign(c);
+            return it;
+        }
+
+        // Наименьшая строка больше всех строк с началом prefix; false – такой нет (prefix из 0xFF)
+        static bool prefix_upper(std::string_view prefix, std::string& upper)
+        {
+            upper.assign(prefix);
+            while (!upper.empty() && static_cast<unsigned char>(upper.back()) == 0xFF)
+                upper.pop_back();
+            if (upper.empty())
+                return false;
+            upper.back() = static_cast<char>(static_cast<unsigned char>(upper.back()) + 1);
+            return true;
+        }
+
+        // Разделитель между листами: кратчайший префикс right, который больше left
+        static std::string separator(std::string_view left, std::string_view right)
+        {
+            return std::string(right.substr(0, common_prefix(left, right) + 1));
+        }
+
+        /**
+         * Делит переполненный лист пополам; правая половина кодируется заново
+         * (её первый ключ – без общего начала). Возвращает правый лист.
+         */
+        leaf_node* split_leaf(leaf_node* l, path_type& path)
+        {
+            std::size_t mid = l->values.size() / 2;
+            cursor c(l);
+            c.load();
+            std::string last_left;
+            for (; c.index < mid; ++c.index)
+            {
+                last_left = c.key;
+                c.load();
+            }
+            std::size_t cut = c.start;
+            std::string sep = separator(last_left, c.key);
+
+            leaf_node* right = new leaf_node();
+            append_entry(right->block, std::string_view(), c.key);
+            std::string prev = c.key;
+            for (++c.index; c.index < l->values.size(); ++c.index)
+            {
+                c.load();
+                append_entry(right->block, prev, c.key);
+                prev = c.key;
+            }
+            right->values.assign(std::make_move_iterator(l->values.begin() + static_cast<difference_type>(mid)),
+                                 std::make_move_iterator(l->values.end()));
+            l->values.erase(l->values.begin() + static_cast<difference_type>(mid), l->values.end());
+            l->block.resize(cut);
+            l->block.shrink_to_fit();
+
+            right->prev = l;
+            right->next = l->next;
+            if (l->next)
+                l->next->prev = right;
+            else
+                last_leaf = right;
+            l->next = right;
+
+            insert_into_parent(path, depth, std::move(sep), right);
+            return right;
+        }
+
+        // Вставляет разделитель и правого соседа узла на уровне level - 1 пути
+        void insert_into_parent(path_type& path, std::size_t level, std::string sep, node_base* right)
+        {
+            if (level == 0)
+            {
+                inner_node* new_root = new inner_node();
+                new_root->keys.push_back(std::move(sep));
+                new_root->children.push_back(root);
+                new_root->children.push_back(right);
+                root = new_root;
+                ++depth;
+                assert(depth < max_depth);
+                return;
+            }
+            auto [parent, idx] = path[level - 1];
+            parent->keys.insert(parent->keys.begin() + static_cast<difference_type>(idx), std::move(sep));
+            parent->children.insert(parent->children.begin() + static_cast<difference_type>(idx) + 1, right);
+            if (parent->children.size() <= inner_capacity)
+                return;
+
+            // Средний разделитель поднимается выше, правая половина уходит в новый узел
+            std::size_t mid = parent->keys.size() / 2;
+            inner_node* sibling = new inner_node();
+            std::string up = std::move(parent->keys[mid]);
+            sibling->keys.assign(std::make_move_iterator(parent->keys.begin() + static_cast<difference_type>(mid) + 1),
+                                 std::make_move_iterator(parent->keys.end()));
+            sibling->children.assign(parent->children.begin() + static_cast<difference_type>(mid) + 1, parent->children.end());
+            parent->keys.resize(mid);
+            parent->children.resize(mid + 1);
+            insert_into_parent(path, level - 1, std::move(up), sibling);
+        }
+
+        /**
+         * Удаляет n записей начиная с курсора c. Первая оставшаяся после них запись
+         * перекодируется относительно ключа перед c; опустевший лист удаляется.
+         */
+        void erase_entries(leaf_node* l, scan_cursor& c, std::size_t n, path_type& path)
+        {
+            std::size_t count = l->values.size();
+            if (n == count)
+            {
+                remove_leaf(l, path);
+                return;
+            }
+            std::size_t from = c.start;
+            std::string_view prev = c.index > 0 ? std::string_view(c.prev_key) : std::string_view();
+            cursor probe = c;
+            for (std::size_t k = 1; k < n; ++k)
+            {
+                ++probe.index;
+                probe.load();
+            }
+            std::string tail;
+            std::size_t to = l->block.size();
+            if (c.index + n < count)
+            {
+                ++probe.index;
+                probe.load();
+                append_entry(tail, prev, probe.key);
+                to = probe.offset;
+            }
+            l->block.replace(from, to - from, tail);
+            l->values.erase(l->values.begin() + static_cast<difference_type>(c.index),
+                            l->values.begin() + static_cast<difference_type>(c.index + n));
+            element_count -= n;
+        }
+
+        // Убирает лист из списка и из родителей; опустевшие внутренние узлы тоже удаляются
+        void remove_leaf(leaf_node* l, path_type& path)
+        {
+            element_count -= l->values.size();
+            if (l->prev)
+                l->prev->next = l->next;
+            else
+                first_leaf = l->next;
+            if (l->next)
+                l->next->prev = l->prev;
+            else
+                last_leaf = l->prev;
+            delete l;
+
+            std::size_t level = depth;
+            while (level > 0)
+            {
+                auto [parent, idx] = path[level - 1];
+                parent->children.erase(parent->children.begin() + static_cast<difference_type>(idx));
+                if (!parent->keys.empty())
+                    parent->keys.erase(parent->keys.begin() + static_cast<difference_type>(idx > 0 ? idx - 1 : 0));
+                if (!parent->children.empty())
+                    break;
+                delete parent;
+                --level;
+            }
+            if (level == 0)
+            {
+                root = nullptr;
+                depth = 0;
+                return;
+            }
+            // Корень с единственным ребёнком заменяется этим ребёнком
+            while (!root->is_leaf && static_cast<inner_node*>(root)->children.size() == 1)
+            {
+                inner_node* old = static_cast<inner_node*>(root);
+                root = old->children[0];
+                delete old;
+                --depth;
+            }
+        }
+
+        // Дописывает ключ больше всех имеющихся (копирование и erase_if)
+        template <typename V>
+        void append_sorted(const std::string& key, V&& value)
+        {
+            if (!root)
+            {
+                try_emplace(key, std::forward<V>(value));
+                return;
+            }
+            path_type path;
+            leaf_node* l = descend(key, path);
+            std::string last;
+            {
+                cursor c(l);
+                while (c.index < l->values.size())
+                {
+                    c.load();
+                    ++c.index;
+                }
+                last = c.key;
+            }
+            append_entry(l->block, last, key);
+            l->values.emplace_back(std::forward<V>(value));
+            ++element_count;
+            if (l->values.size() > LeafCapacity)
+                split_leaf(l, path);
+        }
+
+        void destroy(node_base* n)
+        {
+            if (!n)
+                return;
+            if (n->is_leaf)
+            {
+                delete static_cast<leaf_node*>(n);
+                return;
+            }
+            inner_node* in = static_cast<inner_node*>(n);
+            for (node_base* child : in->children)
+                destroy(child);
+            delete in;
+        }
+
+        size_type subtree_bytes(const node_base* n) const
+        {
+            if (n->is_leaf)
+            {
+                const leaf_node* l = static_cast<const leaf_node*>(n);
+                size_type bytes = sizeof(leaf_node) + l->block.capacity() + l->values.capacity() * sizeof(T);
+                for (const T& v : l->values)
+                    bytes += heap_usage<T>{}(v);
+                return bytes;
+            }
+            const inner_node* in = static_cast<const inner_node*>(n);
+            size_type bytes = sizeof(inner_node) + in->keys.capacity() * sizeof(std::string)
+                            + in->children.capacity() * sizeof(node_base*);
+            for (const auto& k : in->keys)
+                bytes += heap_usage<std::string>{}(k);
+            for (const node_base* child : in->children)
+                bytes += subtree_bytes(child);
+            return bytes;
+        }
+
+        void steal(string_btree_map& other)
+        {
+            root = std::exchange(other.root, nullptr);
+            first_leaf = std::exchange(other.first_leaf, nullptr);
+            last_leaf = std::exchange(other.last_leaf, nullptr);
+            element_count = std::exchange(other.element_count, 0);
+            depth = std::exchange(other.depth, 0);
+        }
+    };
+
+} // namespace mystl
+
+#endif // STRING_BTREE_MAP_HPP